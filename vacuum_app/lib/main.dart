@@ -1,5 +1,6 @@
 // lib/main.dart
 import 'dart:async';
+import 'dart:io';
 
 import 'package:flutter/material.dart';
 import 'package:fl_chart/fl_chart.dart';
@@ -116,7 +117,9 @@ class _VacuumScreenState extends State<VacuumScreen>
   String _runTimeMode = 'MANUAL';
 
   Timer? _vacTimer;
+  StreamSubscription<VacuumEvent>? _eventSub;
   bool _isMeasuring = false;
+  int _runChannel = 0; // 이번 런의 채널 (이벤트 필터)
 
   bool get _hasLotCode => _lotController.text.trim().isNotEmpty;
 
@@ -260,11 +263,16 @@ class _VacuumScreenState extends State<VacuumScreen>
     _backend = VacuumNative();
     _backend.init();
     _refreshPorts();
+
+    // 장비 끊김은 다음 tick 을 기다리지 않고 이벤트로 바로 처리
+    _eventSub = _backend.events().listen(_onBackendEvent);
   }
 
   @override
   void dispose() {
     _vacTimer?.cancel();
+    _eventSub?.cancel();
+    _backend.closeEvents();
     _lotController.dispose();
     _lotFocusNode.dispose();
     _blinkCtrl.dispose();
@@ -330,6 +338,10 @@ class _VacuumScreenState extends State<VacuumScreen>
 
     if (ok) {
       await _loadRecentFromDB();
+      final dbPath = VacuumDB.instance.path;
+      if (dbPath != null && !_backend.openRecorder(dbPath)) {
+        debugPrint('sample recorder open failed: $dbPath');
+      }
       _lotController.clear();
       setState(() {}); // 버튼 활성화 상태 갱신
     }
@@ -421,6 +433,23 @@ class _VacuumScreenState extends State<VacuumScreen>
     _blinkCtrl.repeat(reverse: true);
   }
 
+  // 세션 파형은 DB 옆 waveforms/ 에 세션마다 파일 하나 (.vwf)
+  void _beginWaveform(String pkck) {
+    final dbPath = VacuumDB.instance.path;
+    if (dbPath == null) return;
+    final dir = Directory('${File(dbPath).parent.path}/waveforms');
+    try {
+      dir.createSync(recursive: true);
+    } catch (e) {
+      debugPrint('waveform dir error: $e');
+      return;
+    }
+    final stamp = DateTime.now().millisecondsSinceEpoch;
+    if (!_backend.beginWaveform('${dir.path}/${stamp}_$pkck.vwf')) {
+      debugPrint('waveform begin failed: ${dir.path}');
+    }
+  }
+
   // ───────────────────────── VAC / CHK / STOP ─────────────────────────
 
   void _startMeasure(int channel, String pkck) {
@@ -442,13 +471,23 @@ class _VacuumScreenState extends State<VacuumScreen>
     );
     _backend.start();
 
+    // 시리얼 I/O 는 C++ acquisition 스레드에서 (UI isolate 블로킹 방지)
+    if (!_backend.startAcquisition(channel, periodMs: 1000 ~/ _div)) {
+      debugPrint('startAcquisition failed, falling back to synchronous measure');
+    }
+    // 세션 전체 샘플은 C++ recorder 가 samples 테이블에 기록 (lotid 는 저장 시 연결)
+    _backend.beginRecording(station: pkck);
+    _beginWaveform(pkck);
+
     // 차트/표시 오프셋을 채널별 STARTOFFSET(초)에 맞춰 동기화
     // C++ 로직: counter <= STARTOFFSET*DIV 는 offset 구간,
-    // 그 다음 MAXAVG tick 동안 평균을 내므로 차트는 STARTOFFSET*DIV + MAXAVG 이후부터가 자연스러움
+    // 그 다음 MAXAVG tick 동안 평균을 내므로 차트는 STARTOFFSET*DIV + MAXAVG 이후부터가 자연스러움.
+    // 압력이 일찍 안정되면 C++ 가 더 빨리 측정 구간에 들어가므로 Phase 이벤트에서 다시 맞춘다
     final startOffsetSec = _startOffsetSecForChannel(channel);
     _chartOffsetTicks = (startOffsetSec * _div) + _maxAvgTicks;
     _runMaxXSec = _chartMaxX();
     _runTimeMode = _selectedTime;
+    _runChannel = channel;
     debugPrint(
       'measure start: channel=$channel startOffsetSec=$startOffsetSec '
       'div=$_div maxAvgTicks=$_maxAvgTicks chartOffsetTicks=$_chartOffsetTicks',
@@ -470,6 +509,8 @@ class _VacuumScreenState extends State<VacuumScreen>
       });
     });
 
+    // 판정 엔진의 시간축: 0.5초 tick 마다 measureAndDecide(counter).
+    // 단계 변경/판정은 이 호출 안에서 나오므로 _onBackendEvent 에서 받는다
     _vacTimer?.cancel();
     _vacTimer = Timer.periodic(const Duration(milliseconds: 500), (_) {
       _timeCounter += 1; // 0.5초마다 1씩 증가
@@ -537,14 +578,13 @@ class _VacuumScreenState extends State<VacuumScreen>
         }
       });
 
-      // ✅ 정지 조건
-      final shouldStopByFlag = res.stop;
+      // ✅ 정지 조건 (C++ 판정 stop 은 Verdict 이벤트에서 처리)
       final shouldStopByFail =
           _runTimeMode != 'MANUAL' && !res.pass; // 자동 모드에서 FAIL 시 정지
 
-      if (shouldStopByFlag || shouldStopByFail || shouldStopByTime) {
+      if (shouldStopByFail || shouldStopByTime) {
         debugPrint(
-          'Stop condition: stopFlag=$shouldStopByFlag, failStop=$shouldStopByFail, '
+          'Stop condition: failStop=$shouldStopByFail, '
           'timeStop=$shouldStopByTime, elapsed=${nextElapsedSec.toStringAsFixed(1)}',
         );
         _finishMeasurementAndSave();
@@ -552,6 +592,38 @@ class _VacuumScreenState extends State<VacuumScreen>
     });
   }
 
+  void _onBackendEvent(VacuumEvent e) {
+    if (!mounted) return;
+    switch (e.kind) {
+      case VacuumEventKind.disconnected:
+        debugPrint('device disconnected (channel ${e.channel})');
+        if (_isMeasuring) _finishMeasurementAndSave(aborted: true);
+        setState(() {});
+      case VacuumEventKind.phase:
+        if (!_isMeasuring || e.channel != _runChannel) return;
+        // 측정 구간 시작 tick 에 차트 원점을 맞춤 (안정화가 빨리 끝난 경우 고정 offset 보다 앞)
+        if (e.phase == 2 && _timeCounter < _chartOffsetTicks) {
+          debugPrint(
+            'measuring phase at tick $_timeCounter (expected $_chartOffsetTicks)',
+          );
+          _chartOffsetTicks = _timeCounter;
+        }
+      case VacuumEventKind.verdict:
+        if (!_isMeasuring || e.channel != _runChannel) return;
+        debugPrint(
+          'verdict: ${e.pass ? 'PASS' : 'FAIL'}${e.early ? ' (early)' : ''}, '
+          'elapsed=${_elapsedSec.toStringAsFixed(1)}',
+        );
+        setState(() {
+          _currentPass = e.pass;
+          _currentStopFlag = true;
+        });
+        _finishMeasurementAndSave();
+      default:
+        break;
+    }
+  }
+
   void _finishMeasurementAndSave({bool aborted = false}) async {
     _blinkTimer?.cancel();
     _blinkTimer = null;
@@ -559,6 +631,8 @@ class _VacuumScreenState extends State<VacuumScreen>
     _vacTimer?.cancel();
     _vacTimer = null;
     _blinkCtrl.stop();
+    _backend.stopAcquisition();
+    _backend.endWaveform();
 
     if (aborted) {
       setState(() {
@@ -573,7 +647,10 @@ class _VacuumScreenState extends State<VacuumScreen>
     });
 
     final lotname = _lotController.text.trim();
-    if (lotname.isEmpty) return;
+    if (lotname.isEmpty) {
+      _backend.endRecording(0);
+      return;
+    }
 
     final int durSec = _elapsedSec.floor();
     final bool finalPass = (!aborted && durSec > 0) ? _currentPass : false;
@@ -592,7 +669,8 @@ class _VacuumScreenState extends State<VacuumScreen>
     );
 
     try {
-      await VacuumDB.instance.insertRecord(record);
+      final lotid = await VacuumDB.instance.insertRecord(record);
+      _backend.endRecording(lotid);
       await _loadRecentFromDB();
 
       // ? ???? ??
@@ -607,6 +685,7 @@ class _VacuumScreenState extends State<VacuumScreen>
 
       setState(() {});
     } catch (e) {
+      _backend.endRecording(0);
       debugPrint('Insert record error: $e');
     }
   }
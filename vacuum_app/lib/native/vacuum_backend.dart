@@ -1,6 +1,8 @@
 // lib/native/vacuum_backend.dart
 import 'dart:ffi';
 import 'dart:io';
+import 'dart:isolate';
+import 'dart:typed_data';
 import 'package:ffi/ffi.dart';
 
 
@@ -39,6 +41,573 @@ final class VacuumMeasureResultNative extends Struct {
   external int ok;
 }
 
+/// C struct VacuumSample (acquisition 스레드가 발행하는 샘플)
+final class VacuumSampleNative extends Struct {
+  @Int64()
+  external int timestampNs;
+
+  @Float()
+  external double pressure;
+
+  @Int32()
+  external int channel;
+
+  @Int32()
+  external int raw;
+
+  @Int32()
+  external int ok;
+}
+
+/// C struct VacuumSampleRecord (vacuum_read_samples, 32 bytes)
+final class VacuumSampleRecordNative extends Struct {
+  @Int64()
+  external int timestampNs;
+
+  @Float()
+  external double pressure;
+
+  @Float()
+  external double startPressure;
+
+  @Float()
+  external double stopPressure;
+
+  @Float()
+  external double diffPressure;
+
+  @Uint8()
+  external int raw;
+
+  @Uint8()
+  external int channel;
+
+  @Uint8()
+  external int phase;
+
+  @Uint8()
+  external int flags;
+
+  @Int32()
+  external int reserved;
+}
+
+/// C struct VacuumStateSnapshot (vacuum_get_state, 56 bytes)
+final class VacuumStateSnapshotNative extends Struct {
+  @Uint64()
+  external int version;
+
+  @Int64()
+  external int timestampNs;
+
+  @Float()
+  external double pressure;
+
+  @Float()
+  external double startPressure;
+
+  @Float()
+  external double stopPressure;
+
+  @Float()
+  external double diffPressure;
+
+  @Int32()
+  external int channel;
+
+  @Int32()
+  external int phase;
+
+  @Int32()
+  external int pass;
+
+  @Int32()
+  external int stop;
+
+  @Int32()
+  external int connected;
+
+  @Int32()
+  external int early;
+}
+
+/// backend 상태 snapshot. 다른 isolate 에서 읽어도 서로 일관된 값
+class VacuumState {
+  final int version; // 같으면 바뀐 것 없음
+  final int timestampNs;
+  final double pressure;
+  final double startPressure;
+  final double stopPressure;
+  final double diffPressure;
+  final int channel;
+  final int phase; // 0=안정화, 1=시작 평균, 2=측정, 3=완료
+  final bool pass;
+  final bool stop;
+  final bool connected;
+  final bool early; // 조기 판정으로 stop
+
+  const VacuumState({
+    required this.version,
+    required this.timestampNs,
+    required this.pressure,
+    required this.startPressure,
+    required this.stopPressure,
+    required this.diffPressure,
+    required this.channel,
+    required this.phase,
+    required this.pass,
+    required this.stop,
+    required this.connected,
+    required this.early,
+  });
+
+  factory VacuumState._fromNative(VacuumStateSnapshotNative n) => VacuumState(
+        version: n.version,
+        timestampNs: n.timestampNs,
+        pressure: n.pressure,
+        startPressure: n.startPressure,
+        stopPressure: n.stopPressure,
+        diffPressure: n.diffPressure,
+        channel: n.channel,
+        phase: n.phase,
+        pass: n.pass != 0,
+        stop: n.stop != 0,
+        connected: n.connected != 0,
+        early: n.early != 0,
+      );
+}
+
+typedef _GetStateC = Int32 Function(
+    Pointer<Void>, Int32, Pointer<VacuumStateSnapshotNative>);
+typedef _GetStateD = int Function(
+    Pointer<Void>, int, Pointer<VacuumStateSnapshotNative>);
+
+/// vacuum_get_state (lock 없는 읽기라 leaf 호출)
+class _StateReader {
+  _StateReader(DynamicLibrary lib)
+      : _get = lib.lookupFunction<_GetStateC, _GetStateD>(
+          'vacuum_get_state',
+          isLeaf: true,
+        );
+
+  final _GetStateD _get;
+  Pointer<VacuumStateSnapshotNative>? _buf;
+
+  VacuumState? read(Pointer<Void> handle, int channel) {
+    final buf = _buf ??= calloc<VacuumStateSnapshotNative>();
+    if (_get(handle, channel, buf) != 1) return null;
+    return VacuumState._fromNative(buf.ref);
+  }
+
+  void dispose() {
+    final buf = _buf;
+    if (buf != null) calloc.free(buf);
+    _buf = null;
+  }
+}
+
+/// vacuum_read_samples 로 읽은 샘플 1개
+class VacuumSampleRecord {
+  static const flagOk = 1 << 0;
+  static const flagPass = 1 << 1;
+  static const flagStop = 1 << 2;
+  static const flagEarly = 1 << 3;
+
+  final int timestampNs;
+  final double pressure;
+  final double startPressure;
+  final double stopPressure;
+  final double diffPressure;
+  final int raw;
+  final int channel;
+  final int phase; // 0=안정화, 1=시작 평균, 2=측정, 3=완료
+  final int flags;
+
+  const VacuumSampleRecord({
+    required this.timestampNs,
+    required this.pressure,
+    required this.startPressure,
+    required this.stopPressure,
+    required this.diffPressure,
+    required this.raw,
+    required this.channel,
+    required this.phase,
+    required this.flags,
+  });
+
+  bool get ok => flags & flagOk != 0;
+  bool get pass => flags & flagPass != 0;
+  bool get stop => flags & flagStop != 0;
+  bool get early => flags & flagEarly != 0;
+
+  factory VacuumSampleRecord._fromNative(VacuumSampleRecordNative n) =>
+      VacuumSampleRecord(
+        timestampNs: n.timestampNs,
+        pressure: n.pressure,
+        startPressure: n.startPressure,
+        stopPressure: n.stopPressure,
+        diffPressure: n.diffPressure,
+        raw: n.raw,
+        channel: n.channel,
+        phase: n.phase,
+        flags: n.flags,
+      );
+}
+
+typedef _ReadSamplesC = Int32 Function(
+    Pointer<Void>, Pointer<VacuumSampleRecordNative>, Int32);
+typedef _ReadSamplesD = int Function(
+    Pointer<Void>, Pointer<VacuumSampleRecordNative>, int);
+
+/// C struct VacuumSharedRingInfo
+final class VacuumSharedRingInfoNative extends Struct {
+  external Pointer<VacuumSampleNative> records;
+  external Pointer<Uint64> head;
+  external Pointer<Uint64> tail;
+  external Pointer<Uint64> dropped;
+
+  @Uint32()
+  external int capacity;
+
+  @Uint32()
+  external int recordSize;
+}
+
+typedef _RingCreateC = Int32 Function(
+    Pointer<Void>, Int32, Pointer<VacuumSharedRingInfoNative>);
+typedef _RingCreateD = int Function(
+    Pointer<Void>, int, Pointer<VacuumSharedRingInfoNative>);
+
+typedef _RingLoadC = Uint64 Function(Pointer<Uint64>);
+typedef _RingLoadD = int Function(Pointer<Uint64>);
+
+typedef _RingStoreC = Void Function(Pointer<Uint64>, Uint64);
+typedef _RingStoreD = void Function(Pointer<Uint64>, int);
+
+/// acquisition 스레드가 쓰는 샘플 ring 을 복사 없이 직접 읽는다.
+/// head/tail 접근만 leaf FFI 호출 (배치당 2회), 샘플은 Pointer<Struct> 메모리 읽기.
+class VacuumSharedRing {
+  VacuumSharedRing._(DynamicLibrary lib, this._info)
+      : _load = lib.lookupFunction<_RingLoadC, _RingLoadD>(
+          'vacuum_ring_acquire_load',
+          isLeaf: true,
+        ),
+        _store = lib.lookupFunction<_RingStoreC, _RingStoreD>(
+          'vacuum_ring_release_store',
+          isLeaf: true,
+        );
+
+  static VacuumSharedRing? _create(
+      DynamicLibrary lib, Pointer<Void> handle, int capacity) {
+    final info = calloc<VacuumSharedRingInfoNative>();
+    final ok = lib.lookupFunction<_RingCreateC, _RingCreateD>(
+          'vacuum_shared_ring_create',
+        )(handle, capacity, info) ==
+        1;
+    if (!ok || info.ref.recordSize != sizeOf<VacuumSampleNative>()) {
+      calloc.free(info);
+      return null;
+    }
+    return VacuumSharedRing._(lib, info);
+  }
+
+  final Pointer<VacuumSharedRingInfoNative> _info;
+  final _RingLoadD _load;
+  final _RingStoreD _store;
+
+  int get capacity => _info.ref.capacity;
+  int get dropped => _info.ref.dropped.value;
+
+  /// 아직 읽지 않은 샘플 수
+  int available() => _load(_info.ref.head) - _info.ref.tail.value;
+
+  /// 새 샘플마다 onSample 호출 후 tail 전진. 처리한 개수 반환.
+  /// onSample 에 넘어온 struct 는 콜백 안에서만 유효 (slot 이 재사용됨)
+  int consume(void Function(VacuumSampleNative sample) onSample,
+      {int max = 1 << 30}) {
+    final info = _info.ref;
+    final tail = info.tail.value; // consumer 만 쓰므로 일반 읽기로 충분
+    var n = _load(info.head) - tail;
+    if (n > max) n = max;
+    if (n <= 0) return 0;
+
+    final mask = info.capacity - 1;
+    final records = info.records;
+    for (var i = 0; i < n; i++) {
+      onSample(records[(tail + i) & mask]);
+    }
+    _store(info.tail, tail + n);
+    return n;
+  }
+
+  /// 이후 사용 금지. native ring 자체는 vacuum_shared_ring_destroy 로 해제
+  void dispose() => calloc.free(_info);
+}
+
+/// 샘플 읽기용 버퍼를 재사용한다. 한 번의 FFI 호출로 지난 호출 이후 샘플을 모두 가져온다.
+class _SampleReader {
+  _SampleReader(DynamicLibrary lib)
+      : _read = lib.lookupFunction<_ReadSamplesC, _ReadSamplesD>(
+          'vacuum_read_samples',
+        );
+
+  static const _capacity = 256;
+
+  final _ReadSamplesD _read;
+  Pointer<VacuumSampleRecordNative>? _buf;
+
+  List<VacuumSampleRecord> read(Pointer<Void> handle) {
+    final buf = _buf ??= calloc<VacuumSampleRecordNative>(_capacity);
+    final out = <VacuumSampleRecord>[];
+    while (true) {
+      final n = _read(handle, buf, _capacity);
+      for (var i = 0; i < n; i++) {
+        out.add(VacuumSampleRecord._fromNative(buf[i]));
+      }
+      if (n < _capacity) break;
+    }
+    return out;
+  }
+
+  void dispose() {
+    final buf = _buf;
+    if (buf != null) calloc.free(buf);
+    _buf = null;
+  }
+}
+
+typedef _RecorderOpenC = Int32 Function(Pointer<Utf8>);
+typedef _RecorderOpenD = int Function(Pointer<Utf8>);
+typedef _RecorderBeginC = Int64 Function(Pointer<Void>, Pointer<Utf8>);
+typedef _RecorderBeginD = int Function(Pointer<Void>, Pointer<Utf8>);
+typedef _RecorderEndC = Int32 Function(Pointer<Void>, Int64);
+typedef _RecorderEndD = int Function(Pointer<Void>, int);
+
+typedef _WaveformBeginC = Int32 Function(Pointer<Void>, Pointer<Utf8>);
+typedef _WaveformBeginD = int Function(Pointer<Void>, Pointer<Utf8>);
+typedef _WaveformEndC = Int64 Function(Pointer<Void>);
+typedef _WaveformEndD = int Function(Pointer<Void>);
+typedef _WaveformOpenC = Pointer<Void> Function(Pointer<Utf8>);
+typedef _WaveformOpenD = Pointer<Void> Function(Pointer<Utf8>);
+typedef _WaveformCountC = Int64 Function(Pointer<Void>);
+typedef _WaveformCountD = int Function(Pointer<Void>);
+typedef _WaveformLowerBoundC = Int64 Function(Pointer<Void>, Int64);
+typedef _WaveformLowerBoundD = int Function(Pointer<Void>, int);
+typedef _WaveformDownsampleC = Int32 Function(
+    Pointer<Void>, Int32, Int64, Int64, Int32, Pointer<Int64>, Pointer<Float>);
+typedef _WaveformDownsampleD = int Function(
+    Pointer<Void>, int, int, int, int, Pointer<Int64>, Pointer<Float>);
+typedef _WaveformReadC = Int32 Function(Pointer<Void>, Int64, Pointer<Int64>,
+    Pointer<Float>, Pointer<Uint8>, Pointer<Uint8>, Pointer<Uint8>, Int32);
+typedef _WaveformReadD = int Function(Pointer<Void>, int, Pointer<Int64>,
+    Pointer<Float>, Pointer<Uint8>, Pointer<Uint8>, Pointer<Uint8>, int);
+
+typedef _TraceRangeC = Int64 Function(
+    Pointer<Void>, Int32, Pointer<Int64>, Pointer<Int64>);
+typedef _TraceRangeD = int Function(
+    Pointer<Void>, int, Pointer<Int64>, Pointer<Int64>);
+typedef _TraceDownsampleC = Int32 Function(
+    Pointer<Void>, Int32, Int64, Int64, Int32, Pointer<Int64>, Pointer<Float>);
+typedef _TraceDownsampleD = int Function(
+    Pointer<Void>, int, int, int, int, Pointer<Int64>, Pointer<Float>);
+
+/// LTTB 다운샘플 결과 (원본 샘플의 부분집합). timestampUs 는 steady clock (us)
+class VacuumTraceWindow {
+  VacuumTraceWindow(this.timestampUs, this.pressure);
+
+  static final empty = VacuumTraceWindow(Int64List(0), Float32List(0));
+
+  final Int64List timestampUs;
+  final Float32List pressure;
+
+  int get length => timestampUs.length;
+}
+
+VacuumTraceWindow _downsample(
+    int maxPoints, int Function(Pointer<Int64>, Pointer<Float>) query) {
+  if (maxPoints <= 0) return VacuumTraceWindow.empty;
+  final ts = calloc<Int64>(maxPoints);
+  final pressure = calloc<Float>(maxPoints);
+  try {
+    final n = query(ts, pressure);
+    return VacuumTraceWindow(
+      Int64List.fromList(ts.asTypedList(n)),
+      Float32List.fromList(pressure.asTypedList(n)),
+    );
+  } finally {
+    calloc.free(ts);
+    calloc.free(pressure);
+  }
+}
+
+/// 세션 파형 파일 (.vwf) 구간 읽기 결과. timestampUs 는 steady clock (us)
+class VacuumWaveformSlice {
+  VacuumWaveformSlice(this.timestampUs, this.pressure, this.channel);
+
+  final Int64List timestampUs;
+  final Float32List pressure;
+  final Uint8List channel;
+
+  int get length => timestampUs.length;
+}
+
+/// native 가 mmap 한 파형 파일. 필요한 구간만 디코딩해서 복사한다
+class VacuumWaveformFile {
+  VacuumWaveformFile._(DynamicLibrary lib, this._handle)
+      : _close = lib.lookupFunction<_HandleVoidC, _HandleVoidD>(
+          'vacuum_waveform_close',
+        ),
+        _count = lib.lookupFunction<_WaveformCountC, _WaveformCountD>(
+          'vacuum_waveform_count',
+        ),
+        _lowerBound =
+            lib.lookupFunction<_WaveformLowerBoundC, _WaveformLowerBoundD>(
+          'vacuum_waveform_lower_bound',
+        ),
+        _read = lib.lookupFunction<_WaveformReadC, _WaveformReadD>(
+          'vacuum_waveform_read',
+        ),
+        _downsampleFn =
+            lib.lookupFunction<_WaveformDownsampleC, _WaveformDownsampleD>(
+          'vacuum_waveform_downsample',
+        );
+
+  static VacuumWaveformFile? _open(DynamicLibrary lib, String path) {
+    final p = path.toNativeUtf8();
+    try {
+      final h = lib.lookupFunction<_WaveformOpenC, _WaveformOpenD>(
+        'vacuum_waveform_open',
+      )(p);
+      if (h == nullptr) return null;
+      return VacuumWaveformFile._(lib, h);
+    } finally {
+      calloc.free(p);
+    }
+  }
+
+  Pointer<Void> _handle;
+  final _HandleVoidD _close;
+  final _WaveformCountD _count;
+  final _WaveformLowerBoundD _lowerBound;
+  final _WaveformReadD _read;
+  final _WaveformDownsampleD _downsampleFn;
+
+  int get length => _handle == nullptr ? 0 : _count(_handle);
+
+  /// timestampUs >= fromUs 인 첫 샘플 index
+  int lowerBound(int fromUs) =>
+      _handle == nullptr ? 0 : _lowerBound(_handle, fromUs);
+
+  /// first 번째 샘플부터 최대 count 개
+  VacuumWaveformSlice read(int first, int count) {
+    if (_handle == nullptr || count <= 0) {
+      return VacuumWaveformSlice(Int64List(0), Float32List(0), Uint8List(0));
+    }
+    final ts = calloc<Int64>(count);
+    final pressure = calloc<Float>(count);
+    final channel = calloc<Uint8>(count);
+    try {
+      final n =
+          _read(_handle, first, ts, pressure, nullptr, channel, nullptr, count);
+      return VacuumWaveformSlice(
+        Int64List.fromList(ts.asTypedList(n)),
+        Float32List.fromList(pressure.asTypedList(n)),
+        Uint8List.fromList(channel.asTypedList(n)),
+      );
+    } finally {
+      calloc.free(ts);
+      calloc.free(pressure);
+      calloc.free(channel);
+    }
+  }
+
+  /// 채널의 [fromUs, toUs] 구간을 최대 maxPoints 점으로 (LTTB).
+  /// 첫 호출 때 native 가 채널 피라미드를 만들고, 이후 줌/이동은 창 크기와 무관하게 빠르다
+  VacuumTraceWindow downsample(int channel, int fromUs, int toUs,
+      {int maxPoints = 300}) {
+    if (_handle == nullptr) return VacuumTraceWindow.empty;
+    return _downsample(
+        maxPoints,
+        (ts, p) =>
+            _downsampleFn(_handle, channel, fromUs, toUs, maxPoints, ts, p));
+  }
+
+  void close() {
+    if (_handle == nullptr) return;
+    _close(_handle);
+    _handle = nullptr;
+  }
+}
+
+/// vacuum_event_port.h 의 VacuumEventKind
+enum VacuumEventKind { samples, phase, verdict, disconnected, unknown }
+
+/// backend 가 native port 로 보내는 이벤트 (int64 1 개를 디코딩)
+class VacuumEvent {
+  VacuumEvent._(int msg)
+      : kind = switch ((msg >> 56) & 0x7f) {
+          1 => VacuumEventKind.samples,
+          2 => VacuumEventKind.phase,
+          3 => VacuumEventKind.verdict,
+          4 => VacuumEventKind.disconnected,
+          _ => VacuumEventKind.unknown,
+        },
+        channel = (msg >> 48) & 0xff,
+        payload = msg & 0xffffffffffff;
+
+  final VacuumEventKind kind;
+  final int channel;
+
+  /// samples: 샘플 수, phase: 0~3, verdict: bit0 PASS / bit1 조기 판정
+  final int payload;
+
+  int get sampleCount => payload;
+  int get phase => payload;
+  bool get pass => (payload & 1) != 0;
+  bool get early => (payload & 2) != 0;
+
+  @override
+  String toString() => 'VacuumEvent($kind, ch=$channel, payload=$payload)';
+}
+
+typedef _SetEventPortC = Int32 Function(
+    Pointer<Void>, Pointer<Void>, Int64);
+typedef _SetEventPortD = int Function(Pointer<Void>, Pointer<Void>, int);
+
+/// ReceivePort 를 backend 에 등록하고 이벤트 stream 으로 노출한다.
+class _EventListener {
+  _EventListener(DynamicLibrary lib)
+      : _setPort = lib.lookupFunction<_SetEventPortC, _SetEventPortD>(
+          'vacuum_set_event_port',
+        );
+
+  final _SetEventPortD _setPort;
+  ReceivePort? _port;
+  Stream<VacuumEvent>? _events;
+
+  Stream<VacuumEvent> listen(Pointer<Void> handle) {
+    final existing = _events;
+    if (existing != null) return existing;
+
+    final port = ReceivePort('vacuum_events');
+    _setPort(handle, NativeApi.postCObject.cast(), port.sendPort.nativePort);
+    _port = port;
+    return _events = port
+        .where((m) => m is int)
+        .map((m) => VacuumEvent._(m as int))
+        .asBroadcastStream();
+  }
+
+  void close(Pointer<Void> handle) {
+    final port = _port;
+    if (port == null) return;
+    _setPort(handle, nullptr, 0);
+    port.close();
+    _port = null;
+    _events = null;
+  }
+}
+
 /// Flutter 쪽에서 쓰기 편한 Dart 데이터 클래스
 class VacuumMeasureResult {
   final double pressure;
@@ -98,6 +667,41 @@ typedef _DebugMeasure2D = double Function(int, int);
 typedef _MeasureDecideC = VacuumMeasureResultNative Function(Int32, Int32);
 typedef _MeasureDecideD = VacuumMeasureResultNative Function(int, int);
 
+typedef _AcqStartC = Int32 Function(Int32, Int32);
+typedef _AcqStartD = int Function(int, int);
+
+typedef _AcqLatestC = Int32 Function(Pointer<VacuumSampleNative>);
+typedef _AcqLatestD = int Function(Pointer<VacuumSampleNative>);
+
+typedef _OpenC = Pointer<Void> Function(Pointer<Utf8>);
+typedef _OpenD = Pointer<Void> Function(Pointer<Utf8>);
+
+typedef _HandleVoidC = Void Function(Pointer<Void>);
+typedef _HandleVoidD = void Function(Pointer<Void>);
+
+typedef _HandleIntC = Int32 Function(Pointer<Void>);
+typedef _HandleIntD = int Function(Pointer<Void>);
+
+typedef _HandleSetC = Void Function(Pointer<Void>, Int32);
+typedef _HandleSetD = void Function(Pointer<Void>, int);
+
+typedef _HandleMeasureDecideC = VacuumMeasureResultNative Function(
+    Pointer<Void>, Int32, Int32);
+typedef _HandleMeasureDecideD = VacuumMeasureResultNative Function(
+    Pointer<Void>, int, int);
+
+typedef _HandleAcqStartC = Int32 Function(Pointer<Void>, Int32, Int32);
+typedef _HandleAcqStartD = int Function(Pointer<Void>, int, int);
+
+typedef _SetEarlyDecisionC = Void Function(Int32, Int32);
+typedef _SetEarlyDecisionD = void Function(int, int);
+
+typedef _LoadCalibrationC = Int32 Function(Pointer<Utf8>);
+typedef _LoadCalibrationD = int Function(Pointer<Utf8>);
+
+typedef _SelectCalibrationC = Int32 Function(Int32, Pointer<Utf8>);
+typedef _SelectCalibrationD = int Function(int, Pointer<Utf8>);
+
 class VacuumNative {
   late final DynamicLibrary _lib;
 
@@ -121,6 +725,12 @@ class VacuumNative {
   // struct 반환 함수
   late final _MeasureDecideD _vacuumMeasureDecide;
 
+  // background acquisition
+  late final _AcqStartD _vacuumAcquisitionStart;
+  late final _VoidD _vacuumAcquisitionStop;
+  late final _AcqLatestD _vacuumAcquisitionLatest;
+  late final _SetModeD _vacuumAcquisitionSetPipelineDepth;
+
   VacuumNative() {
     _lib = _openLib();
 
@@ -181,6 +791,24 @@ class VacuumNative {
     _vacuumMeasureDecide = _lib.lookupFunction<
         _MeasureDecideC,
         _MeasureDecideD>('vacuum_measure_decide');
+
+    _vacuumAcquisitionStart = _lib
+        .lookup<NativeFunction<_AcqStartC>>('vacuum_acquisition_start')
+        .asFunction();
+
+    _vacuumAcquisitionStop = _lib
+        .lookup<NativeFunction<_VoidC>>('vacuum_acquisition_stop')
+        .asFunction();
+
+    _vacuumAcquisitionLatest = _lib
+        .lookup<NativeFunction<_AcqLatestC>>('vacuum_acquisition_latest')
+        .asFunction();
+
+    _vacuumAcquisitionSetPipelineDepth = _lib
+        .lookup<NativeFunction<_SetModeC>>(
+          'vacuum_acquisition_set_pipeline_depth',
+        )
+        .asFunction();
   }
 
 
@@ -290,6 +918,204 @@ class VacuumNative {
     return _vacuumDebugMeasureOnce2(channel, timeCounter);
   }
 
+  /// C++ 측 acquisition 스레드 시작. 이후 measureAndDecide 는 I/O 없이 최신 샘플만 사용
+  bool startAcquisition(int channel, {int periodMs = 500}) =>
+      _vacuumAcquisitionStart(channel, periodMs) == 1;
+
+  void stopAcquisition() => _vacuumAcquisitionStop();
+
+  /// depth >= 2 : 응답을 기다리지 않고 VAC 명령을 depth 개까지 미리 전송.
+  /// measureAndDecide 는 호출 간격 동안 모인 샘플의 평균을 사용한다.
+  void setPipelineDepth(int depth) => _vacuumAcquisitionSetPipelineDepth(depth);
+
+  /// VAC1/VAC2 명령을 번갈아 전송. 켜 두면 measureAndDecide(1, ..) 와 measureAndDecide(2, ..) 를
+  /// 같은 타이머에서 불러 PAK/CHUCK 검사를 동시에 진행한다 (채널당 주기 = periodMs * 2).
+  /// 켜져 있는 동안은 응답-채널 오매칭을 막기 위해 pipeline depth 가 1 로 고정된다
+  void setInterleavedChannels(bool enable) =>
+      _lib.lookupFunction<_SetModeC, _SetModeD>(
+        'vacuum_acquisition_set_interleaved',
+      )(enable ? 1 : 0);
+
+  late final _SampleReader _sampleReader = _SampleReader(_lib);
+  late final _StateReader _stateReader = _StateReader(_lib);
+
+  /// 압력/판정/phase/연결 상태 snapshot. channel 0 = 마지막 측정 채널,
+  /// 1/2 = 그 채널의 마지막 측정 (아직 없으면 null)
+  VacuumState? state({int channel = 0}) => _stateReader.read(nullptr, channel);
+
+  /// 지난 호출 이후 acquisition 이 수집한 샘플 전체 (타임스탬프/raw/판정 포함)
+  List<VacuumSampleRecord> readSamples() => _sampleReader.read(nullptr);
+
+  /// 공유 ring 생성 (이미 있으면 기존 ring). 실패 시 null
+  VacuumSharedRing? openSharedRing({int capacity = 4096}) =>
+      VacuumSharedRing._create(_lib, nullptr, capacity);
+
+  late final _EventListener _eventListener = _EventListener(_lib);
+
+  late final _RecorderOpenD _recorderOpen =
+      _lib.lookupFunction<_RecorderOpenC, _RecorderOpenD>('vacuum_recorder_open');
+  late final _VoidD _recorderClose =
+      _lib.lookupFunction<_VoidC, _VoidD>('vacuum_recorder_close');
+  late final _RecorderBeginD _recorderBegin =
+      _lib.lookupFunction<_RecorderBeginC, _RecorderBeginD>('vacuum_recorder_begin');
+  late final _RecorderEndD _recorderEnd =
+      _lib.lookupFunction<_RecorderEndC, _RecorderEndD>('vacuum_recorder_end');
+
+  /// 모든 샘플을 dbPath 의 samples 테이블에 기록하는 writer 시작 (DB 는 WAL 로 전환)
+  bool openRecorder(String dbPath) {
+    final p = dbPath.toNativeUtf8();
+    try {
+      return _recorderOpen(p) == 1;
+    } finally {
+      calloc.free(p);
+    }
+  }
+
+  void closeRecorder() => _recorderClose();
+
+  /// 이후 acquisition 샘플을 새 세션으로 기록. 세션 id 반환 (recorder 가 닫혀 있으면 0)
+  int beginRecording({String station = ''}) {
+    final p = station.toNativeUtf8();
+    try {
+      return _recorderBegin(nullptr, p);
+    } finally {
+      calloc.free(p);
+    }
+  }
+
+  /// 기록 종료. lotid = vacuums 행의 lotid (0 이면 연결하지 않음)
+  bool endRecording(int lotid) => _recorderEnd(nullptr, lotid) == 1;
+
+  late final _WaveformBeginD _waveformBegin =
+      _lib.lookupFunction<_WaveformBeginC, _WaveformBeginD>('vacuum_waveform_begin');
+  late final _WaveformEndD _waveformEnd =
+      _lib.lookupFunction<_WaveformEndC, _WaveformEndD>('vacuum_waveform_end');
+
+  /// 이후 acquisition 샘플을 path 의 파형 파일 (.vwf) 에 기록
+  bool beginWaveform(String path) {
+    final p = path.toNativeUtf8();
+    try {
+      return _waveformBegin(nullptr, p) == 1;
+    } finally {
+      calloc.free(p);
+    }
+  }
+
+  /// 파형 파일을 닫음. 기록한 샘플 수 (쓰기 실패 -1)
+  int endWaveform() => _waveformEnd(nullptr);
+
+  late final _TraceRangeD _traceRange =
+      _lib.lookupFunction<_TraceRangeC, _TraceRangeD>('vacuum_session_trace_range');
+  late final _TraceDownsampleD _traceDownsample =
+      _lib.lookupFunction<_TraceDownsampleC, _TraceDownsampleD>(
+          'vacuum_session_trace_downsample');
+
+  /// 현재 세션 trace 의 (첫 시각, 끝 시각) us. 샘플이 없으면 null
+  (int, int)? sessionTraceRange(int channel) {
+    final first = calloc<Int64>();
+    final last = calloc<Int64>();
+    try {
+      if (_traceRange(nullptr, channel, first, last) == 0) return null;
+      return (first.value, last.value);
+    } finally {
+      calloc.free(first);
+      calloc.free(last);
+    }
+  }
+
+  /// 현재 세션 trace 의 [fromUs, toUs] 를 최대 maxPoints 점으로 (LTTB, 세션 길이와 무관한 비용)
+  VacuumTraceWindow sessionTraceWindow(int channel, int fromUs, int toUs,
+      {int maxPoints = 300}) {
+    return _downsample(
+        maxPoints,
+        (ts, p) => _traceDownsample(
+            nullptr, channel, fromUs, toUs, maxPoints, ts, p));
+  }
+
+  /// 기록된 파형 파일 열기 (기록이 중단된 파일도 가능). 실패 시 null
+  VacuumWaveformFile? openWaveform(String path) =>
+      VacuumWaveformFile._open(_lib, path);
+
+  /// 샘플 발행 / 단계 변경 / 판정 / 장비 끊김 이벤트 (polling 없이 깨어남)
+  Stream<VacuumEvent> events() => _eventListener.listen(nullptr);
+
+  void closeEvents() => _eventListener.close(nullptr);
+
+  /// 가장 최근 샘플의 압력 (샘플이 아직 없으면 null)
+  double? latestSamplePressure() {
+    final p = calloc<VacuumSampleNative>();
+    try {
+      if (_vacuumAcquisitionLatest(p) != 1) return null;
+      return p.ref.pressure;
+    } finally {
+      calloc.free(p);
+    }
+  }
+
+  /// 이동 평균 창 크기 (5/10/20/50/100 샘플). 다음 측정 시작부터 적용
+  bool setAveragingWindow(int channel, int window) =>
+      _lib.lookupFunction<_AcqStartC, _AcqStartD>(
+        'vacuum_set_avg_window',
+      )(channel, window) ==
+      1;
+
+  /// 채널(1/2)에 물린 지그 종류 (1 = PAK, 2 = CHUCK). 다음 측정 시작부터 적용
+  bool setChannelFixture(int channel, int fixtureId) =>
+      _lib.lookupFunction<_AcqStartC, _AcqStartD>(
+        'vacuum_set_channel_fixture',
+      )(channel, fixtureId) ==
+      1;
+
+  /// 조기 판정: minHoldSec 이후 PASS/FAIL 이 통계적으로 확정되면 duration 전에 stop=1
+  void setEarlyDecision(bool enable, {int minHoldSec = 20}) =>
+      _lib.lookupFunction<_SetEarlyDecisionC, _SetEarlyDecisionD>(
+        'vacuum_set_early_decision',
+      )(enable ? 1 : 0, minHoldSec);
+
+  /// 적응형 안정화: 압력이 안정되면 준비시간을 다 기다리지 않고 시작 압력 평균 진입
+  void setAdaptiveSettling(bool enable) =>
+      _lib.lookupFunction<_SetModeC, _SetModeD>(
+        'vacuum_set_adaptive_settling',
+      )(enable ? 1 : 0);
+
+  /// 채널별 보정 프로필 파일 읽기. 측정 중이면 다음 샘플부터 적용
+  bool loadCalibration(String path) {
+    final ptr = path.toNativeUtf8();
+    try {
+      return _lib.lookupFunction<_LoadCalibrationC, _LoadCalibrationD>(
+            'vacuum_load_calibration',
+          )(ptr) ==
+          1;
+    } finally {
+      malloc.free(ptr);
+    }
+  }
+
+  /// profile: 'DEFAULT', 'CHUCK', 'PAK' 또는 파일에서 읽은 이름
+  bool selectCalibration(int channel, String profile) {
+    final ptr = profile.toNativeUtf8();
+    try {
+      return _lib.lookupFunction<_SelectCalibrationC, _SelectCalibrationD>(
+            'vacuum_select_calibration',
+          )(channel, ptr) ==
+          1;
+    } finally {
+      malloc.free(ptr);
+    }
+  }
+
+  /// 포트 하나를 독립된 장비 핸들로 연다 (여러 지그 동시 구동용). 실패 시 null
+  VacuumDevice? open(String portName) {
+    final ptr = portName.toNativeUtf8();
+    try {
+      final h = _lib.lookupFunction<_OpenC, _OpenD>('vacuum_open')(ptr);
+      if (h == nullptr) return null;
+      return VacuumDevice._(_lib, h);
+    } finally {
+      malloc.free(ptr);
+    }
+  }
+
   /// channel, counter 를 넣으면 C++ measureAndDecide 결과 전체를 받아옴
   VacuumMeasureResult measureAndDecide(int channel, int counter) {
     final r = _vacuumMeasureDecide(channel, counter);
@@ -304,3 +1130,111 @@ class VacuumNative {
     );
   }
 }
+
+/// vacuum_open() 핸들 래퍼. 핸들마다 평균/판정 상태와 기준값이 독립적이다.
+class VacuumDevice {
+  VacuumDevice._(this._lib, this._handle)
+      : _close = _lib.lookupFunction<_HandleVoidC, _HandleVoidD>('vacuum_close'),
+        _isConnected = _lib.lookupFunction<_HandleIntC, _HandleIntD>(
+          'vacuum_dev_is_connected',
+        ),
+        _setTimeMode = _lib.lookupFunction<_HandleSetC, _HandleSetD>(
+          'vacuum_dev_set_time_mode',
+        ),
+        _setPressureMode = _lib.lookupFunction<_HandleSetC, _HandleSetD>(
+          'vacuum_dev_set_pressure_mode',
+        ),
+        _setVacStartOffset = _lib.lookupFunction<_HandleSetC, _HandleSetD>(
+          'vacuum_dev_set_vac_start_offset',
+        ),
+        _measureDecide = _lib
+            .lookupFunction<_HandleMeasureDecideC, _HandleMeasureDecideD>(
+          'vacuum_dev_measure_decide',
+        ),
+        _acqStart = _lib.lookupFunction<_HandleAcqStartC, _HandleAcqStartD>(
+          'vacuum_dev_acquisition_start',
+        ),
+        _acqStop = _lib.lookupFunction<_HandleVoidC, _HandleVoidD>(
+          'vacuum_dev_acquisition_stop',
+        ),
+        _sampleReader = _SampleReader(_lib),
+        _stateReader = _StateReader(_lib),
+        _eventListener = _EventListener(_lib);
+
+  final DynamicLibrary _lib;
+  Pointer<Void> _handle;
+
+  final _HandleVoidD _close;
+  final _HandleIntD _isConnected;
+  final _HandleSetD _setTimeMode;
+  final _HandleSetD _setPressureMode;
+  final _HandleSetD _setVacStartOffset;
+  final _HandleMeasureDecideD _measureDecide;
+  final _HandleAcqStartD _acqStart;
+  final _HandleVoidD _acqStop;
+  final _SampleReader _sampleReader;
+  final _StateReader _stateReader;
+  final _EventListener _eventListener;
+
+  Pointer<Void> get handle => _handle;
+
+  bool isConnected() => _handle != nullptr && _isConnected(_handle) == 1;
+
+  void configureModes(int timeMode, int pressureKpa, {int? vacStartOffsetSec}) {
+    _setTimeMode(_handle, timeMode);
+    _setPressureMode(_handle, pressureKpa);
+    if (vacStartOffsetSec != null) {
+      _setVacStartOffset(_handle, vacStartOffsetSec);
+    }
+  }
+
+  bool startAcquisition(int channel, {int periodMs = 500}) =>
+      _acqStart(_handle, channel, periodMs) == 1;
+
+  void stopAcquisition() => _acqStop(_handle);
+
+  /// VAC1/VAC2 교대 전송 (PAK/CHUCK 동시 검사)
+  void setInterleavedChannels(bool enable) =>
+      _lib.lookupFunction<_HandleSetC, _HandleSetD>(
+        'vacuum_dev_acquisition_set_interleaved',
+      )(_handle, enable ? 1 : 0);
+
+  /// 이 장비의 상태 snapshot (channel 0 = 마지막 측정 채널)
+  VacuumState? state({int channel = 0}) =>
+      _handle == nullptr ? null : _stateReader.read(_handle, channel);
+
+  /// 지난 호출 이후 수집된 샘플 전체
+  List<VacuumSampleRecord> readSamples() =>
+      _handle == nullptr ? const [] : _sampleReader.read(_handle);
+
+  /// 이 장비의 공유 ring (이미 있으면 기존 ring). 실패 시 null
+  VacuumSharedRing? openSharedRing({int capacity = 4096}) => _handle == nullptr
+      ? null
+      : VacuumSharedRing._create(_lib, _handle, capacity);
+
+  /// 이 장비의 이벤트 stream (close() 시 해제)
+  Stream<VacuumEvent> events() =>
+      _handle == nullptr ? const Stream.empty() : _eventListener.listen(_handle);
+
+  VacuumMeasureResult measureAndDecide(int channel, int counter) {
+    final r = _measureDecide(_handle, channel, counter);
+    return VacuumMeasureResult(
+      pressure: r.pressure,
+      startPressure: r.startPressure,
+      stopPressure: r.stopPressure,
+      diffPressure: r.diffPressure,
+      pass: r.pass != 0,
+      stop: r.stop != 0,
+      ok: r.ok != 0,
+    );
+  }
+
+  void close() {
+    if (_handle == nullptr) return;
+    _eventListener.close(_handle);
+    _close(_handle);
+    _handle = nullptr;
+    _sampleReader.dispose();
+    _stateReader.dispose();
+  }
+}
@@ -35,15 +35,15 @@ class _VacuumScreenState extends State<VacuumScreen> {
   // 측정 중 여부 (VAC / CHK 진행 중)
   bool _measuring = false;
 
-  // 진공 측정 상태
-  Timer? _timer;
+  // 진공 측정 상태 (acquisition 샘플 이벤트마다 갱신)
+  StreamSubscription<VacuumEvent>? _eventSub;
   double _pressure = 0.0;
   bool _pass = true;
-  int _stepIndex = 0;
 
   // 실시간 압력 / 결과
   // 차트용 데이터 (x: step index, y: 압력 변화)
   final List<FlSpot> _chartSpots = [];
+  static const int _chartPoints = 300;
 
   @override
   void initState() {
@@ -56,11 +56,15 @@ class _VacuumScreenState extends State<VacuumScreen> {
 
     _refreshPorts();
     _connected = backend.isConnected();
+
+    _eventSub = backend.events().listen(_onBackendEvent);
   }
 
   @override
   void dispose() {
-    _timer?.cancel();
+    _eventSub?.cancel();
+    backend.stopAcquisition();
+    backend.closeEvents();
     super.dispose();
   }
 
@@ -154,7 +158,7 @@ class _VacuumScreenState extends State<VacuumScreen> {
 
   // ======================== VAC / CHK / STOP ========================
 
-  /// VAC 버튼 눌렀을 때 : C++측에서 진공 시작 + 주기적으로 step 호출
+  /// VAC 버튼 눌렀을 때 : C++ acquisition 스레드 시작, 이후 샘플 이벤트로 화면 갱신
   void _onStartVac() {
     if (!_connected) {
       ScaffoldMessenger.of(context).showSnackBar(
@@ -167,33 +171,65 @@ class _VacuumScreenState extends State<VacuumScreen> {
     // 시간 / 압력 설정을 C++에 전달
     backend.configureModes(_mapTimeModeToCode(_selectedTime), _selectedKpa);
 
-    // 시퀀스 시작
+    // 시퀀스 시작 (세션 trace 초기화)
     backend.start();
 
-    _timer?.cancel();
-    _stepIndex = 0;
     _chartSpots.clear();
+    if (!backend.startAcquisition(1, periodMs: 200)) {
+      ScaffoldMessenger.of(context).showSnackBar(
+        const SnackBar(content: Text('측정을 시작하지 못했습니다.')),
+      );
+      return;
+    }
     setState(() {
       _measuring = true;
     });
+  }
 
-    _timer = Timer.periodic(const Duration(milliseconds: 200), (_) {
-      backend.step();
-      final p = backend.getLastPressure();
-      final pass = backend.getLastPass();
-
-      setState(() {
-        _pressure = p;
-        _pass = pass;
+  void _onBackendEvent(VacuumEvent e) {
+    if (!_measuring || !mounted) return;
+    switch (e.kind) {
+      case VacuumEventKind.samples:
+        if (e.channel != 1) return;
+        final p = backend.latestSamplePressure();
+        if (p == null) return;
+        setState(() {
+          _pressure = p;
+          // C++ step() 과 같은 기준: 설정 압력 - 3 kPa 이상이면 PASS
+          _pass = p >= _selectedKpa - 3;
+
+          // 간단한 차트: 압력 변화(현재압 - 설정압력)를 y값으로 사용.
+          // 세션 전체 trace 를 C++ 가 LTTB 로 줄여서 돌려주므로 세션이 길어도 점 수는 일정
+          _refreshChart();
+        });
+      case VacuumEventKind.disconnected:
+        backend.stopAcquisition();
+        setState(() {
+          _measuring = false;
+          _connected = false;
+        });
+        ScaffoldMessenger.of(context).showSnackBar(
+          const SnackBar(content: Text('장비 연결이 끊겨 측정을 중지했습니다.')),
+        );
+      default:
+        break;
+    }
+  }
 
-        // 간단한 차트: 압력 변화(현재압 - 설정압력)를 y값으로 사용
-        final diff = _pressure - _selectedKpa;
-        if (_chartSpots.length < 300) {
-          _chartSpots.add(FlSpot(_stepIndex.toDouble(), diff));
-        }
-        _stepIndex++;
-      });
-    });
+  /// 세션 시작부터 현재까지를 _chartPoints 점으로 (x: 경과 초)
+  void _refreshChart() {
+    final range = backend.sessionTraceRange(1);
+    _chartSpots.clear();
+    if (range == null) return;
+    final (firstUs, lastUs) = range;
+    final window = backend.sessionTraceWindow(1, firstUs, lastUs,
+        maxPoints: _chartPoints);
+    for (var i = 0; i < window.length; i++) {
+      _chartSpots.add(FlSpot(
+        (window.timestampUs[i] - firstUs) / 1e6,
+        window.pressure[i] - _selectedKpa,
+      ));
+    }
   }
 
   /// CHK 버튼: 우선 VAC과 같은 동작 (나중에 필요시 따로 분리 가능)
@@ -203,8 +239,7 @@ class _VacuumScreenState extends State<VacuumScreen> {
   void _onStop() {
     if (!_measuring) return;
 
-    _timer?.cancel();
-    _timer = null;
+    backend.stopAcquisition();
 
     setState(() {
       _measuring = false;
@@ -721,7 +756,7 @@ class _VacuumScreenState extends State<VacuumScreen> {
 
 /// ─────────────────────────────────────────
 ///  차트 위젯
-///   - x: 0 ~ 300
+///   - x: 0 ~ 300 초 (세션이 더 길면 마지막 점까지 확장)
 ///   - y: 대략 -5 ~ +5 (압력 차이 기준)
 /// ─────────────────────────────────────────
 class VacuumPressureChart extends StatelessWidget {
@@ -748,7 +783,7 @@ class VacuumPressureChart extends StatelessWidget {
     return LineChart(
       LineChartData(
         minX: 0,
-        maxX: 300,
+        maxX: data.last.x > 300 ? data.last.x : 300,
         minY: -5,
         maxY: 5,
         gridData: FlGridData(show: true),
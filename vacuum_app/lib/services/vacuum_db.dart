@@ -10,6 +10,9 @@ class VacuumDB {
 
   VacuumDB._internal();
 
+  /// 열린 DB 파일 경로 (C++ 샘플 recorder 가 같은 파일에 기록)
+  String? get path => _db?.path;
+
   Future<void> open() async {
     if (_db != null) return;
 
@@ -0,0 +1,175 @@
+// tests/leak_session_equivalence_test.cpp
+//
+// LeakTestSession (vacuum_leak_session.h) 이 옛 counter 기반 measureAndDecide 와
+// 같은 판정을 내는지 무작위 시나리오로 비교한다. earlyDecision / adaptiveSettling 은 끈 상태.
+// 이후 판정 로직을 고칠 때 기존 verdict 가 바뀌면 여기서 실패한다.
+
+#include "vacuum_leak_session.h"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+namespace {
+
+constexpr int kDiv = 2;   // vacuum_backend.h DIV
+
+struct Step {
+    float pSt  = 0.0f;
+    float pSp  = 0.0f;
+    float diff = 0.0f;
+    bool  pass = true;
+    bool  stop = false;
+};
+
+// LeakTestSession 도입 전 counter 기반 VacuumBackend::measureAndDecide 의 판정 부분 (I/O, 로그 제거)
+class ReferenceDecision
+{
+public:
+    ReferenceDecision(int startOffset, int window, int durationSec, float hrate, float minPress, float minDiff)
+        : startOffset_(startOffset), window_(window), duration_(durationSec), hrate_(hrate),
+          minPress_(minPress), minDiff_(minDiff), manual_(durationSec == 0)
+    {
+    }
+
+    // pSt/pSp 는 호출자 변수 (안정화 구간에서는 건드리지 않음)
+    void step(int counter, float press, Step& s)
+    {
+        const int avgWindow = (counter == 1) ? window_ : startAvg_.window();
+
+        if (counter <= startOffset_ * kDiv) {
+            s.pass = true;
+            s.stop = false;
+            s.diff = 0.0f;
+            offsetpress_ = 0.0f;
+            startpress_  = 0.0f;
+            startAvg_.clear();
+            stopAvg_.clear();
+            if (counter == 1) {
+                startAvg_.setWindow(window_);
+                stopAvg_.setWindow(window_);
+            }
+        } else if (counter <= startOffset_ * kDiv + avgWindow) {
+            s.pass = true;
+            s.stop = false;
+            s.diff = 0.0f;
+            startpress_ = s.pSt = startAvg_.push(press);
+            s.pSp = stopAvg_.push(press);
+            offsetpress_ = startpress_ > 65.5f ? startpress_ - 65.5f : 0.0f;
+            startpress_ = startpress_ - offsetpress_;
+        } else if (manual_ || counter <= (duration_ + startOffset_) * kDiv + avgWindow) {
+            s.pSp = stopAvg_.push(press);
+            s.pSp = s.pSp - offsetpress_;
+            s.pSt = startpress_;
+            const float val  = s.pSp - s.pSt;
+            const float hval = val < 0 ? -(val * hrate_) : (val * hrate_);
+            s.pSp  = s.pSp + hval;
+            s.diff = s.pSp - s.pSt;
+            if (s.pSp >= minPress_ && s.diff <= minDiff_ && s.diff >= -minDiff_) {
+                s.pass = true;
+                s.stop = false;
+            } else {
+                s.pass = false;
+                s.stop = !manual_;
+            }
+        } else {
+            s.pSp  = stopAvg_.push(press);
+            s.pSp  = s.pSp - offsetpress_;
+            s.diff = s.pSp - startpress_;
+            s.pSt  = startpress_;
+            s.pass = s.pSp >= minPress_ && s.diff <= minDiff_ && s.diff >= -minDiff_;
+            s.stop = true;
+        }
+    }
+
+private:
+    int   startOffset_;
+    int   window_;
+    int   duration_;
+    float hrate_;
+    float minPress_;
+    float minDiff_;
+    bool  manual_;
+
+    AveragingFilter startAvg_;
+    AveragingFilter stopAvg_;
+    float startpress_  = 0.0f;
+    float offsetpress_ = 0.0f;
+};
+
+bool close(float a, float b)
+{
+    return std::fabs(a - b) <= 1e-4f * (1.0f + std::fabs(a));
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(20261016);
+    const int   windows[]   = {5, 10, 20, 50, 100};
+    const int   durations[] = {0, 30, 120, 180, 300};
+    const float hrates[]    = {0.5f, 0.6f, 1.0f};
+
+    long steps = 0;
+    int  failures = 0;
+
+    for (int scenario = 0; scenario < 1500 && failures < 10; ++scenario) {
+        const int   startOffset = std::uniform_int_distribution<int>(1, 30)(rng);
+        const int   window      = windows[rng() % 5];
+        const int   duration    = durations[rng() % 5];
+        const float hrate       = hrates[rng() % 3];
+        const float minPress    = std::uniform_real_distribution<float>(60.0f, 66.0f)(rng);
+        const float minDiff     = std::uniform_real_distribution<float>(0.3f, 2.0f)(rng);
+
+        LeakTestConfig cfg;
+        cfg.startOffsetSec  = startOffset;
+        cfg.averagingWindow = window;
+        cfg.durationSec     = duration;
+        cfg.hrate           = hrate;
+        cfg.minPress        = minPress;
+        cfg.minDiff         = minDiff;
+
+        LeakTestSession   session(cfg);
+        ReferenceDecision reference(startOffset, window, duration, hrate, minPress, minDiff);
+
+        // 안정 압력 + 누설 기울기 + 노이즈
+        const float base  = std::uniform_real_distribution<float>(60.0f, 70.0f)(rng);
+        const float slope = std::uniform_real_distribution<float>(-0.02f, 0.01f)(rng);
+        std::normal_distribution<float> noise(0.0f, std::uniform_real_distribution<float>(0.0f, 0.3f)(rng));
+
+        Step ref, got;
+        const int maxCounter = (startOffset + (duration > 0 ? duration : 200)) * kDiv + window + 20;
+        for (int counter = 1; counter <= maxCounter; ++counter, ++steps) {
+            const float press = base + slope * static_cast<float>(counter) + noise(rng);
+
+            reference.step(counter, press, ref);
+
+            const LeakTestResult r = session.feed(static_cast<double>(counter) / kDiv, press);
+            got.pass = r.pass;
+            got.stop = r.stop;
+            got.diff = r.diffPressure;
+            if (r.phase != LeakPhase::Stabilizing) {
+                got.pSt = r.startPressure;
+                got.pSp = r.stopPressure;
+            }
+
+            if (got.pass != ref.pass || got.stop != ref.stop || !close(got.diff, ref.diff) ||
+                !close(got.pSt, ref.pSt) || !close(got.pSp, ref.pSp)) {
+                std::fprintf(stderr,
+                             "scenario %d counter %d (offset %d win %d dur %d hrate %.1f): "
+                             "ref pass %d stop %d st %.4f sp %.4f diff %.4f / "
+                             "session pass %d stop %d st %.4f sp %.4f diff %.4f\n",
+                             scenario, counter, startOffset, window, duration, hrate, ref.pass, ref.stop, ref.pSt,
+                             ref.pSp, ref.diff, got.pass, got.stop, got.pSt, got.pSp, got.diff);
+                ++failures;
+                break;
+            }
+            if (ref.stop)
+                break;   // Dart 는 stop 이후 호출하지 않음
+        }
+    }
+
+    std::printf("%ld steps, %d mismatches\n", steps, failures);
+    return failures == 0 ? 0 : 1;
+}
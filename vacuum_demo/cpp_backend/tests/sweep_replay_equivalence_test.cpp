@@ -0,0 +1,104 @@
+// tests/sweep_replay_equivalence_test.cpp
+//
+// runSweep (vacuum_sweep.h) 의 격자 점별 false-pass / false-fail / 미완료 수가
+// 같은 파라미터로 rescoreCorpus (LeakTestSession 재생) 한 결과와 같은지 합성 corpus 로 비교한다.
+// sweep 은 hrate / 준비시간을 채널 구분 없이 쓰므로 재생 파라미터도 PAK/CHUCK 에 같은 값을 넣는다.
+
+#include "vacuum_replay.h"
+#include "vacuum_sweep.h"
+#include "vacuum_work_pool.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+// 안정 압력 + 누설 기울기 + 노이즈, 10 Hz 샘플. 기록 판정(storedPass)을 라벨로 사용
+void addSyntheticTraces(ReplayCorpus& corpus, std::mt19937& rng, int traces)
+{
+    const float recorded[] = {10.0f, 45.0f, 70.0f, 135.0f};   // manual, 30, 30, 120 초 모드
+
+    std::vector<std::int64_t> tNs;
+    std::vector<float>        pressure;
+    std::vector<std::int32_t> ok;
+
+    for (int i = 0; i < traces; ++i) {
+        const int   channel     = 1 + static_cast<int>(rng() % 2);
+        const bool  good        = rng() % 2 == 0;
+        const float recordedSec = recorded[rng() % 4];
+        const float base        = std::uniform_real_distribution<float>(58.0f, 72.0f)(rng);
+        const float slope       = good ? std::uniform_real_distribution<float>(-0.002f, 0.002f)(rng)
+                                       : std::uniform_real_distribution<float>(-0.08f, -0.005f)(rng);
+        std::normal_distribution<float> noise(0.0f, std::uniform_real_distribution<float>(0.0f, 0.4f)(rng));
+
+        // 짧게 끊긴 trace 도 섞이도록 기록 시간 +- 20 초
+        const int samples = static_cast<int>((recordedSec + std::uniform_real_distribution<float>(-20.0f, 20.0f)(rng)) * 10.0f);
+        tNs.clear();
+        pressure.clear();
+        ok.clear();
+        for (int k = 0; k < samples; ++k) {
+            const float sec = static_cast<float>(k) * 0.1f;
+            tNs.push_back(static_cast<std::int64_t>(k) * 100000000);
+            pressure.push_back(base + slope * sec + noise(rng));
+            ok.push_back(rng() % 50 != 0 ? 1 : 0);   // 가끔 timeout
+        }
+        corpus.addTrace(1000 + i, channel, good ? 1 : 0, recordedSec, tNs.data(), pressure.data(), ok.data(),
+                        tNs.size());
+    }
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(20261016);
+
+    ReplayCorpus corpus;
+    addSyntheticTraces(corpus, rng, 400);
+
+    SweepGrid grid;
+    grid.startOffsetSec  = {5.0f, 7.0f, 25.0f};
+    grid.averagingWindow = {5, 10};
+    grid.durationSec     = {-1.0f, 0.0f};
+    grid.hrate           = {0.5f, 0.6f, 1.0f};
+    grid.minDiff         = {0.5f, 1.0f, 1.5f};
+    grid.minPress        = {55.0f, 62.0f};
+    grid.offsetClamp     = {60.0f, 65.5f};
+
+    const WorkStealingPool pool(4);
+    const std::vector<SweepResult> results = runSweep(corpus, grid, pool, 0, true);
+
+    int failures = 0;
+    for (const SweepResult& r : results) {
+        const SweepPoint& p = r.point;
+
+        VacuumReplayParams params = defaultReplayParams();
+        params.minPress          = p.minPress;
+        params.minDiff           = p.minDiff;
+        params.hratePak          = p.hrate;
+        params.hrateChuck        = p.hrate;
+        params.offsetClamp       = p.offsetClamp;
+        params.vacStartOffsetSec = p.startOffsetSec;
+        params.chkStartOffsetSec = p.startOffsetSec;
+        params.averagingWindow   = p.averagingWindow;
+        params.durationSec       = p.durationSec;
+
+        // 기록 판정 = 라벨 -> PASS->FAIL 이 false-fail, FAIL->PASS 가 false-pass
+        const VacuumReplaySummary s = rescoreCorpus(corpus, params, params, pool);
+        if (s.failToPass != r.falsePass || s.passToFail != r.falseFail || s.incomplete != r.incomplete) {
+            std::fprintf(stderr,
+                         "offset %.1f win %d dur %.0f hrate %.2f minDiff %.2f minPress %.1f clamp %.1f: "
+                         "sweep FP %u FF %u incomplete %u / replay FP %llu FF %llu incomplete %llu\n",
+                         p.startOffsetSec, p.averagingWindow, p.durationSec, p.hrate, p.minDiff, p.minPress,
+                         p.offsetClamp, r.falsePass, r.falseFail, r.incomplete,
+                         static_cast<unsigned long long>(s.failToPass), static_cast<unsigned long long>(s.passToFail),
+                         static_cast<unsigned long long>(s.incomplete));
+            if (++failures >= 10)
+                break;
+        }
+    }
+
+    std::printf("%zu points x %zu traces, %d mismatches\n", results.size(), corpus.size(), failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,422 @@
+// vacuum_acquisition.cpp
+
+#include "vacuum_acquisition.h"
+#include "vacuum_device.h"
+#include "vacuum_lttb.h"
+#include "vacuum_sample_recorder.h"
+#include "vacuum_waveform_file.h"
+
+#include <chrono>
+#include <vector>
+
+#include <QtCore/QDebug>
+#include <QtCore/QString>
+
+#if defined(VACUUM_ENABLE_REACTOR)
+#include "vacuum_reactor.h"
+
+// reactor 스레드 콜백 -> acquisition 발행 경로 연결
+class VacuumAcquisition::ReactorLink : public VacuumReactor::Client
+{
+public:
+    explicit ReactorLink(VacuumAcquisition& owner) : owner_(owner) {}
+
+    // 제어 스레드(start/stop)와 reactor 스레드(onReactorError)가 함께 씀
+    std::atomic<int> portId{-1};
+
+    int reactorChannel() const override { return owner_.nextChannel(); }
+    int reactorPeriodMs() const override { return owner_.periodMs(); }
+    int reactorPipelineDepth() const override { return owner_.issueDepth(); }
+
+    void onReactorSample(int channel, std::uint8_t raw,
+                         std::int64_t sentNs, std::int64_t receivedNs) override
+    {
+        if (owner_.rttHistogram_)
+            owner_.rttHistogram_->record(static_cast<std::uint64_t>((receivedNs - sentNs) / 1000));
+        if (owner_.metrics_)
+            DeviceMetrics::add(owner_.metrics_->responses);
+
+        VacuumSample s{};
+        s.timestampNs = receivedNs;
+        s.pressure    = owner_.calibration_ ? owner_.calibration_->convert(channel, raw)
+                                            : kDefaultCalibration[raw];
+        s.channel     = channel;
+        s.raw         = raw;
+        s.ok          = 1;
+        owner_.publish(s);
+        owner_.notifySamples(channel, 1);
+    }
+
+    void onReactorCommand() override
+    {
+        if (owner_.metrics_)
+            DeviceMetrics::add(owner_.metrics_->commands);
+    }
+
+    void onReactorStale(int bytes) override
+    {
+        if (owner_.metrics_)
+            DeviceMetrics::add(owner_.metrics_->staleBytes, static_cast<std::uint64_t>(bytes));
+    }
+
+    void onReactorTimeout(const int* channels, int lost) override
+    {
+        if (owner_.metrics_) {
+            DeviceMetrics::add(owner_.metrics_->timeouts, static_cast<std::uint64_t>(lost));
+            DeviceMetrics::add(owner_.metrics_->resyncs);   // reactor 는 timeout 마다 in-flight 폐기 + flush
+        }
+        // interleave 중에는 VAC1/VAC2 가 섞여 있으므로 요청한 채널별로 실패 샘플 발행
+        int perChannel[AcquisitionTotals::kChannels] = {};
+        const std::int64_t now = VacuumAcquisition::nowNs();
+        for (int i = 0; i < lost; ++i) {
+            VacuumSample s{};
+            s.timestampNs = now;
+            s.channel     = channels[i];
+            owner_.publish(s);   // ok=0
+            if (AcquisitionTotals::validChannel(channels[i]))
+                ++perChannel[channels[i]];
+        }
+        for (int ch = 1; ch < AcquisitionTotals::kChannels; ++ch)
+            owner_.notifySamples(ch, perChannel[ch]);
+    }
+
+    void onReactorError() override
+    {
+        portId.store(-1, std::memory_order_release);
+        owner_.markDisconnected();
+    }
+
+private:
+    VacuumAcquisition& owner_;
+};
+#else
+class VacuumAcquisition::ReactorLink {};
+#endif
+
+VacuumAcquisition::VacuumAcquisition()
+{
+}
+
+bool VacuumAcquisition::reactorAvailable()
+{
+#if defined(VACUUM_ENABLE_REACTOR)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool VacuumAcquisition::setTransport(Transport transport)
+{
+    if (transport == Transport::Reactor && !reactorAvailable()) {
+        qWarning() << "[Acquisition] reactor transport not available in this build";
+        return false;
+    }
+    transport_ = transport;
+    return true;
+}
+
+bool VacuumAcquisition::startReactor(const std::string& portName)
+{
+#if defined(VACUUM_ENABLE_REACTOR)
+    if (!reactorLink_)
+        reactorLink_.reset(new ReactorLink(*this));
+
+    const int portId = VacuumReactor::shared().addPort(portName, 19200, reactorLink_.get());
+    if (portId < 0)
+        return false;
+    reactorLink_->portId.store(portId, std::memory_order_release);
+
+    connected_.store(true, std::memory_order_release);
+    return true;
+#else
+    (void)portName;
+    return false;
+#endif
+}
+
+VacuumAcquisition::~VacuumAcquisition()
+{
+    stop();
+}
+
+int64_t VacuumAcquisition::nowNs()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void VacuumAcquisition::setPipelineDepth(int depth)
+{
+    if (depth < 1)
+        depth = 1;
+    pipelineDepth_.store(depth, std::memory_order_relaxed);
+}
+
+void VacuumAcquisition::setPeriodMs(int periodMs)
+{
+    if (periodMs <= 0) {
+        qWarning() << "[Acquisition] setPeriodMs: invalid" << periodMs;
+        return;
+    }
+    periodMs_.store(periodMs, std::memory_order_relaxed);
+}
+
+bool VacuumAcquisition::start(const std::string& portName, int channel, int periodMs)
+{
+    if (!AcquisitionTotals::validChannel(channel)) {
+        qWarning() << "[Acquisition] start: invalid channel" << channel;
+        return false;
+    }
+
+    stop();
+
+    setChannel(channel);
+    setPeriodMs(periodMs);
+
+    ring_.clear();
+    latest_.store(VacuumSample{});   // 이전 세션 샘플 무효화 (ok=0)
+    for (auto& latest : latestByChannel_)
+        latest.store(VacuumSample{});
+    runningTotals_ = AcquisitionTotals{};
+    totals_.store(runningTotals_);
+    stopRequested_.store(false, std::memory_order_release);
+    running_.store(true, std::memory_order_release);
+
+    if (transport_ == Transport::Reactor) {
+        if (!startReactor(portName)) {
+            running_.store(false, std::memory_order_release);
+            return false;
+        }
+        qDebug() << "[Acquisition] started on" << QString::fromUtf8(portName.c_str())
+                 << "(reactor) channel" << channel << "period" << periodMs_.load() << "ms";
+        return true;
+    }
+
+    std::promise<bool> opened;
+    std::future<bool>  openedResult = opened.get_future();
+
+    thread_ = std::thread(&VacuumAcquisition::run, this, portName, 19200, &opened);
+
+    if (!openedResult.get()) {
+        thread_.join();
+        running_.store(false, std::memory_order_release);
+        return false;
+    }
+
+    qDebug() << "[Acquisition] started on" << QString::fromUtf8(portName.c_str())
+             << "channel" << channel << "period" << periodMs_.load() << "ms"
+             << "pipeline depth" << pipelineDepth();
+    return true;
+}
+
+void VacuumAcquisition::stop()
+{
+#if defined(VACUUM_ENABLE_REACTOR)
+    if (reactorLink_ && running_.load(std::memory_order_acquire)) {
+        const int portId = reactorLink_->portId.exchange(-1, std::memory_order_acq_rel);
+        if (portId >= 0)
+            VacuumReactor::shared().removePort(portId);
+        connected_.store(false, std::memory_order_release);
+        running_.store(false, std::memory_order_release);
+        qDebug() << "[Acquisition] stopped (reactor), dropped samples:" << ring_.dropped();
+    }
+#endif
+
+    if (!thread_.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        stopRequested_.store(true, std::memory_order_release);
+    }
+    wakeCv_.notify_all();
+
+    thread_.join();
+    running_.store(false, std::memory_order_release);
+
+    qDebug() << "[Acquisition] stopped, dropped samples:" << ring_.dropped();
+}
+
+int VacuumAcquisition::drain(VacuumSample* out, int maxCount)
+{
+    if (!out || maxCount <= 0)
+        return 0;
+    return static_cast<int>(ring_.drain(out, static_cast<std::size_t>(maxCount)));
+}
+
+// ───────────────────────────────────────
+//  acquisition thread
+// ───────────────────────────────────────
+void VacuumAcquisition::run(std::string portName, int baud, std::promise<bool>* opened)
+{
+    // 포트는 이 스레드에서 생성/사용/해제한다
+    VacuumDevice device;
+    device.setLatencyHistogram(rttHistogram_);
+    device.setCalibration(calibration_);
+    device.setMetrics(metrics_);
+
+    if (!device.connectPort(QString::fromUtf8(portName.c_str()), baud)) {
+        connected_.store(false, std::memory_order_release);
+        opened->set_value(false);
+        return;
+    }
+
+    connected_.store(true, std::memory_order_release);
+    opened->set_value(true);   // 이후 opened 는 더 이상 유효하지 않음
+
+    while (!stopRequested_.load(std::memory_order_acquire)) {
+        // depth/interleave 는 실행 중에도 바뀔 수 있으므로 모드 전환 시 다시 분기
+        if (issueDepth() > 1)
+            runPipelined(device);
+        else
+            runSequential(device);
+    }
+
+    device.resetPipeline();
+    device.disconnectPort();
+    connected_.store(false, std::memory_order_release);
+}
+
+void VacuumAcquisition::runSequential(VacuumDevice& device)
+{
+    using clock = std::chrono::steady_clock;
+    clock::time_point next = clock::now();
+
+    while (!stopRequested_.load(std::memory_order_acquire) && issueDepth() <= 1) {
+        VacuumSample s{};
+        float  p   = 0.0f;
+        quint8 raw = 0;
+
+        s.channel = nextChannel();
+        const bool ok = device.measureOnce(s.channel, p, &raw);
+
+        s.timestampNs = nowNs();
+        s.pressure    = p;
+        s.raw         = raw;
+        s.ok          = ok ? 1 : 0;
+
+        if (!device.isConnected())
+            markDisconnected();
+
+        publish(s);
+        notifySamples(s.channel, 1);
+
+        // 고정 주기: 밀렸으면 현재 시각 기준으로 다시 맞춘다
+        next += std::chrono::milliseconds(periodMs_.load(std::memory_order_relaxed));
+        const clock::time_point now = clock::now();
+        if (next < now)
+            next = now;
+
+        sleepUntil(next);
+    }
+}
+
+void VacuumAcquisition::runPipelined(VacuumDevice& device)
+{
+    using clock = std::chrono::steady_clock;
+    clock::time_point nextIssue = clock::now();
+
+    std::vector<VacuumDevice::PipelineSample> results;
+    results.reserve(32);
+
+    while (!stopRequested_.load(std::memory_order_acquire)) {
+        const int depth = issueDepth();
+        if (depth <= 1) {
+            device.resetPipeline();
+            return;
+        }
+
+        clock::time_point now = clock::now();
+        if (now >= nextIssue) {
+            // in-flight 가 가득 차 있으면 이번 슬롯은 건너뜀 (장비가 느린 경우). 교대 순서도 유지
+            if (device.inFlight() < depth)
+                device.issueCommand(nextChannel(), depth);
+
+            nextIssue += std::chrono::milliseconds(periodMs_.load(std::memory_order_relaxed));
+            if (nextIssue < now)
+                nextIssue = now;
+        }
+
+        // 다음 발행 시각까지 응답 수집
+        now = clock::now();
+        const int waitMs = nextIssue > now
+            ? static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(nextIssue - now).count())
+            : 0;
+
+        results.clear();
+        device.collectResponses(waitMs, kResponseTimeoutMs, results);
+
+        for (const VacuumDevice::PipelineSample& r : results) {
+            VacuumSample s{};
+            s.timestampNs = r.receivedNs;
+            s.pressure    = r.pressure;
+            s.channel     = r.channel;
+            s.raw         = r.raw;
+            s.ok          = 1;
+            publish(s);
+        }
+        if (!results.empty())
+            notifySamples(results.back().channel, static_cast<int>(results.size()));
+
+        if (!device.isConnected()) {
+            markDisconnected();
+            sleepUntil(nextIssue);
+        }
+    }
+}
+
+int VacuumAcquisition::nextChannel()
+{
+    if (!interleaved())
+        return channel();
+    return (issueSeq_++ & 1u) ? 2 : 1;
+}
+
+void VacuumAcquisition::publish(const VacuumSample& s)
+{
+    ring_.push(s);
+    if (SharedRing<VacuumSample>* shared = sharedRing_.load(std::memory_order_acquire))
+        shared->push(s);
+    if (RecorderStream* recorder = recorder_.load(std::memory_order_acquire))
+        recorder->record(s);
+    if (WaveformWriter* waveform = waveform_.load(std::memory_order_acquire))
+        waveform->append(s);
+    if (SessionTrace* trace = trace_.load(std::memory_order_acquire))
+        trace->record(s);
+    if (metrics_)
+        DeviceMetrics::add(s.ok ? metrics_->samples : metrics_->failedSamples);
+    if (!s.ok)
+        return;
+
+    latest_.store(s);
+
+    if (!AcquisitionTotals::validChannel(s.channel))
+        return;
+    const int ch = s.channel;
+    latestByChannel_[ch].store(s);
+    runningTotals_.pressureSum[ch] += s.pressure;
+    runningTotals_.count[ch]       += 1;
+    totals_.store(runningTotals_);
+}
+
+void VacuumAcquisition::notifySamples(int channel, int count)
+{
+    if (eventPort_ && count > 0)
+        eventPort_->post(VacuumEventKind::Samples, channel, count);
+}
+
+// 장비 쪽 오류로 끊긴 경우만 (stop() 에 의한 정상 종료는 알리지 않음)
+void VacuumAcquisition::markDisconnected()
+{
+    if (connected_.exchange(false, std::memory_order_acq_rel) && eventPort_)
+        eventPort_->post(VacuumEventKind::Disconnected, channel());
+}
+
+void VacuumAcquisition::sleepUntil(std::chrono::steady_clock::time_point deadline)
+{
+    std::unique_lock<std::mutex> lock(wakeMutex_);
+    wakeCv_.wait_until(lock, deadline, [this] {
+        return stopRequested_.load(std::memory_order_acquire);
+    });
+}
@@ -0,0 +1,195 @@
+// vacuum_acquisition.h
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "vacuum_calibration.h"
+#include "vacuum_event_port.h"
+#include "vacuum_latency_histogram.h"
+#include "vacuum_metrics.h"
+#include "vacuum_sample_ring.h"
+#include "vacuum_seqlock.h"
+#include "vacuum_shared_ring.h"
+
+extern "C" {
+
+// acquisition 스레드가 발행하는 샘플 (FFI 고정 레이아웃)
+struct VacuumSample {
+    int64_t timestampNs;   // steady clock (monotonic)
+    float   pressure;      // kPa
+    int32_t channel;       // 1=VAC1(PAK), 2=VAC2(CHUCK)
+    int32_t raw;           // ADC byte (0~255)
+    int32_t ok;            // 1=응답 수신, 0=timeout/오류
+};
+
+} // extern "C"
+
+class VacuumDevice;
+class RecorderStream;
+class WaveformWriter;
+class SessionTrace;
+
+// 채널별 누적 합계. 소비자는 이전 값과의 차이로 "지난 읽기 이후 평균"을 구한다.
+struct AcquisitionTotals {
+    static constexpr int kChannels = 4;   // index = channel (0 미사용)
+
+    static constexpr bool validChannel(int channel) { return channel > 0 && channel < kChannels; }
+
+    double   pressureSum[kChannels];
+    uint64_t count[kChannels];
+};
+
+// 전용 스레드가 시리얼 포트를 소유하고 고정 주기로 샘플링한다.
+// QSerialPort 는 생성된 스레드에서만 써야 하므로 VacuumDevice 도 스레드 안에서 만든다.
+// 호출자 스레드는 latest()/drain() 으로 결과만 읽고 I/O 는 하지 않는다.
+class VacuumAcquisition
+{
+public:
+    static constexpr int kDefaultPeriodMs = 500;
+    static constexpr int kResponseTimeoutMs = 200;
+
+    enum class Transport {
+        QtThread,   // 전용 스레드 + QSerialPort (기본, 모든 플랫폼)
+        Reactor     // Linux: 공용 epoll reactor 스레드 + termios fd (포트가 많을 때)
+    };
+
+    // Reactor 를 지원하는 빌드인지 (VACUUM_ENABLE_REACTOR)
+    static bool reactorAvailable();
+
+    VacuumAcquisition();
+    ~VacuumAcquisition();
+
+    VacuumAcquisition(const VacuumAcquisition&) = delete;
+    VacuumAcquisition& operator=(const VacuumAcquisition&) = delete;
+
+    // 다음 start() 부터 적용. 지원하지 않으면 false
+    bool setTransport(Transport transport);
+    Transport transport() const { return transport_; }
+
+    // 포트를 열 때까지 기다렸다가 결과 반환
+    bool start(const std::string& portName, int channel, int periodMs = kDefaultPeriodMs);
+    void stop();
+
+    bool isRunning() const { return running_.load(std::memory_order_acquire); }
+    bool isConnected() const { return connected_.load(std::memory_order_acquire); }
+
+    void setChannel(int channel) { channel_.store(channel, std::memory_order_relaxed); }
+    int  channel() const { return channel_.load(std::memory_order_relaxed); }
+
+    // true 면 setChannel 값 대신 VAC1/VAC2 명령을 번갈아 발행 (PAK/CHUCK 동시 검사).
+    // 채널당 샘플 주기는 periodMs * 2 가 된다.
+    // VAC 응답 1 byte 에는 채널 정보가 없어 응답 하나만 유실돼도 이후 응답이 다른 채널 요청과
+    // 짝지어지므로, interleave 중에는 pipelineDepth 와 관계없이 depth 1 (순차) 로 발행한다
+    void setInterleaved(bool enable) { interleaved_.store(enable, std::memory_order_relaxed); }
+    bool interleaved() const { return interleaved_.load(std::memory_order_relaxed); }
+
+    void setPeriodMs(int periodMs);
+    int  periodMs() const { return periodMs_.load(std::memory_order_relaxed); }
+
+    // depth <= 1: 요청 -> 응답 순차 측정 (기존 방식)
+    // depth >= 2: 최대 depth 개의 VAC 명령을 in-flight 로 유지 (pipelined, interleave 중에는 무시)
+    void setPipelineDepth(int depth);
+    int  pipelineDepth() const { return pipelineDepth_.load(std::memory_order_relaxed); }
+
+    // 시작 이후 채널별 누적 합계
+    bool totals(AcquisitionTotals& out) const { return totals_.load(out); }
+
+    // 가장 최근 샘플 (아직 없으면 false)
+    bool latest(VacuumSample& out) const { return latest_.load(out) && out.ok; }
+
+    // 채널의 가장 최근 샘플 (interleave 중에는 latest() 가 다른 채널일 수 있음). 범위 밖 채널은 false
+    bool latest(int channel, VacuumSample& out) const
+    {
+        return AcquisitionTotals::validChannel(channel) && latestByChannel_[channel].load(out) && out.ok;
+    }
+
+    // 지난 drain 이후 쌓인 샘플 복사 (single consumer)
+    int drain(VacuumSample* out, int maxCount);
+
+    // start() 전에 설정. acquisition 스레드의 device 가 round-trip 시간을 기록
+    void setLatencyHistogram(LatencyHistogram* histogram) { rttHistogram_ = histogram; }
+
+    // start() 전에 설정. 링크 카운터 + 발행 샘플 수
+    void setMetrics(DeviceMetrics* metrics) { metrics_ = metrics; }
+
+    // start() 전에 설정. 측정 중 테이블 교체는 CalibrationSet 이 처리
+    void setCalibration(const CalibrationSet* calibration) { calibration_ = calibration; }
+
+    // start() 전에 설정. 샘플 발행/장비 끊김을 Dart port 로 알림
+    void setEventPort(const VacuumEventPort* port) { eventPort_ = port; }
+
+    std::uint64_t droppedSamples() const { return ring_.dropped(); }
+
+    // 발행하는 샘플을 외부 공유 ring 에도 기록 (nullptr = 해제).
+    // 해제 후에도 실행 중인 acquisition 이 쓰고 있을 수 있으므로 ring 은 stop() 이후에 해제할 것
+    void setSharedRing(SharedRing<VacuumSample>* ring) { sharedRing_.store(ring, std::memory_order_release); }
+
+    // 발행하는 샘플을 DB recorder 로도 보냄 (nullptr = 해제). stream 은 acquisition 보다 오래 살아야 함
+    void setRecorderStream(RecorderStream* stream) { recorder_.store(stream, std::memory_order_release); }
+
+    // 발행하는 샘플을 파형 파일에도 기록 (writer 가 열려 있을 때만). writer 는 acquisition 보다 오래 살아야 함
+    void setWaveformWriter(WaveformWriter* writer) { waveform_.store(writer, std::memory_order_release); }
+
+    // 발행하는 정상 샘플을 차트용 LTTB 피라미드에도 추가. trace 는 acquisition 보다 오래 살아야 함
+    void setSessionTrace(SessionTrace* trace) { trace_.store(trace, std::memory_order_release); }
+
+    static int64_t nowNs();
+
+private:
+    class ReactorLink;
+    friend class ReactorLink;
+
+    bool startReactor(const std::string& portName);
+
+    void run(std::string portName, int baud, std::promise<bool>* opened);
+    void runSequential(VacuumDevice& device);
+    void runPipelined(VacuumDevice& device);
+    // 다음 명령의 채널 (발행 스레드에서만 호출)
+    int  nextChannel();
+    // 실제로 적용할 in-flight 한도. interleave 중에는 항상 1
+    int  issueDepth() const { return interleaved() ? 1 : pipelineDepth(); }
+    void publish(const VacuumSample& s);
+    void notifySamples(int channel, int count);
+    void markDisconnected();
+    void sleepUntil(std::chrono::steady_clock::time_point deadline);
+
+    std::thread             thread_;
+    std::mutex              wakeMutex_;
+    std::condition_variable wakeCv_;
+
+    std::atomic<bool> running_{false};
+    std::atomic<bool> stopRequested_{false};
+    std::atomic<bool> connected_{false};
+    std::atomic<int>  channel_{1};
+    std::atomic<bool> interleaved_{false};
+    unsigned          issueSeq_ = 0;   // nextChannel 교대 카운터 (발행 스레드 전용)
+    std::atomic<int>  periodMs_{kDefaultPeriodMs};
+    std::atomic<int>  pipelineDepth_{1};
+
+    LatencyHistogram* rttHistogram_ = nullptr;
+    DeviceMetrics* metrics_ = nullptr;
+    const CalibrationSet* calibration_ = nullptr;
+    const VacuumEventPort* eventPort_ = nullptr;
+
+    Transport                    transport_ = Transport::QtThread;
+    std::unique_ptr<ReactorLink> reactorLink_;
+
+    SampleRing<VacuumSample, 1024> ring_;
+    std::atomic<SharedRing<VacuumSample>*> sharedRing_{nullptr};
+    std::atomic<RecorderStream*>   recorder_{nullptr};
+    std::atomic<WaveformWriter*>   waveform_{nullptr};
+    std::atomic<SessionTrace*>     trace_{nullptr};
+    Seqlock<VacuumSample>          latest_;
+    Seqlock<VacuumSample>          latestByChannel_[AcquisitionTotals::kChannels];
+
+    AcquisitionTotals              runningTotals_{};   // acquisition 스레드 전용
+    Seqlock<AcquisitionTotals>     totals_;
+};
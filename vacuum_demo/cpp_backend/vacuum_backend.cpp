@@ -3,6 +3,9 @@
 // vacuum_backend.cpp
 
 #include "vacuum_backend.h"
+#include "vacuum_trace.h"
+
+#include <algorithm>
 
 #include <QtCore/QDebug>
 #include <QtCore/QString>
@@ -18,7 +21,22 @@ VacuumBackend& VacuumBackend::instance()
 
 VacuumBackend::VacuumBackend()
 {
-    refreshPorts();
+    device_.setLatencyHistogram(&rttHistogram_);
+    acquisition_.setLatencyHistogram(&rttHistogram_);
+    device_.setCalibration(&calibration_);
+    acquisition_.setCalibration(&calibration_);
+    acquisition_.setEventPort(&eventPort_);
+    device_.setMetrics(&metrics_);
+    acquisition_.setMetrics(&metrics_);
+    acquisition_.setRecorderStream(recorderStream_.get());
+    acquisition_.setWaveformWriter(&waveform_);
+    acquisition_.setSessionTrace(&sessionTrace_);
+
+    for (int id = 0; id < kMaxFixtureTypes; ++id)
+        startOffsetSec_[id] = fixtureParams(id).startOffsetSec;
+
+    stateDraft_.pass = 1;
+    storeState(stateDraft_);
 }
 
 VacuumBackend::~VacuumBackend()
@@ -53,21 +71,49 @@ void VacuumBackend::setPressureMode(int kpa)
     qDebug() << "[Backend] setPressureMode:" << kpa << "kPa";
 }
 
+void VacuumBackend::setThresholds(float minPress, float minDiff)
+{
+    if (minDiff < 0.0f) {
+        qWarning() << "[Backend] setThresholds: invalid minDiff" << minDiff;
+        return;
+    }
+    minPress_ = minPress;
+    minDiff_  = minDiff;
+    qDebug() << "[Backend] setThresholds: minPress" << minPress_ << "minDiff" << minDiff_;
+}
+
 void VacuumBackend::setVacStartOffsetSec(int seconds)
 {
     if (seconds <= 0) {
         qWarning() << "[Backend] setVacStartOffsetSec: invalid" << seconds;
         return;
     }
-    vacStartOffsetSec_ = seconds;
-    qDebug() << "[Backend] setVacStartOffsetSec:" << vacStartOffsetSec_;
+    const int fixture = channelFixture(1);
+    startOffsetSec_[fixture] = seconds;
+    qDebug() << "[Backend] setVacStartOffsetSec:" << fixtureParams(fixture).name << seconds;
+}
+
+bool VacuumBackend::setChannelFixture(int channel, int fixtureId)
+{
+    if (!isVacChannel(channel) || !isFixtureRegistered(fixtureId)) {
+        qWarning() << "[Backend] setChannelFixture: invalid" << channel << fixtureId;
+        return false;
+    }
+    channelFixture_[channel] = fixtureId;
+    qDebug() << "[Backend] setChannelFixture: VAC" << channel << "->" << fixtureParams(fixtureId).name;
+    return true;
+}
+
+int VacuumBackend::channelFixture(int channel) const
+{
+    return (channel >= 0 && channel < kFixtureChannels) ? channelFixture_[channel] : GenericFixture::kId;
 }
 
 void VacuumBackend::start()
 {
     elapsedSteps_  = 0;
-    lastPressure_  = 0.0f;
-    lastPass_      = true;
+    publishState(1, 0.0f, true, nullptr);
+    sessionTrace_.clear();
 
     qDebug() << "[Backend] start()";
 }
@@ -85,15 +131,13 @@ void VacuumBackend::step()
         return;
     }
 
-    lastPressure_ = p;
     ++elapsedSteps_;
 
     const float threshold = static_cast<float>(pressureSet_) - 3.0f;
-    lastPass_ = (lastPressure_ >= threshold);
+    const bool  pass      = (p >= threshold);
+    publishState(1, p, pass, nullptr);
 
-    qDebug() << "VAC measure:" << lastPressure_ << "kPa"
-             << "elapsed:" << elapsedSteps_
-             << "pass:" << (lastPass_ ? "PASS" : "FAIL");
+    VACUUM_TRACE_INFO(TraceEvent::Step, elapsedSteps_, pass ? 1 : 0, p, 0, 0);
 }
 
 void VacuumBackend::refreshPorts()
@@ -118,17 +162,27 @@ bool VacuumBackend::connectToPort(const char* portName)
 {
     if (!portName) return false;
 
+    acquisition_.stop();
+
     QString qPort = QString::fromUtf8(portName);
     qDebug() << "[Backend] connectToPort(" << qPort << ")";
 
     if (!device_.connectPort(qPort, 19200)) {
         connected_      = false;
         currentPortName_.clear();
+        publishConnection();
         return false;
     }
 
     connected_       = true;
     currentPortName_ = std::string(portName);
+    {
+        std::lock_guard<std::mutex> lock(portNameMutex_);
+        if (currentPortName_ == lastPortName_)
+            DeviceMetrics::add(metrics_.reconnects);
+        lastPortName_ = currentPortName_;
+    }
+    publishConnection();
 
     qDebug() << "[Backend] connectToPort(" << qPort << ") -> true";
     return true;
@@ -136,6 +190,8 @@ bool VacuumBackend::connectToPort(const char* portName)
 
 void VacuumBackend::disconnect()
 {
+    acquisition_.stop();
+
     if (connected_) {
         qDebug() << "[Backend] disconnect() from"
                  << QString::fromUtf8(currentPortName_.c_str());
@@ -144,11 +200,202 @@ void VacuumBackend::disconnect()
     device_.disconnectPort();
     connected_       = false;
     currentPortName_.clear();
+    publishConnection();
 }
 
 bool VacuumBackend::isConnected() const
 {
-    return connected_ && device_.isConnected();
+    if (!connected_)
+        return false;
+    return acquisition_.isRunning() ? acquisition_.isConnected() : device_.isConnected();
+}
+
+// ───────────────────────────────────────
+//  Background acquisition
+// ───────────────────────────────────────
+bool VacuumBackend::startAcquisition(int channel, int periodMs)
+{
+    if (!AcquisitionTotals::validChannel(channel)) {
+        qWarning() << "[Backend] startAcquisition: invalid channel" << channel;
+        return false;
+    }
+    if (!connected_) {
+        qWarning() << "[Backend] startAcquisition: not connected";
+        return false;
+    }
+
+    if (acquisition_.isRunning()) {
+        acquisition_.setChannel(channel);
+        acquisition_.setPeriodMs(periodMs);
+        return true;
+    }
+
+    // 포트 소유권을 acquisition 스레드로 이전
+    device_.disconnectPort();
+    lastTotals_ = AcquisitionTotals{};
+
+    if (!acquisition_.start(currentPortName_, channel, periodMs)) {
+        qWarning() << "[Backend] startAcquisition failed, reopening port";
+        if (device_.connectPort(QString::fromUtf8(currentPortName_.c_str()), 19200))
+            DeviceMetrics::add(metrics_.reconnects);
+        return false;
+    }
+    return true;
+}
+
+void VacuumBackend::metricsSnapshot(VacuumMetricsSnapshot& out)
+{
+    out.commands       = metrics_.commands.load(std::memory_order_relaxed);
+    out.responses      = metrics_.responses.load(std::memory_order_relaxed);
+    out.timeouts       = metrics_.timeouts.load(std::memory_order_relaxed);
+    out.shortReads     = metrics_.shortReads.load(std::memory_order_relaxed);
+    out.writeErrors    = metrics_.writeErrors.load(std::memory_order_relaxed);
+    out.staleBytes     = metrics_.staleBytes.load(std::memory_order_relaxed);
+    out.resyncs        = metrics_.resyncs.load(std::memory_order_relaxed);
+    out.reconnects     = metrics_.reconnects.load(std::memory_order_relaxed);
+    out.samples        = metrics_.samples.load(std::memory_order_relaxed);
+    out.failedSamples  = metrics_.failedSamples.load(std::memory_order_relaxed);
+    out.droppedSamples = acquisition_.droppedSamples();
+
+    out.rtt.count  = rttHistogram_.count();
+    out.rtt.meanUs = rttHistogram_.mean();
+    out.rtt.minUs  = rttHistogram_.min();
+    out.rtt.p50Us  = rttHistogram_.percentile(0.50);
+    out.rtt.p90Us  = rttHistogram_.percentile(0.90);
+    out.rtt.p99Us  = rttHistogram_.percentile(0.99);
+    out.rtt.maxUs  = rttHistogram_.max();
+
+    const int64_t now = VacuumAcquisition::nowNs();
+    std::lock_guard<std::mutex> lock(rateMutex_);
+    out.samplesPerSec = (rateNs_ > 0 && now > rateNs_ && out.samples >= rateSamples_)
+        ? static_cast<double>(out.samples - rateSamples_) * 1e9 / static_cast<double>(now - rateNs_)
+        : 0.0;
+    rateSamples_ = out.samples;
+    rateNs_      = now;
+}
+
+void VacuumBackend::resetMetrics()
+{
+    metrics_.reset();
+    rttHistogram_.reset();
+
+    std::lock_guard<std::mutex> lock(rateMutex_);
+    rateSamples_ = 0;
+    rateNs_      = 0;
+}
+
+std::string VacuumBackend::metricsLabel() const
+{
+    std::lock_guard<std::mutex> lock(portNameMutex_);
+    return lastPortName_;
+}
+
+int64_t VacuumBackend::beginRecording(const std::string& station)
+{
+    // 이전 세션이 끝나지 않았으면 lotid 없이 닫음
+    SampleRecorder::shared().endSession(recorderStream_, 0);
+    return SampleRecorder::shared().beginSession(recorderStream_,
+                                                 station.empty() ? currentPortName_ : station);
+}
+
+bool VacuumBackend::endRecording(int64_t lotid)
+{
+    return SampleRecorder::shared().endSession(recorderStream_, lotid);
+}
+
+bool VacuumBackend::beginWaveform(const std::string& path)
+{
+    std::string error;
+    if (!waveform_.begin(path, &calibration_, &error)) {
+        qWarning() << "[Backend] waveform:" << QString::fromStdString(error);
+        return false;
+    }
+    return true;
+}
+
+int64_t VacuumBackend::endWaveform()
+{
+    return waveform_.finish();
+}
+
+bool VacuumBackend::setAcquisitionTransport(int transport)
+{
+    return acquisition_.setTransport(transport == 1 ? VacuumAcquisition::Transport::Reactor
+                                                    : VacuumAcquisition::Transport::QtThread);
+}
+
+bool VacuumBackend::loadCalibration(const std::string& path)
+{
+    std::string error;
+    if (!calibration_.loadFile(path, &error)) {
+        qWarning() << "[VacuumBackend] loadCalibration failed:" << QString::fromStdString(error);
+        return false;
+    }
+
+    qDebug() << "[VacuumBackend] calibration loaded:" << QString::fromStdString(path)
+             << "VAC1 =" << QString::fromStdString(calibration_.profileName(1))
+             << "VAC2 =" << QString::fromStdString(calibration_.profileName(2));
+    return true;
+}
+
+bool VacuumBackend::selectCalibration(int channel, const std::string& profile)
+{
+    if (!calibration_.selectProfile(channel, profile)) {
+        qWarning() << "[VacuumBackend] unknown calibration profile:" << QString::fromStdString(profile);
+        return false;
+    }
+    return true;
+}
+
+void VacuumBackend::stopAcquisition()
+{
+    if (!acquisition_.isRunning())
+        return;
+
+    acquisition_.stop();
+
+    if (connected_)
+        device_.connectPort(QString::fromUtf8(currentPortName_.c_str()), 19200);
+}
+
+bool VacuumBackend::acquirePressure(int channel, float& outPressure)
+{
+    if (!AcquisitionTotals::validChannel(channel)) {
+        qWarning() << "[Backend] acquirePressure: invalid channel" << channel;
+        return false;
+    }
+
+    if (!acquisition_.isRunning()) {
+        if (!device_.measureOnce(channel, outPressure))
+            return false;
+        if (LttbPyramid* trace = sessionTrace_.channel(channel))
+            trace->append(VacuumAcquisition::nowNs() / 1000, outPressure);
+        return true;
+    }
+
+    // interleave 중에는 두 채널이 모두 발행되므로 전환하지 않음
+    if (!acquisition_.interleaved() && acquisition_.channel() != channel)
+        acquisition_.setChannel(channel);
+
+    // pipelined 모드에서는 호출 간격 동안 여러 샘플이 쌓인다 -> 평균해서 사용.
+    // 기준값은 읽은 채널만 갱신 (다른 채널의 다음 호출이 자기 구간 평균을 얻도록)
+    AcquisitionTotals totals{};
+    const int ch = channel;
+    if (acquisition_.totals(totals) && totals.count[ch] > lastTotals_.count[ch]) {
+        const double   sum = totals.pressureSum[ch] - lastTotals_.pressureSum[ch];
+        const uint64_t n   = totals.count[ch] - lastTotals_.count[ch];
+        lastTotals_.pressureSum[ch] = totals.pressureSum[ch];
+        lastTotals_.count[ch]       = totals.count[ch];
+        outPressure = static_cast<float>(sum / static_cast<double>(n));
+        return true;
+    }
+
+    VacuumSample s{};
+    if (!acquisition_.latest(channel, s) || s.channel != channel)
+        return false;
+
+    outPressure = s.pressure;
+    return true;
 }
 
 // ───────────────────────────────────────
@@ -161,172 +408,313 @@ bool VacuumBackend::measureOnceInternal(int channel, float& outPressure)
         return false;
     }
 
-    return device_.measureOnce(channel, outPressure);
+    return acquirePressure(channel, outPressure);
 }
 
 
 
 bool VacuumBackend::measureAndDecide(int channel, int counter, float& outPressure, float& pSt, float& pSp, float& diffPressure, bool& pass, bool& stop)
 {
-    float val=0.0;
-    float hval = 0.0;
-    float hrate = 0.0;
-
-    const bool isManualMode = (timeMode_ == 1) || (configuredDuration_ == 0);
-
-    if(channel == 1) {
-        //direction = "PAK";
-        hrate = 0.5;
-        STARTOFFSET = vacStartOffsetSec_;
-    } else if (channel == 2 ) {
-        //direction = "CHUCK";
-        hrate = 0.6;
-        STARTOFFSET = chkStartOffsetSec_;
-
-    } else {
-        hrate = 1.0;
-        STARTOFFSET = chkStartOffsetSec_;
-    } 
-
     if (!isConnected()) {
         qWarning() << "[Backend] measureOnceInternal: not connected";
+        publishConnection();
+        return false;
+    }
+    // 범위 밖 채널을 다른 채널 세션으로 접어 넣지 않음
+    if (!AcquisitionTotals::validChannel(channel)) {
+        qWarning() << "[Backend] measureAndDecide: invalid channel" << channel;
         return false;
     }
     // qDebug() << "Counter:" <<counter;
-    bool result= device_.measureOnce(channel, outPressure);
+    bool result= acquirePressure(channel, outPressure);
+
+    ChannelSession& cs = sessions_[channel];
+    lastChannel_ = channel;
+
+    // counter 1 = 새 검사 시작 (이 채널만)
+    if (counter == 1) {
+        cs.session.reset(sessionConfig(channel));
+        cs.earlyReported = false;
+        cs.settleReported = false;
+        cs.verdictReported = false;
+        cs.reportedPhase = LeakPhase::Stabilizing;
+    }
 
+    const LeakTestResult r = cs.session.feed(static_cast<double>(counter) / DIV, outPressure);
 
-    // before STARTOFFSET 
-    if(counter <= STARTOFFSET*DIV )
-    {
-        pass = true; 
-        stop = false; 
-        diffPressure = 0.0;
-        offsetpress = 0.0;
-        startpress = 0.0f;
-        stoppress = 0.0f;
-        *spcntPtr = 0;
-        *stcntPtr = 0;
-
-        if(counter == 1)
-        {
-            clearAveraging( st_avgpress, sp_avgpress, stcntPtr);
-        }
+    if (r.phase != LeakPhase::Stabilizing && !cs.settleReported) {
+        cs.settleReported = true;
+        VACUUM_TRACE_INFO(TraceEvent::Settled, channel, 0,
+                          static_cast<float>(cs.session.settledSec()),
+                          static_cast<float>(cs.session.settleSavedSec()), 0);
+    }
 
-        qDebug() << "Ranger UNDER OFFSET:" <<counter;
-        qDebug() << "pressure :" << outPressure;
-        qDebug() << "start pressure :" << pSt;
-        qDebug() << "stop pressure :" << pSp;
-        qDebug() << "diff pressure :" << diffPressure;
-        qDebug() << "STARTOFFSET :" << STARTOFFSET;
-        // over STARTOFFSET but not yet averaging done
-    } else if ( counter > STARTOFFSET*DIV && counter <=  (STARTOFFSET*DIV+MAXAVG))
-    {
-        pass = true; 
-        stop = false; 
-        diffPressure = 0.0;
-        startpress = pSt = averaging(st_avgpress, outPressure,  stcntPtr);
-        stoppress = pSp  = averaging(sp_avgpress, outPressure,  spcntPtr);
-        if(startpress > 65.5)
-        {
-            offsetpress = startpress -65.5;
-        } else {
-            offsetpress = 0.0f;
-        }
-        startpress = startpress - offsetpress;
+    if (r.early && !cs.earlyReported) {
+        cs.earlyReported = true;
+        VACUUM_TRACE_INFO(TraceEvent::EarlyDecision, channel, r.pass ? 1 : 0,
+                          static_cast<float>(cs.session.pressureSlope()),
+                          static_cast<float>(cs.session.earlySavedSec()), 0);
+    }
 
-        qDebug() << "Ranger BTW OFFSET AND AVG:" <<counter;
-        qDebug() << "pressure :" << outPressure;
-        qDebug() << "start pressure :" << pSt;
-        qDebug() << "stop pressure :" << pSp;
-        qDebug() << "diff pressure :" << diffPressure;
+    if (r.phase != cs.reportedPhase) {
+        cs.reportedPhase = r.phase;
+        eventPort_.post(VacuumEventKind::Phase, channel, static_cast<int>(r.phase));
+    }
 
-    // measuring time (MANUAL: treat as infinite duration)
-    } else if (counter > (STARTOFFSET*DIV+MAXAVG)  && (isManualMode || counter <= (configuredDuration_+STARTOFFSET)*DIV+MAXAVG))
-    {
-        pSp  = averaging(sp_avgpress, outPressure,  spcntPtr);
-        pSp = pSp - offsetpress;
-        pSt = startpress;
+    if (r.stop && !cs.verdictReported) {
+        cs.verdictReported = true;
+        eventPort_.post(VacuumEventKind::Verdict, channel, (r.pass ? 1 : 0) | (r.early ? 2 : 0));
+    }
 
+    publishState(channel, outPressure, r.pass, &r);
 
-        // stoppress = press - offsetpress;
-        val = pSp - pSt;
-        if(val<0) {
-            hval = -(val*hrate);
-        } else {
-            hval = (val*hrate);
-        }
-        pSp = pSp + hval;
-
-        diffPressure = pSp - pSt;
-        //////////////////////////////////////////////////////////////////////
-        // pass fail
-        if(( pSp >= MINPRESS) && ( diffPressure <= MINDIFF && diffPressure >= -MINDIFF)) {
-            pass = true;
-            stop = false;
-        } else {
-            pass = false;
-            stop = !isManualMode;
+    pass = r.pass;
+    stop = r.stop;
+    diffPressure = r.diffPressure;
+    if (r.phase != LeakPhase::Stabilizing) {
+        pSt = r.startPressure;
+        pSp = r.stopPressure;
+    }
+
+    // start = stop - diff
+    VACUUM_TRACE_INFO(TraceEvent::Decision, counter,
+                      (channel & 0xff) << 16 | static_cast<int>(r.phase) << 8
+                          | (r.pass ? kTracePass : 0) | (r.stop ? kTraceStop : 0) | (r.early ? kTraceEarly : 0),
+                      outPressure, r.stopPressure, r.diffPressure);
+
+    return result;
+}
+
+LeakTestConfig VacuumBackend::sessionConfig(int channel) const
+{
+    const bool isManualMode = (timeMode_ == 1) || (configuredDuration_ == 0);
+
+    // 채널에 물린 지그 -> 정책 table (검사 시작 시 한 번)
+    const int fixture = channelFixture(channel);
+    LeakTestConfig cfg;
+    cfg.hrate          = fixtureParams(fixture).hrate;
+    cfg.startOffsetSec = startOffsetSec_[fixture];
+
+    cfg.averagingWindow = averagingWindow(channel);
+    cfg.durationSec     = isManualMode ? 0.0 : configuredDuration_;
+    cfg.minPress        = minPress_;
+    cfg.minDiff         = minDiff_;
+    cfg.earlyDecision   = earlyDecision_;
+    cfg.minHoldSec      = earlyMinHoldSec_;
+    cfg.adaptiveSettling = adaptiveSettling_;
+    return cfg;
+}
+
+void VacuumBackend::setAdaptiveSettling(bool enable)
+{
+    adaptiveSettling_ = enable;
+}
+
+int VacuumBackend::readSamples(VacuumSampleRecord* out, int maxCount)
+{
+    if (!out || maxCount <= 0)
+        return 0;
+
+    // 레코드마다 자기 채널의 판정. 제어 스레드가 갱신 중이어도 channelState_ snapshot 은 일관된 값
+    VacuumStateSnapshot decision[AcquisitionTotals::kChannels];
+    std::uint8_t        flags[AcquisitionTotals::kChannels];
+    for (int c = 0; c < AcquisitionTotals::kChannels; ++c) {
+        VacuumStateSnapshot& d = decision[c];
+        if (!channelState_[c].load(d)) {
+            d = VacuumStateSnapshot{};   // 아직 측정 안 한 채널
+            d.pass = 1;
         }
-        qDebug() << "Ranger BTW AVG AND DURATION:" <<counter;
-        qDebug() << "pressure :" << outPressure;
-        qDebug() << "start pressure :" << pSt;
-        qDebug() << "stop pressure :" << pSp;
-        qDebug() << "*stcntPtr     :" << *stcntPtr;
-        qDebug() << "*spcntPtr     :" << *spcntPtr;
-        qDebug() << "diff pressure :" << diffPressure;
-    } else {
-        pSp  = averaging(sp_avgpress, outPressure,  spcntPtr);
-        pSp = pSp - offsetpress;
-        diffPressure = pSp - startpress;
-        pSt = startpress;
-        //////////////////////////////////////////////////////////////////////
-        // pass fai
-        if(( pSp >= MINPRESS) && ( diffPressure <= MINDIFF && diffPressure >= -MINDIFF)) {
-            pass = true;
-            stop = true;
-        } else {
-            pass = false;
-            stop = true;
+        flags[c] = static_cast<std::uint8_t>((d.pass ? VACUUM_SAMPLE_PASS : 0) | (d.stop ? VACUUM_SAMPLE_STOP : 0)
+                                             | (d.early ? VACUUM_SAMPLE_EARLY : 0));
+    }
+
+    // ring -> 스택 버퍼 -> 레코드 (chunk 단위, 할당 없음)
+    constexpr int kChunk = 64;
+    VacuumSample chunk[kChunk];
+    int total = 0;
+
+    while (total < maxCount) {
+        const int want = std::min(kChunk, maxCount - total);
+        const int n    = acquisition_.drain(chunk, want);
+
+        for (int i = 0; i < n; ++i) {
+            const VacuumSample& s = chunk[i];
+            const int c = AcquisitionTotals::validChannel(s.channel) ? s.channel : 0;   // 0 = 판정 없음
+            const VacuumStateSnapshot& d = decision[c];
+            VacuumSampleRecord& r = out[total + i];
+            r.timestampNs   = s.timestampNs;
+            r.pressure      = s.pressure;
+            r.startPressure = d.startPressure;
+            r.stopPressure  = d.stopPressure;
+            r.diffPressure  = d.diffPressure;
+            r.raw           = static_cast<std::uint8_t>(s.raw);
+            r.channel       = static_cast<std::uint8_t>(s.channel);
+            r.phase         = static_cast<std::uint8_t>(d.phase);
+            r.flags         = static_cast<std::uint8_t>(flags[c] | (s.ok ? VACUUM_SAMPLE_OK : 0));
+            r.reserved      = 0;
         }
-        qDebug() << "Ranger OVER DURATION:" <<counter;
-        qDebug() << "pressure :" << outPressure;
-        qDebug() << "start pressure :" << pSt;
-        qDebug() << "stop pressure :" << pSp;
-        qDebug() << "diff pressure :" << diffPressure;
+
+        total += n;
+        if (n < want)
+            break;
     }
-    return result;
-    // return device_.measureOnce(channel, outPressure);
+    return total;
 }
 
-float VacuumBackend::averaging(float vacarr[], float val,  unsigned int *idx) {
-    float total = 0.0;
-    if(*idx < MAXAVG) {
-        vacarr[(*idx)]= val;
-        for( unsigned int i=0; i <= *idx; i++)
-        {
-            total += vacarr[i];
+bool VacuumBackend::createSharedRing(int capacity, VacuumSharedRingInfo& out)
+{
+    if (!sharedRing_) {
+        if (capacity <= 0 || capacity > (1 << 20)) {
+            qWarning() << "[Backend] shared ring capacity out of range:" << capacity;
+            return false;
         }
-        (*idx)++;
-        return (total/(*idx));
+        sharedRing_.reset(new SharedRing<VacuumSample>(static_cast<std::uint32_t>(capacity)));
+        acquisition_.setSharedRing(sharedRing_.get());
+    }
+
+    out.records    = sharedRing_->slots();
+    out.head       = sharedRing_->headWord();
+    out.tail       = sharedRing_->tailWord();
+    out.dropped    = sharedRing_->droppedWord();
+    out.capacity   = sharedRing_->capacity();
+    out.recordSize = sizeof(VacuumSample);
+    return true;
+}
+
+bool VacuumBackend::destroySharedRing()
+{
+    if (!sharedRing_)
+        return true;
+
+    // acquisition 스레드가 push 중일 수 있음
+    if (acquisition_.isRunning()) {
+        qWarning() << "[Backend] destroySharedRing: stop acquisition first";
+        return false;
+    }
+
+    acquisition_.setSharedRing(nullptr);
+    sharedRing_.reset();
+    return true;
+}
+
+void VacuumBackend::sessionReport(VacuumSessionReport& out) const
+{
+    sessionReport(lastChannel_, out);
+}
+
+void VacuumBackend::sessionReport(int channel, VacuumSessionReport& out) const
+{
+    if (!AcquisitionTotals::validChannel(channel)) {
+        out = VacuumSessionReport{};
+        return;
+    }
+
+    const LeakTestSession& session = sessions_[channel].session;
+    out.phase          = static_cast<int>(session.phase());
+    out.early          = session.decidedEarly() ? 1 : 0;
+    out.settledSec     = static_cast<float>(session.settledSec());
+    out.settleSavedSec = static_cast<float>(session.settleSavedSec());
+    out.earlySavedSec  = static_cast<float>(session.earlySavedSec());
+    out.slopeKpaPerSec = static_cast<float>(session.pressureSlope());
+}
+
+// ───────────────────────────────────────
+//  State snapshot
+// ───────────────────────────────────────
+void VacuumBackend::publishState(int channel, float pressure, bool pass, const LeakTestResult* decision)
+{
+    std::lock_guard<std::mutex> lock(stateWriteMutex_);
+    VacuumStateSnapshot& s = stateDraft_;
+    s.pressure  = pressure;
+    s.channel   = channel;
+    s.pass      = pass ? 1 : 0;
+    s.connected = isConnected() ? 1 : 0;
+    if (decision) {
+        s.phase         = static_cast<int32_t>(decision->phase);
+        s.startPressure = decision->startPressure;
+        s.stopPressure  = decision->stopPressure;
+        s.diffPressure  = decision->diffPressure;
+        s.stop          = decision->stop ? 1 : 0;
+        s.early         = decision->early ? 1 : 0;
     } else {
-        for(unsigned int i=0; i < MAXAVG-1; i++)
-        {
-            vacarr[i] = vacarr[i+1];
-            total += vacarr[i];
-        }
-        vacarr[MAXAVG-1] = val;
-        total += vacarr[MAXAVG-1];
-        return (total/MAXAVG);
+        // step() 경로: 판정 세션 없음
+        s.phase         = static_cast<int32_t>(LeakPhase::Stabilizing);
+        s.startPressure = 0.0f;
+        s.stopPressure  = 0.0f;
+        s.diffPressure  = 0.0f;
+        s.stop          = 0;
+        s.early         = 0;
     }
+    storeState(s);
+    if (AcquisitionTotals::validChannel(channel))
+        channelState_[channel].store(s);
 }
 
+void VacuumBackend::publishConnection()
+{
+    std::lock_guard<std::mutex> lock(stateWriteMutex_);
+    const int32_t connected = isConnected() ? 1 : 0;
+    if (stateDraft_.connected != connected) {
+        stateDraft_.connected = connected;
+        storeState(stateDraft_);
+    }
+}
 
-void VacuumBackend::clearAveraging(float vacarr1[], float vacarr2[], unsigned int *idx ) {
-    for(unsigned int i=0; i < MAXAVG; i++)
-    {
-        vacarr1[i] = 0.0;
-        vacarr2[i] = 0.0;
+void VacuumBackend::storeState(VacuumStateSnapshot& s)
+{
+    s.version    += 1;
+    s.timestampNs = VacuumAcquisition::nowNs();
+    state_.store(s);
+}
+
+void VacuumBackend::stateSnapshot(VacuumStateSnapshot& out) const
+{
+    state_.load(out);   // 생성자에서 첫 발행
+    // acquisition 링크가 끊기면 다음 발행 전이라도 바로 0 (atomic 만 읽음)
+    if (acquisition_.isRunning() && !acquisition_.isConnected())
+        out.connected = 0;
+}
+
+bool VacuumBackend::stateSnapshot(int channel, VacuumStateSnapshot& out) const
+{
+    if (!AcquisitionTotals::validChannel(channel) || !channelState_[channel].load(out))
+        return false;
+    if (acquisition_.isRunning() && !acquisition_.isConnected())
+        out.connected = 0;
+    return true;
+}
+
+float VacuumBackend::lastPressure() const
+{
+    VacuumStateSnapshot s;
+    stateSnapshot(s);
+    return s.pressure;
+}
+
+bool VacuumBackend::lastPass() const
+{
+    VacuumStateSnapshot s;
+    stateSnapshot(s);
+    return s.pass != 0;
+}
+
+void VacuumBackend::setEarlyDecision(bool enable, int minHoldSec)
+{
+    earlyDecision_   = enable;
+    earlyMinHoldSec_ = minHoldSec > 0 ? minHoldSec : 0;
+}
+
+bool VacuumBackend::setAveragingWindow(int channel, int window)
+{
+    if (channel < 0 || channel > 3 || !AveragingFilter::isSupportedWindow(window)) {
+        qWarning() << "[Backend] unsupported averaging window:" << channel << window;
+        return false;
     }
-    *idx = 0;
+    avgWindow_[channel] = window;
+    return true;
+}
+
+int VacuumBackend::averagingWindow(int channel) const
+{
+    return (channel >= 0 && channel <= 3) ? avgWindow_[channel] : MAXAVG;
 }
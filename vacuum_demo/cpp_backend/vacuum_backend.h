@@ -4,23 +4,25 @@
 // vacuum_backend.h
 #pragma once
 
+#include <atomic>
 #include <vector>
 #include <string>
+#include <mutex>
 #include<math.h>
 #include "vacuum_device.h"
+#include "vacuum_acquisition.h"
+#include "vacuum_fixture_policy.h"
+#include "vacuum_leak_session.h"
+#include "vacuum_lttb.h"
+#include "vacuum_sample_recorder.h"
+#include "vacuum_seqlock.h"
+#include "vacuum_waveform_file.h"
 
 #define MAXAVG 5
 // #define STARTOFFSET 7
 #define DIV 2
 
 #define MAXTIME 65535
-// vacuum_backend.h 
-static int MAXPRESS=67;
-static int MINPRESS=62;
-static float MINDIFF=1.0;
-static float hrate = 0.5;
-static int STARTOFFSET = 7;
-
 
 
 extern "C" {
@@ -42,25 +44,140 @@ struct VacuumMeasureResult {
 #endif
  EXPORT VacuumMeasureResult vacuum_measure_decide(int channel, int counter);
 
+// 명령 전송 ~ 응답 프레임 수신 시간 통계 (microseconds)
+struct VacuumLatencyStats {
+    uint64_t count;
+    double   meanUs;
+    uint64_t minUs;
+    uint64_t p50Us;
+    uint64_t p90Us;
+    uint64_t p99Us;
+    uint64_t maxUs;
+};
+
+// 현재(또는 마지막) 검사 세션 요약
+struct VacuumSessionReport {
+    int   phase;            // 0=안정화, 1=시작 평균, 2=측정, 3=완료
+    int   early;            // 1 = 조기 판정으로 종료
+    float settledSec;       // 안정화 완료 시각 (<0: 아직)
+    float settleSavedSec;   // adaptive settling 으로 줄인 대기 시간
+    float earlySavedSec;    // 조기 판정으로 줄인 측정 시간
+    float slopeKpaPerSec;   // 측정 구간 압력 기울기 (조기 판정 사용 시)
+};
+
+// 관찰 가능한 backend 상태 (vacuum_get_state). 어느 스레드에서든 lock 없이 일관된 값을 읽는다
+struct VacuumStateSnapshot {
+    uint64_t version;        // 발행 횟수 (같으면 바뀐 것 없음)
+    int64_t  timestampNs;    // 발행 시각 (steady clock)
+    float    pressure;       // 마지막 측정 압력 (measure_decide / step)
+    float    startPressure;
+    float    stopPressure;
+    float    diffPressure;
+    int32_t  channel;        // 마지막 측정 채널
+    int32_t  phase;          // VacuumSessionReport::phase 와 동일
+    int32_t  pass;           // 1=PASS, 0=FAIL
+    int32_t  stop;
+    int32_t  connected;
+    int32_t  early;          // earlyDecision 으로 조기 판정됨
+};
+
+// 장비별 링크 카운터 snapshot (누적값, samplesPerSec 은 직전 snapshot 이후 평균)
+struct VacuumMetricsSnapshot {
+    uint64_t commands;
+    uint64_t responses;
+    uint64_t timeouts;
+    uint64_t shortReads;
+    uint64_t writeErrors;
+    uint64_t staleBytes;
+    uint64_t resyncs;
+    uint64_t reconnects;
+    uint64_t samples;
+    uint64_t failedSamples;
+    uint64_t droppedSamples;      // acquisition 큐가 가득 차서 버린 샘플
+    double   samplesPerSec;
+    VacuumLatencyStats rtt;       // us
+};
+
+// vacuum_read_samples 레코드 (32 bytes, 고정 layout - Dart struct 와 일치해야 함)
+// phase / 판정 필드는 샘플을 읽는 시점의 마지막 measureAndDecide 결과
+enum {
+    VACUUM_SAMPLE_OK    = 1 << 0,   // 응답 수신 (0 이면 timeout, pressure 무효)
+    VACUUM_SAMPLE_PASS  = 1 << 1,
+    VACUUM_SAMPLE_STOP  = 1 << 2,
+    VACUUM_SAMPLE_EARLY = 1 << 3,   // 조기 판정으로 stop
+};
+
+struct VacuumSampleRecord {
+    int64_t timestampNs;     // steady clock (monotonic)
+    float   pressure;        // kPa
+    float   startPressure;
+    float   stopPressure;
+    float   diffPressure;
+    uint8_t raw;             // ADC byte
+    uint8_t channel;         // 1=VAC1(PAK), 2=VAC2(CHUCK)
+    uint8_t phase;           // VacuumSessionReport::phase 와 동일
+    uint8_t flags;           // VACUUM_SAMPLE_*
+    int32_t reserved;
+};
+
+// vacuum_shared_ring_create 결과. Dart 가 포인터로 직접 읽는 샘플 ring
+//   n = acquire(head) - tail;  records[(tail + i) & (capacity - 1)] 읽기;  release(tail, tail + n)
+// head/tail 접근은 vacuum_ring_acquire_load / vacuum_ring_release_store 사용
+struct VacuumSharedRingInfo {
+    VacuumSample* records;      // VacuumSample[capacity]
+    uint64_t*     head;         // producer 가 증가 (쓰기 금지)
+    uint64_t*     tail;         // consumer 가 증가
+    uint64_t*     dropped;      // 가득 차서 버린 샘플 수
+    uint32_t      capacity;     // 2 의 거듭제곱
+    uint32_t      recordSize;   // sizeof(VacuumSample)
+};
+
+// vacuum_open() 이 돌려주는 장비 핸들 (opaque)
+typedef struct VacuumDeviceHandle VacuumDeviceHandle;
+
+// vacuum_waveform_open() 이 돌려주는 파형 파일 reader (opaque)
+typedef struct VacuumWaveformHandle VacuumWaveformHandle;
+
 } // extern "C"
 
+static_assert(sizeof(VacuumSampleRecord) == 32, "VacuumSampleRecord layout is shared with Dart");
+static_assert(sizeof(VacuumStateSnapshot) == 56, "VacuumStateSnapshot layout is shared with Dart");
+
+// 장비(시리얼 포트) 1개당 1개. 기존 C API 는 instance() 를,
+// 핸들 API (vacuum_open / vacuum_dev_*) 는 핸들마다 별도 인스턴스를 사용한다.
 class VacuumBackend
 {
 public:
     static VacuumBackend& instance();
 
+    VacuumBackend();
+    ~VacuumBackend();
+
     // 
     void setTimeMode(int mode);
     void setPressureMode(int kpa);
 
-    // VAC 준비시간(STARTOFFSET) 설정 (초)
+    // PASS 판정 기준 (기본값: kDefaultMinPress, kDefaultMinDiff)
+    void setThresholds(float minPress, float minDiff);
+
+    // VAC1 에 물린 지그의 준비시간(STARTOFFSET) 설정 (초). 지그 종류별 값이므로 같은 지그가 물린 다른 채널에도 적용.
+    // setChannelFixture(1, ..) 로 VAC1 지그를 바꿨으면 그 뒤에 다시 호출할 것
     void setVacStartOffsetSec(int seconds);
 
+    // 채널(VAC1/VAC2)에 물린 지그 종류 (vacuum_fixture_policy.h 의 kId). 다음 측정 시작부터 적용.
+    // 등록되지 않은 id 나 VAC 채널이 아니면 false
+    bool setChannelFixture(int channel, int fixtureId);
+    int  channelFixture(int channel) const;
+
     void start();   // Flutter
     void step();    // Flutter 
 
-    float lastPressure() const { return lastPressure_; }
-    bool  lastPass() const { return lastPass_; }
+    // 상태 snapshot (seqlock). 어느 스레드에서든 호출 가능, acquisition 을 막지 않음
+    float lastPressure() const;
+    bool  lastPass() const;
+    void  stateSnapshot(VacuumStateSnapshot& out) const;
+    // channel 에서 마지막으로 측정했을 때의 상태 (없으면 false)
+    bool  stateSnapshot(int channel, VacuumStateSnapshot& out) const;
 
     // ---
     void refreshPorts();
@@ -71,6 +188,73 @@ public:
     void disconnect();
     bool isConnected() const;
 
+    // --- background acquisition
+    // 시작하면 포트를 acquisition 스레드로 넘기고, 측정 함수들은 최신 샘플만 읽는다
+    bool startAcquisition(int channel, int periodMs);
+    void stopAcquisition();
+    bool isAcquiring() const { return acquisition_.isRunning(); }
+    void setPipelineDepth(int depth) { acquisition_.setPipelineDepth(depth); }
+    // VAC1/VAC2 명령 교대 발행. 켜 두면 measureAndDecide(1, ..) / (2, ..) 를 같은 주기에 번갈아 불러
+    // PAK/CHUCK 검사를 동시에 진행할 수 있다 (채널 전환 없음)
+    void setInterleavedChannels(bool enable) { acquisition_.setInterleaved(enable); }
+    // 0 = 포트별 스레드 (QSerialPort), 1 = 공용 epoll reactor (Linux). 다음 startAcquisition 부터 적용
+    bool setAcquisitionTransport(int transport);
+    bool latestSample(VacuumSample& out) const { return acquisition_.latest(out); }
+    int  drainSamples(VacuumSample* out, int maxCount) { return acquisition_.drain(out, maxCount); }
+    // drainSamples 와 같은 큐를 읽는다 (둘 중 하나만 사용). 판정 필드는 그 채널의 상태 snapshot (stateSnapshot(channel))
+    int  readSamples(VacuumSampleRecord* out, int maxCount);
+
+    // 공유 ring 생성 (이미 있으면 기존 것). 해제는 acquisition 이 멈춘 상태에서만 가능
+    bool createSharedRing(int capacity, VacuumSharedRingInfo& out);
+    bool destroySharedRing();
+
+    // 샘플당 round-trip latency
+    const LatencyHistogram& latencyHistogram() const { return rttHistogram_; }
+    void resetLatencyHistogram() { rttHistogram_.reset(); }
+
+    // 링크 카운터. snapshot 의 samplesPerSec 은 직전 metricsSnapshot 호출 이후 평균
+    const DeviceMetrics& metrics() const { return metrics_; }
+    void metricsSnapshot(VacuumMetricsSnapshot& out);
+    void resetMetrics();
+    // Prometheus label 용 (연결된 적 없으면 빈 문자열)
+    std::string metricsLabel() const;
+
+    // 이동 평균 창 크기 (5/10/20/50/100 샘플). 다음 측정 시작(counter == 1)부터 적용
+    bool setAveragingWindow(int channel, int window);
+    int  averagingWindow(int channel) const;
+
+    // 조기 판정: 압력 기울기 신뢰구간이 판정 범위 안/밖으로 확정되면 duration 전에 stop.
+    // minHoldSec 동안은 판정하지 않음. 다음 측정 시작(counter == 1)부터 적용
+    void setEarlyDecision(bool enable, int minHoldSec);
+
+    // 적응형 안정화: 압력이 안정되면 준비시간(STARTOFFSET)을 다 기다리지 않고 시작 평균 진입.
+    // 설정된 준비시간은 상한으로 유지. 다음 측정 시작부터 적용
+    void setAdaptiveSettling(bool enable);
+    // 마지막으로 measureAndDecide 를 부른 채널의 세션
+    void sessionReport(VacuumSessionReport& out) const;
+    void sessionReport(int channel, VacuumSessionReport& out) const;
+
+    // --- 샘플 DB 기록 (SampleRecorder::shared() 가 열려 있어야 함)
+    // 세션 id 반환 (실패 0). endRecording 의 lotid 로 samples.lotid 를 채운다
+    int64_t beginRecording(const std::string& station);
+    bool    endRecording(int64_t lotid);
+
+    // --- 세션 파형 파일 (.vwf). 열려 있던 파일은 닫고 새로 시작
+    bool    beginWaveform(const std::string& path);
+    // 기록한 샘플 수 (기록 중이 아니면 0, 쓰기 실패 -1)
+    int64_t endWaveform();
+
+    // --- 세션 압력 trace (start() 에서 비움). 차트 창 [fromUs, toUs] 를 최대 maxPoints 점으로
+    const SessionTrace& sessionTrace() const { return sessionTrace_; }
+
+    // Dart ReceivePort 로 이벤트 push (postFn = NativeApi.postCObject, port 0 = 해제)
+    void setEventPort(void* postFn, int64_t port) { eventPort_.attach(postFn, port); }
+
+    // --- calibration (측정 중에도 교체 가능)
+    bool loadCalibration(const std::string& path);
+    bool selectCalibration(int channel, const std::string& profile);
+    const CalibrationSet& calibration() const { return calibration_; }
+
     // 
     bool measureOnceInternal(int channel, float& outPressure);
     // channel: outPressure:, cnt:, 
@@ -79,25 +263,47 @@ public:
 
 
 private:
-    VacuumBackend();
-    ~VacuumBackend();
-
     VacuumBackend(const VacuumBackend&) = delete;
     VacuumBackend& operator=(const VacuumBackend&) = delete;
 
-    float averaging(float vacarr[], float val,  unsigned int *idx);
-    void clearAveraging(float vacarr1[], float vacarr2[], unsigned int *idx );
+    // acquisition 중이면 지난 호출 이후 샘플들의 평균 (없으면 최신 샘플), 아니면 직접 측정
+    bool acquirePressure(int channel, float& outPressure);
+
+    // 채널/모드 설정 -> 판정 엔진 설정
+    LeakTestConfig sessionConfig(int channel) const;
+
+    // 상태 snapshot 발행 (제어 스레드. writer 끼리만 stateWriteMutex_ 로 직렬화)
+    void publishState(int channel, float pressure, bool pass, const LeakTestResult* decision);
+    void publishConnection();
+    void storeState(VacuumStateSnapshot& s);
+
 
 private:
     // 
     std::vector<std::string> ports_;
 
-    // 
+    // device_/acquisition_ 가 참조하므로 먼저 선언 (나중에 소멸)
+    CalibrationSet   calibration_;
+    LatencyHistogram rttHistogram_;
+    DeviceMetrics    metrics_;
+    std::unique_ptr<SharedRing<VacuumSample>> sharedRing_;
+    VacuumEventPort  eventPort_;
+    std::shared_ptr<RecorderStream> recorderStream_ = std::make_shared<RecorderStream>();
+    WaveformWriter   waveform_;
+    SessionTrace     sessionTrace_;
     VacuumDevice device_;
+    VacuumAcquisition acquisition_;
+    AcquisitionTotals lastTotals_{};   // acquirePressure 가 마지막으로 읽은 누적값
 
     //
-    bool        connected_       = false;
+    std::atomic<bool> connected_{false};
     std::string currentPortName_;
+    mutable std::mutex portNameMutex_;   // lastPortName_ (metricsLabel 은 다른 스레드에서 호출)
+    std::string lastPortName_;      // 마지막으로 연결에 성공한 포트 (재연결 판단)
+
+    std::mutex    rateMutex_;       // metricsSnapshot 의 직전 값
+    std::uint64_t rateSamples_ = 0;
+    int64_t       rateNs_      = 0;
 
     // 
     int timeMode_    = 0;  // 1:
@@ -107,29 +313,36 @@ private:
     int configuredDuration_ = 0;   // 
     int elapsedSteps_       = 0;   // 
 
-    // 
-    float lastPressure_ = 0.0f;
-    bool  lastPass_     = true;
+    // 관찰 상태. reader 는 state_ 만 읽음 (lock 없음)
+    std::mutex                 stateWriteMutex_;
+    VacuumStateSnapshot        stateDraft_{};      // writer 쪽 마지막 값
+    Seqlock<VacuumStateSnapshot> state_;
+    Seqlock<VacuumStateSnapshot> channelState_[AcquisitionTotals::kChannels];
 
-    // 준비시간(STARTOFFSET) (초)
-    int vacStartOffsetSec_ = 25;
-    int chkStartOffsetSec_ = 7;
+    float minPress_ = kDefaultMinPress;
+    float minDiff_  = kDefaultMinDiff;
+
+    // 채널 -> 지그 종류, 지그 종류별 준비시간 (vacuum_fixture_policy.h). 준비시간만 table 값에서 변경 가능
+    std::array<int, kFixtureChannels> channelFixture_ = kDefaultChannelFixtures;
+    int startOffsetSec_[kMaxFixtureTypes] = {};
 
     int flag=0;
     int comflag=0;
     int rcvdflag = 0;
 
-    float startpress = 0.0;
-
-    float st_avgpress[MAXAVG] = {0.0, 0.0, 0.0, 0.0, 0.0};
-    float sp_avgpress[MAXAVG] = {0.0, 0.0, 0.0, 0.0, 0.0};
-
-    unsigned int stcnt=0;
-    unsigned int spcnt=0;
-    unsigned int *stcntPtr=&stcnt;
-    unsigned int *spcntPtr=&spcnt;
-
-    float stoppress=0.0;
-    float offsetpress = 0.0;
+    // 채널별 판정 상태 (그 채널 measureAndDecide 의 counter == 1 에서 reset)
+    struct ChannelSession {
+        LeakTestSession session;
+        bool earlyReported   = false;
+        bool settleReported  = false;
+        bool verdictReported = false;
+        LeakPhase reportedPhase = LeakPhase::Stabilizing;
+    };
+    ChannelSession sessions_[AcquisitionTotals::kChannels];   // index = channel (AcquisitionTotals::validChannel 확인 후)
+    int  lastChannel_     = 1;   // sessionReport(out) 대상
+    bool earlyDecision_   = false;
+    int  earlyMinHoldSec_ = 20;
+    bool adaptiveSettling_ = false;
+    int avgWindow_[4] = {MAXAVG, MAXAVG, MAXAVG, MAXAVG};   // index = channel
 
 };
@@ -2,7 +2,21 @@
 // vacuum_backend_api.cpp
 
 #include "vacuum_backend.h"
+#include "vacuum_calibration.h"
+#include "vacuum_lttb.h"
+#include "vacuum_metrics.h"
+#include "vacuum_replay.h"
+#include "vacuum_sample_recorder.h"
+#include "vacuum_trace.h"
+#include "vacuum_waveform_file.h"
+#include "vacuum_work_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
 #include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
 #include <QtCore/QDebug>
 
 #if defined(_WIN32)
@@ -11,6 +25,98 @@
   #define EXPORT __attribute__((visibility("default")))
 #endif
 
+// ───────────────────────────────────────
+//  Handle registry
+// ───────────────────────────────────────
+namespace {
+
+std::mutex                          g_handlesMutex;
+std::unordered_set<VacuumBackend*>  g_handles;
+
+VacuumBackend* toBackend(VacuumDeviceHandle* handle)
+{
+    VacuumBackend* backend = reinterpret_cast<VacuumBackend*>(handle);
+
+    std::lock_guard<std::mutex> lock(g_handlesMutex);
+    if (!backend || g_handles.find(backend) == g_handles.end()) {
+        qWarning() << "[C API] invalid device handle";
+        return nullptr;
+    }
+    return backend;
+}
+
+// vacuum_waveform_open 핸들. 채널 피라미드는 downsample 첫 호출 때 파일 전체를 한 번 디코딩해 만든다
+struct WaveformFileHandle {
+    WaveformReader reader;
+    std::mutex     mutex;
+    std::unique_ptr<LttbPyramid> pyramids[CalibrationSet::kChannels];
+
+    // 범위 밖 채널은 nullptr
+    const LttbPyramid* pyramid(int channel)
+    {
+        if (channel < 0 || channel >= CalibrationSet::kChannels)
+            return nullptr;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        std::unique_ptr<LttbPyramid>& p = pyramids[channel];
+        if (!p) {
+            p = std::make_unique<LttbPyramid>();
+            WaveformPoint points[WaveformWriter::kBlockSamples];
+            std::uint64_t first = 0;
+            std::size_t n;
+            while ((n = reader.read(first, points, WaveformWriter::kBlockSamples)) > 0) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    if (points[i].ok && points[i].channel == channel)
+                        p->append(points[i].timestampUs, points[i].pressure);
+                }
+                first += n;
+            }
+        }
+        return p.get();
+    }
+};
+
+WaveformFileHandle* toWaveform(VacuumWaveformHandle* handle)
+{
+    return reinterpret_cast<WaveformFileHandle*>(handle);
+}
+
+VacuumMeasureResult measureDecide(VacuumBackend& backend, int channel, int counter)
+{
+    VacuumMeasureResult result{};
+    float p = 0.0f;
+    float pSt = 0.0f;
+    float pSp = 0.0f;
+    float diff = 0.0f;
+    bool pass = false;
+    bool stop = false;
+
+    bool ok = backend.measureAndDecide(channel, counter, p, pSt, pSp, diff, pass, stop);
+
+    result.pressure      = p;
+    result.startPressure = pSt;
+    result.stopPressure  = pSp;
+    result.diffPressure  = diff;
+    result.pass          = pass ? 1 : 0;
+    result.stop          = stop ? 1 : 0;
+    result.ok            = ok ? 1 : 0;
+
+    return result;
+}
+
+void fillLatencyStats(const LatencyHistogram& h, VacuumLatencyStats* out)
+{
+    out->count  = h.count();
+    out->meanUs = h.mean();
+    out->minUs  = h.min();
+    out->p50Us  = h.percentile(0.50);
+    out->p90Us  = h.percentile(0.90);
+    out->p99Us  = h.percentile(0.99);
+    out->maxUs  = h.max();
+}
+
+} // namespace
+
 extern "C" {
 
 EXPORT void vacuum_init()
@@ -47,6 +153,7 @@ EXPORT void vacuum_step()
 }
 
 
+// 아래 조회 함수들은 상태 snapshot (seqlock) 을 읽으므로 다른 isolate/스레드에서 호출해도 안전
 EXPORT float vacuum_get_last_pressure()
 {
     return VacuumBackend::instance().lastPressure();
@@ -71,7 +178,22 @@ EXPORT void vacuum_disconnect()
 
 EXPORT int vacuum_is_connected()
 {
-    return VacuumBackend::instance().isConnected() ? 1 : 0;
+    VacuumStateSnapshot s;
+    VacuumBackend::instance().stateSnapshot(s);
+    return s.connected;
+}
+
+// 압력/판정/phase/연결 상태를 한 번에 (서로 일관된 값). handle == NULL 이면 기존 단일 인스턴스.
+// channel 0 = 마지막으로 측정한 채널, 1/2 = 그 채널의 마지막 측정 (아직 없으면 0 반환)
+EXPORT int vacuum_get_state(VacuumDeviceHandle* handle, int channel, VacuumStateSnapshot* out)
+{
+    VacuumBackend* b = handle ? toBackend(handle) : &VacuumBackend::instance();
+    if (!b || !out) return 0;
+    if (channel == 0) {
+        b->stateSnapshot(*out);
+        return 1;
+    }
+    return b->stateSnapshot(channel, *out) ? 1 : 0;
 }
 
 EXPORT int vacuum_list_ports(char* buffer, int bufferSize)
@@ -103,6 +225,186 @@ EXPORT int vacuum_list_ports(char* buffer, int bufferSize)
     return count;
 }
 
+// ───── background acquisition ─────
+// periodMs 주기로 별도 스레드에서 측정. 이후 측정 함수들은 I/O 없이 최신 샘플만 읽음
+EXPORT int vacuum_acquisition_start(int channel, int periodMs)
+{
+    return VacuumBackend::instance().startAcquisition(channel, periodMs) ? 1 : 0;
+}
+
+EXPORT void vacuum_acquisition_stop()
+{
+    VacuumBackend::instance().stopAcquisition();
+}
+
+// depth >= 2 이면 VAC 명령을 depth 개까지 응답 대기 없이 미리 전송 (pipelined)
+// 예: depth 4, periodMs 50 -> 20 Hz
+EXPORT void vacuum_acquisition_set_pipeline_depth(int depth)
+{
+    VacuumBackend::instance().setPipelineDepth(depth);
+}
+
+// enable=1 이면 VAC1/VAC2 명령을 번갈아 전송. PAK(1)/CHUCK(2) 를 각각 measure_decide 해서 동시 검사
+// (채널당 샘플 주기 = periodMs * 2). 켜져 있는 동안 pipeline depth 는 1 로 고정
+EXPORT void vacuum_acquisition_set_interleaved(int enable)
+{
+    VacuumBackend::instance().setInterleavedChannels(enable != 0);
+}
+
+// 0 = 포트별 acquisition 스레드, 1 = 공용 epoll reactor (Linux 빌드만). 지원 안 하면 0 반환
+EXPORT int vacuum_acquisition_set_transport(int transport)
+{
+    return VacuumBackend::instance().setAcquisitionTransport(transport) ? 1 : 0;
+}
+
+// 1 = 샘플 있음, 0 = 아직 없음
+EXPORT int vacuum_acquisition_latest(VacuumSample* out)
+{
+    if (!out) return 0;
+    return VacuumBackend::instance().latestSample(*out) ? 1 : 0;
+}
+
+// 지난 호출 이후 쌓인 샘플 수 반환
+EXPORT int vacuum_acquisition_drain(VacuumSample* out, int maxCount)
+{
+    return VacuumBackend::instance().drainSamples(out, maxCount);
+}
+
+// ───── round-trip latency ─────
+EXPORT int vacuum_get_latency_stats(VacuumLatencyStats* out)
+{
+    if (!out) return 0;
+    fillLatencyStats(VacuumBackend::instance().latencyHistogram(), out);
+    return 1;
+}
+
+EXPORT void vacuum_reset_latency_stats()
+{
+    VacuumBackend::instance().resetLatencyHistogram();
+}
+
+// ───── 링크 metrics ─────
+EXPORT int vacuum_get_metrics(VacuumMetricsSnapshot* out)
+{
+    if (!out) return 0;
+    VacuumBackend::instance().metricsSnapshot(*out);
+    return 1;
+}
+
+// 카운터와 latency histogram 모두 초기화
+EXPORT void vacuum_reset_metrics()
+{
+    VacuumBackend::instance().resetMetrics();
+}
+
+// 기존 단일 인스턴스 + 열린 핸들 전체를 Prometheus text format 으로 기록 (label device=포트)
+EXPORT int vacuum_metrics_write_prometheus(const char* path)
+{
+    if (!path) return 0;
+
+    VacuumBackend& legacy = VacuumBackend::instance();
+    std::vector<MetricsSource> sources;
+    {
+        // 핸들이 닫히지 않도록 lock 안에서는 값만 복사. 파일 쓰기는 lock 밖 (vacuum_dev_* 를 막지 않게)
+        std::lock_guard<std::mutex> lock(g_handlesMutex);
+        sources.reserve(g_handles.size() + 1);
+        sources.push_back(snapshotMetrics(legacy.metricsLabel().empty() ? "default" : legacy.metricsLabel(),
+                                          legacy.metrics(), &legacy.latencyHistogram()));
+        int unnamed = 0;
+        for (VacuumBackend* b : g_handles) {
+            std::string label = b->metricsLabel();
+            if (label.empty())
+                label = "unconnected-" + std::to_string(unnamed++);
+            sources.push_back(snapshotMetrics(std::move(label), b->metrics(), &b->latencyHistogram()));
+        }
+    }
+
+    std::string error;
+    const bool ok = writePrometheusFile(path, sources, &error);
+
+    if (!ok)
+        qWarning() << "[C API] vacuum_metrics_write_prometheus:" << QString::fromStdString(error);
+    return ok ? 1 : 0;
+}
+
+// ───── 이동 평균 창 크기 ─────
+// window: 5 / 10 / 20 / 50 / 100 샘플. 다음 측정 시작부터 적용. 지원하지 않으면 0
+EXPORT int vacuum_set_avg_window(int channel, int window)
+{
+    return VacuumBackend::instance().setAveragingWindow(channel, window) ? 1 : 0;
+}
+
+// ───── 채널별 지그 종류 ─────
+// fixtureId: 1 = PAK, 2 = CHUCK (vacuum_fixture_policy.h). channel 은 1/2 만. 다음 측정 시작부터 적용. 실패 시 0
+EXPORT int vacuum_set_channel_fixture(int channel, int fixtureId)
+{
+    return VacuumBackend::instance().setChannelFixture(channel, fixtureId) ? 1 : 0;
+}
+
+// ───── 조기 판정 ─────
+// enable=1 이면 minHoldSec 이후 판정이 확정되는 즉시 stop=1 (duration 모드에서만)
+EXPORT void vacuum_set_early_decision(int enable, int minHoldSec)
+{
+    VacuumBackend::instance().setEarlyDecision(enable != 0, minHoldSec);
+}
+
+// ───── 적응형 안정화 ─────
+EXPORT void vacuum_set_adaptive_settling(int enable)
+{
+    VacuumBackend::instance().setAdaptiveSettling(enable != 0);
+}
+
+EXPORT int vacuum_get_session_report(VacuumSessionReport* out)
+{
+    if (!out) return 0;
+    VacuumBackend::instance().sessionReport(*out);
+    return 1;
+}
+
+// 채널별 세션 (interleave 로 두 채널을 동시에 검사할 때)
+EXPORT int vacuum_get_channel_session_report(int channel, VacuumSessionReport* out)
+{
+    if (!out) return 0;
+    VacuumBackend::instance().sessionReport(channel, *out);
+    return 1;
+}
+
+// ───── calibration profile ─────
+// 파일 형식은 vacuum_calibration.h 참고. 측정 중에도 호출 가능 (다음 샘플부터 적용)
+EXPORT int vacuum_load_calibration(const char* path)
+{
+    if (!path) return 0;
+    return VacuumBackend::instance().loadCalibration(path) ? 1 : 0;
+}
+
+// profile: "DEFAULT", "CHUCK", "PAK" 또는 파일에서 읽은 이름
+EXPORT int vacuum_select_calibration(int channel, const char* profile)
+{
+    if (!profile) return 0;
+    return VacuumBackend::instance().selectCalibration(channel, profile) ? 1 : 0;
+}
+
+// ───── ADC -> kPa 변환 (replay / 분석용) ─────
+EXPORT float vacuum_convert_raw(int raw)
+{
+    return kDefaultCalibration.convert(raw);
+}
+
+// channel 의 현재 보정 테이블 사용 (0 = 기본 테이블)
+EXPORT float vacuum_convert_raw_channel(int channel, int raw)
+{
+    if (channel <= 0) return kDefaultCalibration.convert(raw);
+    return VacuumBackend::instance().calibration().convert(channel, raw);
+}
+
+// raw[0..count) 를 out[0..count) 로 일괄 변환, 변환한 개수 반환
+EXPORT int vacuum_convert_raw_batch(const uint8_t* raw, float* out, int count)
+{
+    if (!raw || !out || count <= 0) return 0;
+    kDefaultCalibration.convertBatch(raw, out, static_cast<std::size_t>(count));
+    return count;
+}
+
 EXPORT float vacuum_debug_measure_once(int channel)
 {
     float p = 0.0f;
@@ -146,34 +448,458 @@ EXPORT float vacuum_debug_measure_once2(int channel, int cnt)
 
 EXPORT VacuumMeasureResult vacuum_measure_decide(int channel, int counter)
 {
-    VacuumMeasureResult result{};
-    float p = 0.0f;
-    float pSt = 0.0f;
-    float pSp = 0.0f;
-    float diff = 0.0f;
-    bool pass = false;
-    bool stop = false;
+    return measureDecide(VacuumBackend::instance(), channel, counter);
+}
 
-    bool ok = VacuumBackend::instance().measureAndDecide(
-        channel,
-        counter,
-        p,
-        pSt,
-        pSp,
-        diff,
-        pass,
-        stop
-    );
+// ───────────────────────────────────────
+//  Handle API : 장비(포트)마다 독립된 backend
+// ───────────────────────────────────────
 
-    result.pressure      = p;
-    result.startPressure = pSt;
-    result.stopPressure  = pSp;
-    result.diffPressure  = diff;
-    result.pass          = pass ? 1 : 0;
-    result.stop          = stop ? 1 : 0;
-    result.ok            = ok ? 1 : 0;
+// 실패 시 nullptr
+EXPORT VacuumDeviceHandle* vacuum_open(const char* portName)
+{
+    VacuumBackend* backend = new VacuumBackend();
+    if (!backend->connectToPort(portName)) {
+        delete backend;
+        return nullptr;
+    }
 
-    return result;
+    {
+        std::lock_guard<std::mutex> lock(g_handlesMutex);
+        g_handles.insert(backend);
+    }
+    return reinterpret_cast<VacuumDeviceHandle*>(backend);
+}
+
+// 다른 스레드에서 아직 사용 중인 핸들은 닫지 말 것
+EXPORT void vacuum_close(VacuumDeviceHandle* handle)
+{
+    VacuumBackend* backend = reinterpret_cast<VacuumBackend*>(handle);
+    {
+        std::lock_guard<std::mutex> lock(g_handlesMutex);
+        if (g_handles.erase(backend) == 0)
+            return;
+    }
+    delete backend;   // disconnect + acquisition stop
+}
+
+EXPORT int vacuum_open_count()
+{
+    std::lock_guard<std::mutex> lock(g_handlesMutex);
+    return static_cast<int>(g_handles.size());
+}
+
+EXPORT int vacuum_dev_is_connected(VacuumDeviceHandle* handle)
+{
+    VacuumBackend* b = toBackend(handle);
+    if (!b) return 0;
+    VacuumStateSnapshot s;
+    b->stateSnapshot(s);
+    return s.connected;
+}
+
+EXPORT void vacuum_dev_set_time_mode(VacuumDeviceHandle* handle, int mode)
+{
+    if (VacuumBackend* b = toBackend(handle)) b->setTimeMode(mode);
+}
+
+EXPORT void vacuum_dev_set_pressure_mode(VacuumDeviceHandle* handle, int kpa)
+{
+    if (VacuumBackend* b = toBackend(handle)) b->setPressureMode(kpa);
+}
+
+EXPORT void vacuum_dev_set_vac_start_offset(VacuumDeviceHandle* handle, int seconds)
+{
+    if (VacuumBackend* b = toBackend(handle)) b->setVacStartOffsetSec(seconds);
+}
+
+EXPORT void vacuum_dev_set_thresholds(VacuumDeviceHandle* handle, float minPress, float minDiff)
+{
+    if (VacuumBackend* b = toBackend(handle)) b->setThresholds(minPress, minDiff);
+}
+
+EXPORT VacuumMeasureResult vacuum_dev_measure_decide(VacuumDeviceHandle* handle, int channel, int counter)
+{
+    VacuumBackend* b = toBackend(handle);
+    if (!b) return VacuumMeasureResult{};
+    return measureDecide(*b, channel, counter);
+}
+
+EXPORT float vacuum_dev_get_last_pressure(VacuumDeviceHandle* handle)
+{
+    VacuumBackend* b = toBackend(handle);
+    return b ? b->lastPressure() : 0.0f;
+}
+
+EXPORT int vacuum_dev_acquisition_start(VacuumDeviceHandle* handle, int channel, int periodMs)
+{
+    VacuumBackend* b = toBackend(handle);
+    return (b && b->startAcquisition(channel, periodMs)) ? 1 : 0;
+}
+
+EXPORT void vacuum_dev_acquisition_stop(VacuumDeviceHandle* handle)
+{
+    if (VacuumBackend* b = toBackend(handle)) b->stopAcquisition();
+}
+
+EXPORT void vacuum_dev_acquisition_set_pipeline_depth(VacuumDeviceHandle* handle, int depth)
+{
+    if (VacuumBackend* b = toBackend(handle)) b->setPipelineDepth(depth);
+}
+
+EXPORT void vacuum_dev_acquisition_set_interleaved(VacuumDeviceHandle* handle, int enable)
+{
+    if (VacuumBackend* b = toBackend(handle)) b->setInterleavedChannels(enable != 0);
+}
+
+EXPORT int vacuum_dev_acquisition_set_transport(VacuumDeviceHandle* handle, int transport)
+{
+    VacuumBackend* b = toBackend(handle);
+    return (b && b->setAcquisitionTransport(transport)) ? 1 : 0;
+}
+
+EXPORT int vacuum_dev_acquisition_latest(VacuumDeviceHandle* handle, VacuumSample* out)
+{
+    VacuumBackend* b = toBackend(handle);
+    if (!b || !out) return 0;
+    return b->latestSample(*out) ? 1 : 0;
+}
+
+EXPORT int vacuum_dev_acquisition_drain(VacuumDeviceHandle* handle, VacuumSample* out, int maxCount)
+{
+    VacuumBackend* b = toBackend(handle);
+    return b ? b->drainSamples(out, maxCount) : 0;
+}
+
+EXPORT int vacuum_dev_get_latency_stats(VacuumDeviceHandle* handle, VacuumLatencyStats* out)
+{
+    VacuumBackend* b = toBackend(handle);
+    if (!b || !out) return 0;
+    fillLatencyStats(b->latencyHistogram(), out);
+    return 1;
+}
+
+EXPORT int vacuum_dev_get_metrics(VacuumDeviceHandle* handle, VacuumMetricsSnapshot* out)
+{
+    VacuumBackend* b = toBackend(handle);
+    if (!b || !out) return 0;
+    b->metricsSnapshot(*out);
+    return 1;
+}
+
+EXPORT void vacuum_dev_reset_metrics(VacuumDeviceHandle* handle)
+{
+    VacuumBackend* b = toBackend(handle);
+    if (!b) return;
+    b->resetMetrics();
+}
+
+EXPORT int vacuum_dev_set_avg_window(VacuumDeviceHandle* handle, int channel, int window)
+{
+    VacuumBackend* b = toBackend(handle);
+    if (!b) return 0;
+    return b->setAveragingWindow(channel, window) ? 1 : 0;
+}
+
+EXPORT int vacuum_dev_set_channel_fixture(VacuumDeviceHandle* handle, int channel, int fixtureId)
+{
+    VacuumBackend* b = toBackend(handle);
+    if (!b) return 0;
+    return b->setChannelFixture(channel, fixtureId) ? 1 : 0;
+}
+
+EXPORT void vacuum_dev_set_early_decision(VacuumDeviceHandle* handle, int enable, int minHoldSec)
+{
+    VacuumBackend* b = toBackend(handle);
+    if (!b) return;
+    b->setEarlyDecision(enable != 0, minHoldSec);
+}
+
+// 지난 호출 이후 수집된 샘플을 buf[0..max) 에 복사, 복사한 개수 반환.
+// handle == NULL 이면 기존 단일 인스턴스. vacuum_acquisition_drain 과 같은 큐를 소비한다
+EXPORT int vacuum_read_samples(VacuumDeviceHandle* handle, VacuumSampleRecord* buf, int max)
+{
+    if (!buf || max <= 0) return 0;
+    VacuumBackend* b = handle ? toBackend(handle) : &VacuumBackend::instance();
+    if (!b) return 0;
+    return b->readSamples(buf, max);
+}
+
+// ───── 공유 메모리 ring (zero-copy) ─────
+// handle == NULL 이면 기존 단일 인스턴스. capacity 는 2 의 거듭제곱으로 올림
+EXPORT int vacuum_shared_ring_create(VacuumDeviceHandle* handle, int capacity, VacuumSharedRingInfo* out)
+{
+    if (!out) return 0;
+    VacuumBackend* b = handle ? toBackend(handle) : &VacuumBackend::instance();
+    if (!b) return 0;
+    return b->createSharedRing(capacity, *out) ? 1 : 0;
+}
+
+// acquisition 이 멈춘 상태에서만 해제. 이후 info 포인터는 사용 금지
+EXPORT int vacuum_shared_ring_destroy(VacuumDeviceHandle* handle)
+{
+    VacuumBackend* b = handle ? toBackend(handle) : &VacuumBackend::instance();
+    if (!b) return 0;
+    return b->destroySharedRing() ? 1 : 0;
+}
+
+// Dart 에는 atomic load/store 가 없으므로 index 접근용 (leaf call, 배치당 1~2 회)
+EXPORT uint64_t vacuum_ring_acquire_load(const uint64_t* word)
+{
+    return reinterpret_cast<const std::atomic<uint64_t>*>(word)->load(std::memory_order_acquire);
+}
+
+EXPORT void vacuum_ring_release_store(uint64_t* word, uint64_t value)
+{
+    reinterpret_cast<std::atomic<uint64_t>*>(word)->store(value, std::memory_order_release);
+}
+
+// ───── 샘플 DB recorder ─────
+// 모든 장비가 공유하는 writer. path = vacuums.db (WAL 로 전환됨)
+EXPORT int vacuum_recorder_open(const char* path)
+{
+    if (!path) return 0;
+    return SampleRecorder::shared().open(path) ? 1 : 0;
+}
+
+// 남은 샘플을 기록하고 writer 종료
+EXPORT void vacuum_recorder_close()
+{
+    SampleRecorder::shared().close();
+}
+
+// handle == NULL 이면 기존 단일 인스턴스. station 이 NULL/빈 문자열이면 포트 이름. 세션 id 반환 (실패 0)
+EXPORT int64_t vacuum_recorder_begin(VacuumDeviceHandle* handle, const char* station)
+{
+    VacuumBackend* b = handle ? toBackend(handle) : &VacuumBackend::instance();
+    if (!b) return 0;
+    return b->beginRecording(station ? station : "");
+}
+
+// lotid = vacuums 행의 lotid (Dart insert 결과). 0 이면 lotid 없이 종료
+EXPORT int vacuum_recorder_end(VacuumDeviceHandle* handle, int64_t lotid)
+{
+    VacuumBackend* b = handle ? toBackend(handle) : &VacuumBackend::instance();
+    if (!b) return 0;
+    return b->endRecording(lotid) ? 1 : 0;
+}
+
+// ───── 세션 압력 trace (차트) ─────
+// handle == NULL 이면 기존 단일 인스턴스. 채널 trace 의 샘플 수, first/last 는 steady clock us (NULL 가능)
+EXPORT int64_t vacuum_session_trace_range(VacuumDeviceHandle* handle, int channel, int64_t* firstUs, int64_t* lastUs)
+{
+    VacuumBackend* b = handle ? toBackend(handle) : &VacuumBackend::instance();
+    if (!b) return 0;
+    const LttbPyramid* trace = b->sessionTrace().channel(channel);
+    int64_t first = 0, last = 0;
+    if (!trace || !trace->range(first, last))
+        return 0;
+    if (firstUs) *firstUs = first;
+    if (lastUs)  *lastUs  = last;
+    return static_cast<int64_t>(trace->size());
+}
+
+// 채널의 [fromUs, toUs] 를 LTTB 로 최대 maxPoints 점 (maxPoints >= 3). 출력 개수 반환
+EXPORT int vacuum_session_trace_downsample(VacuumDeviceHandle* handle, int channel, int64_t fromUs, int64_t toUs,
+                                           int maxPoints, int64_t* outUs, float* outPressure)
+{
+    VacuumBackend* b = handle ? toBackend(handle) : &VacuumBackend::instance();
+    if (!b || maxPoints <= 0) return 0;
+    const LttbPyramid* trace = b->sessionTrace().channel(channel);
+    if (!trace) return 0;
+    return static_cast<int>(trace->query(fromUs, toUs, static_cast<std::size_t>(maxPoints), outUs, outPressure));
+}
+
+// ───── 세션 파형 파일 (.vwf) ─────
+// handle == NULL 이면 기존 단일 인스턴스. 이후 발행되는 모든 샘플을 path 에 기록
+EXPORT int vacuum_waveform_begin(VacuumDeviceHandle* handle, const char* path)
+{
+    VacuumBackend* b = handle ? toBackend(handle) : &VacuumBackend::instance();
+    if (!b || !path) return 0;
+    return b->beginWaveform(path) ? 1 : 0;
+}
+
+// index footer 를 쓰고 닫음. 기록한 샘플 수 (기록 중이 아니면 0, 쓰기 실패 -1)
+EXPORT int64_t vacuum_waveform_end(VacuumDeviceHandle* handle)
+{
+    VacuumBackend* b = handle ? toBackend(handle) : &VacuumBackend::instance();
+    if (!b) return 0;
+    return b->endWaveform();
+}
+
+// 파일을 mmap 으로 연다 (기록 중단된 파일도 가능). 실패 시 NULL
+EXPORT VacuumWaveformHandle* vacuum_waveform_open(const char* path)
+{
+    if (!path) return nullptr;
+    auto* file = new WaveformFileHandle();
+    std::string error;
+    if (!file->reader.open(path, &error)) {
+        qWarning() << "[C API] vacuum_waveform_open:" << QString::fromStdString(error);
+        delete file;
+        return nullptr;
+    }
+    return reinterpret_cast<VacuumWaveformHandle*>(file);
+}
+
+EXPORT void vacuum_waveform_close(VacuumWaveformHandle* handle)
+{
+    delete toWaveform(handle);
+}
+
+EXPORT int64_t vacuum_waveform_count(VacuumWaveformHandle* handle)
+{
+    if (!handle) return 0;
+    return static_cast<int64_t>(toWaveform(handle)->reader.sampleCount());
+}
+
+// timestampUs >= fromUs 인 첫 샘플 index (시각은 기록 시작 기준이 아닌 steady clock us)
+EXPORT int64_t vacuum_waveform_lower_bound(VacuumWaveformHandle* handle, int64_t fromUs)
+{
+    if (!handle) return 0;
+    return static_cast<int64_t>(toWaveform(handle)->reader.lowerBound(fromUs));
+}
+
+// 채널의 [fromUs, toUs] 를 LTTB 로 최대 maxPoints 점 (maxPoints >= 3). 첫 호출 때 채널 피라미드를 만든다
+EXPORT int vacuum_waveform_downsample(VacuumWaveformHandle* handle, int channel, int64_t fromUs, int64_t toUs,
+                                      int maxPoints, int64_t* outUs, float* outPressure)
+{
+    if (!handle || maxPoints <= 0) return 0;
+    const LttbPyramid* pyramid = toWaveform(handle)->pyramid(channel);
+    if (!pyramid) return 0;
+    return static_cast<int>(pyramid->query(fromUs, toUs, static_cast<std::size_t>(maxPoints), outUs, outPressure));
+}
+
+// first 번째 샘플부터 최대 maxCount 개를 컬럼 배열로 디코딩. 필요 없는 배열은 NULL. 디코딩한 개수 반환
+EXPORT int vacuum_waveform_read(VacuumWaveformHandle* handle, int64_t first, int64_t* timestampUs,
+                                float* pressure, uint8_t* raw, uint8_t* channel, uint8_t* ok, int maxCount)
+{
+    if (!handle || first < 0 || maxCount <= 0) return 0;
+    const WaveformReader* reader = &toWaveform(handle)->reader;
+
+    WaveformPoint points[WaveformWriter::kBlockSamples];
+    int total = 0;
+    while (total < maxCount) {
+        const std::size_t want = std::min<std::size_t>(WaveformWriter::kBlockSamples, maxCount - total);
+        const std::size_t n = reader->read(static_cast<std::uint64_t>(first) + total, points, want);
+        for (std::size_t i = 0; i < n; ++i) {
+            const WaveformPoint& p = points[i];
+            if (timestampUs) timestampUs[total + i] = p.timestampUs;
+            if (pressure)    pressure[total + i]    = p.pressure;
+            if (raw)         raw[total + i]         = p.raw;
+            if (channel)     channel[total + i]     = p.channel;
+            if (ok)          ok[total + i]          = p.ok;
+        }
+        total += static_cast<int>(n);
+        if (n < want)
+            break;
+    }
+    return total;
+}
+
+// ───── 과거 검사 재채점 ─────
+// 현재 backend 기본 판정 파라미터
+EXPORT void vacuum_replay_default_params(VacuumReplayParams* out)
+{
+    if (out) *out = defaultReplayParams();
+}
+
+// dbPath 의 lotid 연결된 세션 샘플을 params 로 다시 판정해 기록 판정과 비교 (sinceDate "yyyy-MM-dd", NULL = 전체).
+// diffCsvPath 가 NULL 이 아니면 판정이 바뀐 lot 목록을 CSV 로. threads <= 0 = 모든 코어. 1=성공
+EXPORT int vacuum_replay_rescore(const char* dbPath, const char* sinceDate, const VacuumReplayParams* params,
+                                 int threads, const char* diffCsvPath, VacuumReplaySummary* out)
+{
+    if (!dbPath || !params || !out) return 0;
+
+    ReplayCorpus corpus;
+    std::string error;
+    if (!corpus.loadDatabase(dbPath, sinceDate ? sinceDate : "", &error)) {
+        qWarning() << "[C API] vacuum_replay_rescore:" << QString::fromStdString(error);
+        return 0;
+    }
+
+    std::vector<ReplayDiff> diffs;
+    *out = rescoreCorpus(corpus, defaultReplayParams(), *params, WorkStealingPool(threads),
+                         diffCsvPath ? &diffs : nullptr);
+
+    if (diffCsvPath) {
+        std::FILE* f = std::fopen(diffCsvPath, "w");
+        if (!f) {
+            qWarning() << "[C API] vacuum_replay_rescore: cannot create" << diffCsvPath;
+            return 0;
+        }
+        writeReplayDiffCsv(f, diffs);   // vacuum_rescore --diff-csv 와 같은 컬럼
+        std::fclose(f);
+    }
+    return 1;
+}
+
+// ───── binary trace log ─────
+// level: 0=Debug, 1=Info, 2=Warn, 3=Off. VACUUM_TRACE_MIN_LEVEL 미만은 빌드에서 제거됨
+EXPORT void vacuum_trace_set_level(int level)
+{
+    if (level < 0) level = 0;
+    if (level > 3) level = 3;
+    TraceLog::setLevel(static_cast<TraceLevel>(level));
+}
+
+// 모든 스레드의 trace ring 을 파일로 기록 (vacuum_trace_decode 로 해석). 1=성공
+EXPORT int vacuum_trace_dump(const char* path)
+{
+    if (!path) return 0;
+    std::string error;
+    if (!TraceLog::dump(path, &error)) {
+        qWarning() << "[C API] vacuum_trace_dump:" << QString::fromStdString(error);
+        return 0;
+    }
+    return 1;
+}
+
+// ───── 이벤트 push (Dart native port) ─────
+// postCObject = NativeApi.postCObject, port = ReceivePort.sendPort.nativePort (0 = 해제).
+// handle == NULL 이면 기존 단일 인스턴스. 메시지 인코딩은 vacuum_event_port.h 참고
+EXPORT int vacuum_set_event_port(VacuumDeviceHandle* handle, void* postCObject, int64_t port)
+{
+    VacuumBackend* b = handle ? toBackend(handle) : &VacuumBackend::instance();
+    if (!b) return 0;
+    b->setEventPort(postCObject, port);
+    return 1;
+}
+
+EXPORT void vacuum_dev_set_adaptive_settling(VacuumDeviceHandle* handle, int enable)
+{
+    VacuumBackend* b = toBackend(handle);
+    if (!b) return;
+    b->setAdaptiveSettling(enable != 0);
+}
+
+EXPORT int vacuum_dev_get_session_report(VacuumDeviceHandle* handle, VacuumSessionReport* out)
+{
+    VacuumBackend* b = toBackend(handle);
+    if (!b || !out) return 0;
+    b->sessionReport(*out);
+    return 1;
+}
+
+EXPORT int vacuum_dev_get_channel_session_report(VacuumDeviceHandle* handle, int channel, VacuumSessionReport* out)
+{
+    VacuumBackend* b = toBackend(handle);
+    if (!b || !out) return 0;
+    b->sessionReport(channel, *out);
+    return 1;
+}
+
+EXPORT int vacuum_dev_load_calibration(VacuumDeviceHandle* handle, const char* path)
+{
+    VacuumBackend* b = toBackend(handle);
+    if (!b || !path) return 0;
+    return b->loadCalibration(path) ? 1 : 0;
+}
+
+EXPORT int vacuum_dev_select_calibration(VacuumDeviceHandle* handle, int channel, const char* profile)
+{
+    VacuumBackend* b = toBackend(handle);
+    if (!b || !profile) return 0;
+    return b->selectCalibration(channel, profile) ? 1 : 0;
 }
 
 } // extern "C"
@@ -0,0 +1,238 @@
+// vacuum_calibration.cpp
+
+#include "vacuum_calibration.h"
+
+#include <cctype>
+#include <fstream>
+#include <sstream>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+bool CalibrationLut::build(const std::vector<CalibrationPoint>& points, CalibrationLut& out,
+                           std::string* error)
+{
+    if (points.size() < 2) {
+        if (error) *error = "at least 2 calibration points required";
+        return false;
+    }
+
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        if (points[i].adc < 0 || points[i].adc > kSize - 1) {
+            if (error) *error = "adc out of range: " + std::to_string(points[i].adc);
+            return false;
+        }
+        if (i > 0 && points[i].adc <= points[i - 1].adc) {
+            if (error) *error = "adc must be strictly ascending at point " + std::to_string(i);
+            return false;
+        }
+    }
+
+    out = fromPoints(points.data(), points.size());
+    return true;
+}
+
+void CalibrationLut::convertBatch(const std::uint8_t* raw, float* out, std::size_t count) const
+{
+    std::size_t i = 0;
+
+#if defined(__AVX2__)
+    // 8개씩 byte -> int32 확장 후 gather
+    for (; i + 8 <= count; i += 8) {
+        const __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(raw + i));
+        const __m256i idx   = _mm256_cvtepu8_epi32(bytes);
+        _mm256_storeu_ps(out + i, _mm256_i32gather_ps(table_, idx, 4));
+    }
+#endif
+
+    for (; i + 4 <= count; i += 4) {
+        out[i]     = table_[raw[i]];
+        out[i + 1] = table_[raw[i + 1]];
+        out[i + 2] = table_[raw[i + 2]];
+        out[i + 3] = table_[raw[i + 3]];
+    }
+    for (; i < count; ++i)
+        out[i] = table_[raw[i]];
+}
+
+// ───────────────────────────────────────
+//  CalibrationSet
+// ───────────────────────────────────────
+CalibrationSet::CalibrationSet()
+{
+    profiles_["DEFAULT"] = &kDefaultCalibration;
+    profiles_["CHUCK"]   = &kDefaultCalibration;
+    profiles_["PAK"]     = &kPakCalibration;
+
+    for (int ch = 0; ch < kChannels; ++ch) {
+        active_[ch].store(&kDefaultCalibration, std::memory_order_relaxed);
+        names_[ch] = "DEFAULT";
+    }
+}
+
+const CalibrationLut* CalibrationSet::store(const CalibrationLut& lut)
+{
+    owned_.emplace_back(new CalibrationLut(lut));
+    return owned_.back().get();
+}
+
+void CalibrationSet::publish(int channel, const CalibrationLut* lut, const std::string& name)
+{
+    // 호출하는 쪽에서 범위 확인 완료
+    names_[channel] = name;
+    active_[channel].store(lut, std::memory_order_release);
+}
+
+std::string CalibrationSet::profileName(int channel) const
+{
+    if (channel < 0 || channel >= kChannels)
+        return "DEFAULT";
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    return names_[channel];
+}
+
+bool CalibrationSet::selectProfile(int channel, const std::string& name)
+{
+    if (channel < 0 || channel >= kChannels)
+        return false;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = profiles_.find(name);
+    if (it == profiles_.end())
+        return false;
+
+    publish(channel, it->second, name);
+    return true;
+}
+
+bool CalibrationSet::addProfile(const std::string& name, const std::vector<CalibrationPoint>& points,
+                                std::string* error)
+{
+    CalibrationLut lut;
+    if (!CalibrationLut::build(points, lut, error))
+        return false;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const CalibrationLut* stored = store(lut);
+    profiles_[name] = stored;
+
+    for (int ch = 0; ch < kChannels; ++ch) {
+        if (names_[ch] == name)
+            publish(ch, stored, name);
+    }
+    return true;
+}
+
+namespace {
+
+std::string trim(const std::string& s)
+{
+    std::size_t b = 0, e = s.size();
+    while (b < e && std::isspace(static_cast<unsigned char>(s[b]))) ++b;
+    while (e > b && std::isspace(static_cast<unsigned char>(s[e - 1]))) --e;
+    return s.substr(b, e - b);
+}
+
+} // namespace
+
+bool CalibrationSet::loadFile(const std::string& path, std::string* error)
+{
+    std::ifstream in(path);
+    if (!in) {
+        if (error) *error = "cannot open " + path;
+        return false;
+    }
+
+    std::map<std::string, std::vector<CalibrationPoint>> points;
+    std::map<int, std::string>                           channels;
+
+    enum class Section { None, Profile, Channels } section = Section::None;
+    std::string profile;
+    std::string line;
+    int lineNo = 0;
+
+    while (std::getline(in, line)) {
+        ++lineNo;
+        const std::size_t hash = line.find('#');
+        if (hash != std::string::npos)
+            line.erase(hash);
+        line = trim(line);
+        if (line.empty())
+            continue;
+
+        const std::string where = path + ":" + std::to_string(lineNo);
+
+        if (line.front() == '[' && line.back() == ']') {
+            const std::string head = trim(line.substr(1, line.size() - 2));
+            if (head == "channels") {
+                section = Section::Channels;
+            } else if (head.compare(0, 8, "profile ") == 0) {
+                section = Section::Profile;
+                profile = trim(head.substr(8));
+                points[profile].clear();
+            } else {
+                if (error) *error = where + ": unknown section [" + head + "]";
+                return false;
+            }
+            continue;
+        }
+
+        if (section == Section::Profile) {
+            std::istringstream ss(line);
+            CalibrationPoint pt{};
+            if (!(ss >> pt.adc >> pt.kpa)) {
+                if (error) *error = where + ": expected '<adc> <kpa>'";
+                return false;
+            }
+            points[profile].push_back(pt);
+        } else if (section == Section::Channels) {
+            const std::size_t eq = line.find('=');
+            int ch = -1;
+            if (eq != std::string::npos) {
+                std::istringstream ss(line.substr(0, eq));
+                ss >> ch;
+            }
+            if (ch < 1 || ch >= kChannels) {
+                if (error) *error = where + ": expected '<channel> = <profile>'";
+                return false;
+            }
+            channels[ch] = trim(line.substr(eq + 1));
+        } else {
+            if (error) *error = where + ": data outside of a section";
+            return false;
+        }
+    }
+
+    // 모든 프로필을 먼저 검증/생성한 뒤 교체 -> 잘못된 파일은 아무것도 바꾸지 않음
+    std::map<std::string, CalibrationLut> built;
+    for (const auto& kv : points) {
+        std::string err;
+        if (!CalibrationLut::build(kv.second, built[kv.first], &err)) {
+            if (error) *error = path + ": profile " + kv.first + ": " + err;
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (const auto& kv : channels) {
+        if (built.find(kv.second) == built.end() && profiles_.find(kv.second) == profiles_.end()) {
+            if (error) *error = path + ": channel " + std::to_string(kv.first)
+                                + " uses unknown profile " + kv.second;
+            return false;
+        }
+    }
+
+    for (const auto& kv : built)
+        profiles_[kv.first] = store(kv.second);
+
+    // 파일에 채널 지정이 없으면, 다시 읽은 프로필을 쓰는 채널만 갱신
+    for (int ch = 0; ch < kChannels; ++ch) {
+        auto it = channels.find(ch);
+        const std::string& name = (it != channels.end()) ? it->second : names_[ch];
+        publish(ch, profiles_[name], name);
+    }
+    return true;
+}
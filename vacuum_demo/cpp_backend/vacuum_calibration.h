@@ -0,0 +1,165 @@
+// vacuum_calibration.h
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// (ADC, kPa) 보정점
+struct CalibrationPoint {
+    int    adc;
+    double kpa;
+};
+
+// 보정 테이블을 ADC 0~255 전체에 대해 미리 보간해 둔 lookup table.
+// 변환은 배열 load 1회.
+class CalibrationLut
+{
+public:
+    static constexpr int kSize = 256;
+
+    constexpr CalibrationLut() = default;
+
+    // 보정점(adc 오름차순) 구간 선형 보간. 범위 밖은 양 끝 값으로 클램프
+    static constexpr CalibrationLut fromPoints(const CalibrationPoint* points, std::size_t count)
+    {
+        CalibrationLut lut;
+        for (int adc = 0; adc < kSize; ++adc)
+            lut.table_[adc] = static_cast<float>(interpolate(points, count, adc));
+        return lut;
+    }
+
+    // 파일 등에서 읽은 보정점으로 생성. 점이 2개 미만이거나 adc 가 오름차순이 아니면 false
+    static bool build(const std::vector<CalibrationPoint>& points, CalibrationLut& out,
+                      std::string* error = nullptr);
+
+    constexpr float operator[](std::uint8_t raw) const { return table_[raw]; }
+
+    constexpr float convert(int adc) const
+    {
+        return table_[adc < 0 ? 0 : (adc > kSize - 1 ? kSize - 1 : adc)];
+    }
+
+    // raw[0..count) -> out[0..count)
+    void convertBatch(const std::uint8_t* raw, float* out, std::size_t count) const;
+
+    const float* data() const { return table_; }
+
+private:
+    static constexpr double interpolate(const CalibrationPoint* p, std::size_t n, int adc)
+    {
+        if (n == 0)
+            return 0.0;
+        if (adc <= p[0].adc)
+            return p[0].kpa;
+        if (adc >= p[n - 1].adc)
+            return p[n - 1].kpa;
+
+        for (std::size_t i = 0; i + 1 < n; ++i) {
+            if (adc >= p[i].adc && adc <= p[i + 1].adc) {
+                const double t = double(adc - p[i].adc) / double(p[i + 1].adc - p[i].adc);
+                return p[i].kpa + t * (p[i + 1].kpa - p[i].kpa);
+            }
+        }
+        return p[n - 1].kpa;
+    }
+
+    float table_[kSize] = {};
+};
+
+// 기본 보정 테이블 (CHUCK 기준).
+// 65 kPa 지점 후보: {88,65}, {81,65}, {81,69} (VAC), {95,65} (CHUCK)
+inline constexpr CalibrationPoint kDefaultCalibrationPoints[] = {
+    {  0, 100.0 },   // 100 kPa
+    { 48,  80.0 },   // 80 kPa
+    { 95,  65.0 },   // 65 kPa // CHUCK
+    {125,  50.0 },   // 50 kPa
+    {255,   0.0 },   // 0 kPa
+};
+
+inline constexpr std::size_t kDefaultCalibrationPointCount =
+    sizeof(kDefaultCalibrationPoints) / sizeof(kDefaultCalibrationPoints[0]);
+
+// 컴파일 타임에 계산된 기본 LUT
+inline constexpr CalibrationLut kDefaultCalibration =
+    CalibrationLut::fromPoints(kDefaultCalibrationPoints, kDefaultCalibrationPointCount);
+
+// PAK(VAC) 지그용 보정 테이블: 65 kPa 지점을 {81,69} 로 사용
+inline constexpr CalibrationPoint kPakCalibrationPoints[] = {
+    {  0, 100.0 },
+    { 48,  80.0 },
+    { 81,  69.0 },   // 65 kPa // VAC
+    {125,  50.0 },
+    {255,   0.0 },
+};
+
+inline constexpr CalibrationLut kPakCalibration =
+    CalibrationLut::fromPoints(kPakCalibrationPoints,
+                               sizeof(kPakCalibrationPoints) / sizeof(kPakCalibrationPoints[0]));
+
+// 장비(fixture) 1개의 채널별 활성 보정 테이블.
+// 측정 경로는 lut()/convert() 로 atomic load 1회만 하고 lock 을 잡지 않는다.
+// 교체된 테이블은 set 이 살아있는 동안 해제하지 않으므로 읽던 쪽이 안전하다.
+//
+// 파일 형식:
+//   # comment
+//   [profile PAK]
+//   0 100
+//   48 80
+//   81 69
+//   125 50
+//   255 0
+//
+//   [channels]
+//   1 = PAK
+//   2 = CHUCK
+//
+// 내장 프로필: DEFAULT, CHUCK (= DEFAULT), PAK
+class CalibrationSet
+{
+public:
+    static constexpr int kChannels = 4;   // index = channel (0 미사용)
+
+    CalibrationSet();
+
+    CalibrationSet(const CalibrationSet&) = delete;
+    CalibrationSet& operator=(const CalibrationSet&) = delete;
+
+    // 범위 밖 채널은 기본 테이블 (VacuumDevice::toPressure 의 calibration 없음과 같음)
+    const CalibrationLut& lut(int channel) const
+    {
+        if (channel < 0 || channel >= kChannels)
+            return kDefaultCalibration;
+        return *active_[channel].load(std::memory_order_acquire);
+    }
+
+    float convert(int channel, int raw) const { return lut(channel).convert(raw); }
+
+    // 프로필 파일 읽기. 성공 시 [channels] 지정대로 즉시 교체 (실행 중 재보정)
+    bool loadFile(const std::string& path, std::string* error = nullptr);
+
+    // 이미 등록된 프로필로 채널 테이블 교체
+    bool selectProfile(int channel, const std::string& name);
+
+    // 프로필 등록(같은 이름이면 갱신). 해당 프로필을 쓰는 채널도 새 테이블로 교체
+    bool addProfile(const std::string& name, const std::vector<CalibrationPoint>& points,
+                    std::string* error = nullptr);
+
+    std::string profileName(int channel) const;
+
+private:
+    const CalibrationLut* store(const CalibrationLut& lut);
+    void publish(int channel, const CalibrationLut* lut, const std::string& name);
+
+    std::atomic<const CalibrationLut*> active_[kChannels];
+
+    mutable std::mutex                           mutex_;      // writer 전용
+    std::vector<std::unique_ptr<CalibrationLut>> owned_;      // 교체된 테이블 포함, 해제하지 않음
+    std::map<std::string, const CalibrationLut*> profiles_;
+    std::string                                  names_[kChannels];
+};
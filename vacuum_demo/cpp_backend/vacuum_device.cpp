@@ -2,7 +2,12 @@
 // vacuum_device.cpp
 
 #include "vacuum_device.h"
+#include "vacuum_calibration.h"
+#include "vacuum_trace.h"
 #include <QDebug>
+#include <QElapsedTimer>
+
+#include <chrono>
 
 VacuumDevice::VacuumDevice()
 {
@@ -57,6 +62,7 @@ bool VacuumDevice::connectPort(const QString& portName, int baud)
 {
     if (serial_.isOpen())
         serial_.close();
+    inFlight_.clear();
 
     serial_.setPortName(portName);
     serial_.setBaudRate(baud);
@@ -77,6 +83,8 @@ bool VacuumDevice::connectPort(const QString& portName, int baud)
 
 void VacuumDevice::disconnectPort()
 {
+    inFlight_.clear();
+
     if (serial_.isOpen()) {
         qDebug() << "[VacuumDevice] disconnectPort()";
         serial_.close();
@@ -119,34 +127,63 @@ bool VacuumDevice::sendCommand(const QByteArray& cmd)
     const qint64 written = serial_.write(cmd);
     if (written != cmd.size()) {
         qWarning() << "[VacuumDevice] write failed, written:" << written;
+        count(&DeviceMetrics::writeErrors);
         return false;
     }
 
     if (!serial_.waitForBytesWritten(100)) {
         qWarning() << "[VacuumDevice] waitForBytesWritten timeout";
+        count(&DeviceMetrics::writeErrors);
         return false;
     }
 
-    qDebug() << "[VacuumDevice] Sending command:" << cmd;
+    count(&DeviceMetrics::commands);
+    VACUUM_TRACE_DEBUG(TraceEvent::CommandSent, cmd.size(), TraceLog::packBytes(cmd.constData(), cmd.size()), 0, 0, 0);
     return true;
 }
 
-QByteArray VacuumDevice::receiveBytes(int timeoutMs)
+int VacuumDevice::responseLength(const QByteArray& cmd)
+{
+    // VAC1/VAC2 -> ADC 1 byte, STP3 -> 응답 없음
+    if (cmd.size() >= 4 && cmd[0] == 'V' && cmd[1] == 'A' && cmd[2] == 'C')
+        return 1;
+    return 0;
+}
+
+void VacuumDevice::discardStaleInput()
+{
+    if (serial_.bytesAvailable() <= 0)
+        return;
+
+    const QByteArray stale = serial_.readAll();
+    count(&DeviceMetrics::staleBytes, static_cast<std::uint64_t>(stale.size()));
+    VACUUM_TRACE_INFO(TraceEvent::StaleDropped, stale.size(), TraceLog::packBytes(stale.constData(), stale.size()), 0, 0, 0);
+}
+
+QByteArray VacuumDevice::receiveFrame(int expectedLen, int timeoutMs)
 {
     QByteArray data;
 
-    if (!serial_.isOpen())
+    if (!serial_.isOpen() || expectedLen <= 0)
         return data;
 
-    if (!serial_.waitForReadyRead(timeoutMs))
-        return data;
+    QElapsedTimer timer;
+    timer.start();
+
+    while (serial_.bytesAvailable() < expectedLen) {
+        const int remaining = timeoutMs - static_cast<int>(timer.elapsed());
+        if (remaining <= 0 || !serial_.waitForReadyRead(remaining))
+            break;
+    }
 
-    data = serial_.readAll();
-    while (serial_.waitForReadyRead(20)) {
-        data += serial_.readAll();
+    // 프레임 길이만큼만 소비. 부족하면 받은 만큼 (short read)
+    data = serial_.read(expectedLen);
+
+    if (data.size() < expectedLen && !data.isEmpty()) {
+        count(&DeviceMetrics::shortReads);
+        VACUUM_TRACE_WARN(TraceEvent::ShortFrame, data.size(), expectedLen, 0, 0, 0);
     }
 
-    qDebug() << "[VacuumDevice] received bytes:" << data.toHex(' ');
     return data;
 }
 
@@ -181,62 +218,13 @@ float VacuumDevice::convertRawToPressure(quint8 raw)
 
 float VacuumDevice::convertRawToPressure(int adcValue)
 {
-    int outRange = 0;
-    // 0~255 범위 보정
-    int adc = qBound(0, adcValue, 255);
-
-    // (ADC, kPa) 보정 테이블
-    const QVector<QPair<int, double>> cal = {
-        {  0, 100.0 },   // 100 kPa
-        { 48,  80.0 },   // 80 kPa
-        //{ 88,  65.0 },   // 65 kPa
-        // { 81,  65.0 },   // 65 kPa
-        //{ 81,  69.0 },   // 65 kPa // VAC
-        //{ 95,  65.0 },   // 65 kPa // CHUCK
-        { 95,  65.0 },   // 65 kPa // CHUCK
-        {125,  50.0 },   // 50 kPa
-        {255,   0.0 }    // 0 kPa
-    };
-
-    // 구간 클램프
-    if (adc <= cal.first().first) {
-        if (outRange) outRange = 2;
-        return cal.first().second;
-    }
-
-    if (adc >= cal.last().first) {
-        if (outRange) outRange = 0;
-        return cal.last().second;
-    }
-
-    // 선형 보간
-    for (int i = 0; i < cal.size() - 1; ++i)
-    {
-        int x0 = cal[i].first;
-        int x1 = cal[i + 1].first;
-        double y0 = cal[i].second;
-        double y1 = cal[i + 1].second;
-
-        if (adc >= x0 && adc <= x1)
-        {
-            // 기존 if/else 구간 정의 유지
-            if (outRange) {
-                if (adc >= 88)      outRange = 0; // 65~0 kPa
-                else if (adc >= 48) outRange = 1; // 80~65 kPa
-                else                outRange = 2; // 100~80 kPa
-            }
-
-            double t = double(adc - x0) / double(x1 - x0);
-            return y0 + t * (y1 - y0);
-        }
-    }
-
-    return qQNaN(); // 안전장치
+    // 보정 테이블은 컴파일 타임에 256-entry LUT 로 계산됨 (vacuum_calibration.h)
+    return kDefaultCalibration.convert(adcValue);
 }
 
 
 
-bool VacuumDevice::measureOnce(int channel, float& pressureOut)
+bool VacuumDevice::measureOnce(int channel, float& pressureOut, quint8* rawOut)
 {
     if (!serial_.isOpen()) {
         qWarning() << "[VacuumDevice] measureOnce: device not open";
@@ -244,21 +232,145 @@ bool VacuumDevice::measureOnce(int channel, float& pressureOut)
     }
 
     const QByteArray cmd = buildCommand(channel);
+    const int frameLen   = responseLength(cmd);
+
+    if (staleBytes_ == StaleBytes::Drop)
+        discardStaleInput();
+
+    QElapsedTimer rtt;
+    rtt.start();
+
     if (!sendCommand(cmd))
         return false;
 
-    const QByteArray rx = receiveBytes(200);
-    if (rx.isEmpty()) {
-        qWarning() << "[VacuumDevice] measureOnce: no response";
+    // STP3 는 응답이 없으므로 측정값도 없음 (명령만 보냄)
+    if (frameLen <= 0)
+        return false;
+
+    const QByteArray rx = receiveFrame(frameLen, 200);
+    if (rx.size() < frameLen) {
+        if (rx.isEmpty())
+            count(&DeviceMetrics::timeouts);
+        VACUUM_TRACE_WARN(TraceEvent::NoResponse, channel, 0, 0, 0, 0);
         return false;
     }
+    count(&DeviceMetrics::responses);
+
+    if (rttHistogram_)
+        rttHistogram_->record(static_cast<std::uint64_t>(rtt.nsecsElapsed() / 1000));
 
     const quint8 raw = static_cast<quint8>(rx[0]);
-    const float p    = convertRawToPressure(raw);
+    const float p    = toPressure(channel, raw);
 
     lastPressure_ = p;
     pressureOut   = p;
+    if (rawOut)
+        *rawOut = raw;
+
+    VACUUM_TRACE_DEBUG(TraceEvent::Measure, channel, raw, p, 0, 0);
+    return true;
+}
+
+// ───────────────────────────────────────
+//  Pipelined mode
+// ───────────────────────────────────────
+int64_t VacuumDevice::steadyNowNs()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+bool VacuumDevice::issueCommand(int channel, int depth)
+{
+    if (!serial_.isOpen())
+        return false;
 
-    qDebug() << "[VacuumDevice] measureOnce result:" << p << "kPa";
+    if (static_cast<int>(inFlight_.size()) >= depth)
+        return false;
+
+    // 응답 없는 명령(STP3)은 파이프라인에 넣지 않음
+    const QByteArray cmd = buildCommand(channel);
+    if (responseLength(cmd) != 1)
+        return false;
+
+    const int64_t sent = steadyNowNs();
+    if (!sendCommand(cmd))
+        return false;
+
+    inFlight_.push_back({channel, sent});
     return true;
 }
+
+int VacuumDevice::collectResponses(int waitMs, int timeoutMs, std::vector<PipelineSample>& out)
+{
+    if (!serial_.isOpen())
+        return 0;
+
+    if (serial_.bytesAvailable() <= 0 && waitMs > 0)
+        serial_.waitForReadyRead(waitMs);
+
+    int added = 0;
+    const QByteArray rx = serial_.readAll();
+    const int64_t now   = steadyNowNs();
+
+    for (int i = 0; i < rx.size(); ++i) {
+        if (inFlight_.empty()) {
+            // 요청하지 않은 바이트 -> 앞선 resync 이후 늦게 온 응답
+            count(&DeviceMetrics::staleBytes);
+            VACUUM_TRACE_WARN(TraceEvent::StaleDropped, 1, static_cast<quint8>(rx[i]), 0, 0, 0);
+            continue;
+        }
+
+        const PendingCommand pending = inFlight_.front();
+        inFlight_.pop_front();
+
+        PipelineSample s{};
+        s.channel    = pending.channel;
+        s.raw        = static_cast<quint8>(rx[i]);
+        s.pressure   = toPressure(s.channel, s.raw);
+        s.sentNs     = pending.sentNs;
+        s.receivedNs = now;
+        out.push_back(s);
+        ++added;
+        count(&DeviceMetrics::responses);
+
+        if (rttHistogram_)
+            rttHistogram_->record(static_cast<std::uint64_t>((now - pending.sentNs) / 1000));
+    }
+
+    if (added > 0)
+        lastPressure_ = out.back().pressure;
+
+    // 가장 오래된 명령이 timeout -> 응답 1 byte 가 유실됨.
+    // 뒤따르는 응답이 한 칸씩 밀려 매칭되지 않도록 전체를 비우고 다시 맞춘다.
+    if (!inFlight_.empty()) {
+        const int64_t ageNs = now - inFlight_.front().sentNs;
+        if (ageNs > static_cast<int64_t>(timeoutMs) * 1000000) {
+            VACUUM_TRACE_WARN(TraceEvent::PipelineTimeout, static_cast<std::int32_t>(inFlight_.size()), 0, 0, 0, 0);
+            lostResponses_ += inFlight_.size();
+            count(&DeviceMetrics::timeouts, inFlight_.size());
+            count(&DeviceMetrics::resyncs);
+            resyncPipeline(timeoutMs);
+        }
+    }
+
+    return added;
+}
+
+void VacuumDevice::resyncPipeline(int quietMs)
+{
+    // 아직 오고 있는 응답이 없을 때까지 기다렸다가 모두 버린다
+    while (serial_.waitForReadyRead(quietMs))
+        serial_.readAll();
+    serial_.readAll();
+
+    inFlight_.clear();
+    ++resyncs_;
+}
+
+void VacuumDevice::resetPipeline()
+{
+    if (serial_.isOpen() && !inFlight_.empty())
+        resyncPipeline(50);
+    inFlight_.clear();
+}
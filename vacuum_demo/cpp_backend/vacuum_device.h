@@ -5,12 +5,24 @@
 #include <QtSerialPort/QSerialPortInfo>
 #include <QByteArray>
 #include <QString>
+#include <cstdint>
+#include <deque>
 #include <vector>
 
+#include "vacuum_calibration.h"
+#include "vacuum_latency_histogram.h"
+#include "vacuum_metrics.h"
+
 
 class VacuumDevice
 {
 public:
+    // 명령 전송 전에 입력 버퍼에 남아있는 (이전 응답의) 바이트 처리 방식
+    enum class StaleBytes {
+        Drop,   // 버림 (기본) - 늦게 도착한 이전 응답과 섞이지 않도록
+        Keep    // 유지 - 이번 프레임의 앞부분으로 사용
+    };
+
     VacuumDevice();
     ~VacuumDevice();
 
@@ -28,19 +40,89 @@ public:
 
     // channel: 1=VAC1(PAK), 2=VAC2(CHUCK)
     // 
-    bool measureOnce(int channel, float& pressureOut);
+    // rawOut: 수신한 ADC byte (필요할 때만)
+    bool measureOnce(int channel, float& pressureOut, quint8* rawOut = nullptr);
 
     // 
     //  - Windows: "COM4"
     //  - Linux/macOS: "/dev/ttyUSB0", "/dev/ttyS0" 
     std::vector<std::string> listPorts();
 
+    void setStaleBytePolicy(StaleBytes policy) { staleBytes_ = policy; }
+    StaleBytes staleBytePolicy() const { return staleBytes_; }
+
+    // 명령 전송 ~ 응답 프레임 완료까지의 시간(us) 기록 대상 (nullptr 이면 기록 안 함)
+    void setLatencyHistogram(LatencyHistogram* histogram) { rttHistogram_ = histogram; }
+
+    // timeout / short read / write 오류 등 링크 카운터 (nullptr 이면 기록 안 함)
+    void setMetrics(DeviceMetrics* metrics) { metrics_ = metrics; }
+
+    // 명령별 응답 프레임 길이 (bytes)
+    static int responseLength(const QByteArray& cmd);
+
+    // ADC byte -> kPa (기본 보정 테이블)
+    static float convertRawToPressure(int raw);
+
+    // 채널별 보정 테이블 (nullptr 이면 기본 테이블). set 은 device 보다 오래 살아야 함
+    void setCalibration(const CalibrationSet* calibration) { calibration_ = calibration; }
+
+    // ─── pipelined mode ───
+    // 응답을 기다리지 않고 VAC 명령을 여러 개 보내 두고, 도착 순서대로 매칭한다.
+    // 응답에 시퀀스 번호가 없으므로 FIFO 순서가 곧 매칭 규칙이다.
+    struct PipelineSample {
+        int     channel;
+        quint8  raw;
+        float   pressure;
+        int64_t sentNs;       // steady clock
+        int64_t receivedNs;   // steady clock
+    };
+
+    // in-flight 가 depth 미만일 때만 전송
+    bool issueCommand(int channel, int depth);
+
+    // waitMs 동안 응답을 모아 out 에 추가, 추가한 개수 반환.
+    // 가장 오래된 명령이 timeoutMs 를 넘기면 resync.
+    int collectResponses(int waitMs, int timeoutMs, std::vector<PipelineSample>& out);
+
+    int  inFlight() const { return static_cast<int>(inFlight_.size()); }
+    void resetPipeline();
+
+    std::uint64_t lostResponses() const { return lostResponses_; }
+    std::uint64_t pipelineResyncs() const { return resyncs_; }
+
 private:
     QSerialPort serial_;
     float lastPressure_ = 0.0f;
+    StaleBytes staleBytes_ = StaleBytes::Drop;
+    LatencyHistogram* rttHistogram_ = nullptr;
+    DeviceMetrics* metrics_ = nullptr;
+    const CalibrationSet* calibration_ = nullptr;
+
+    float toPressure(int channel, quint8 raw) const
+    {
+        return calibration_ ? calibration_->convert(channel, raw) : kDefaultCalibration[raw];
+    }
+
+    struct PendingCommand {
+        int     channel;
+        int64_t sentNs;
+    };
+    std::deque<PendingCommand> inFlight_;
+    std::uint64_t lostResponses_ = 0;
+    std::uint64_t resyncs_       = 0;
+
+    void resyncPipeline(int quietMs);
+    static int64_t steadyNowNs();
 
     QByteArray buildCommand(int channel);
     bool sendCommand(const QByteArray& cmd);
-    QByteArray receiveBytes(int timeoutMs);
-    float convertRawToPressure(int raw);
+    // expectedLen 바이트가 모이는 즉시 반환 (남는 바이트는 버퍼에 그대로 둠)
+    QByteArray receiveFrame(int expectedLen, int timeoutMs);
+    void discardStaleInput();
+
+    void count(std::atomic<std::uint64_t> DeviceMetrics::*counter, std::uint64_t n = 1)
+    {
+        if (metrics_)
+            DeviceMetrics::add(metrics_->*counter, n);
+    }
 };
@@ -0,0 +1,70 @@
+// vacuum_event_port.h
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Dart ReceivePort 로 이벤트를 push 한다 (UI 는 polling 대신 이벤트에 깨어남).
+// dart_api_dl.h 없이 동작하도록 Dart 가 NativeApi.postCObject 함수 포인터와
+// sendPort.nativePort 를 넘겨준다. 메시지는 Dart_CObject(kInt64) 1 개:
+//   bit 56..62 = 종류 (VacuumEventKind), bit 48..55 = 채널, bit 0..47 = payload
+enum class VacuumEventKind : int {
+    Samples      = 1,   // payload = 이번에 발행된 샘플 수
+    Phase        = 2,   // payload = LeakPhase
+    Verdict      = 3,   // payload bit0 = PASS, bit1 = 조기 판정
+    Disconnected = 4,   // payload 없음
+};
+
+class VacuumEventPort
+{
+public:
+    // Dart_CObject 와 같은 layout (type + 8-byte 정렬 union). kInt64 만 사용
+    struct CObject {
+        int32_t type;
+        union {
+            int64_t asInt64;
+            void*   reserved[5];   // 가장 큰 union 멤버 크기 (as_external_typed_data)
+        } value;
+    };
+
+    using PostFn = bool (*)(int64_t port, CObject* message);
+
+    static constexpr int32_t kCObjectInt64 = 3;   // Dart_CObject_kInt64
+
+    // port == 0 또는 postFn == nullptr 이면 해제
+    void attach(void* postFn, int64_t port)
+    {
+        port_.store(0, std::memory_order_relaxed);
+        postFn_.store(reinterpret_cast<PostFn>(postFn), std::memory_order_relaxed);
+        port_.store(postFn ? port : 0, std::memory_order_release);
+    }
+
+    void detach() { port_.store(0, std::memory_order_release); }
+
+    bool attached() const { return port_.load(std::memory_order_acquire) != 0; }
+
+    // 어느 스레드에서든 호출 가능. 연결된 port 가 없으면 아무것도 하지 않음
+    bool post(VacuumEventKind kind, int channel, int64_t payload = 0) const
+    {
+        const int64_t port = port_.load(std::memory_order_acquire);
+        if (port == 0)
+            return false;
+        const PostFn fn = postFn_.load(std::memory_order_relaxed);
+
+        CObject msg{};
+        msg.type = kCObjectInt64;
+        msg.value.asInt64 = encode(kind, channel, payload);
+        return fn(port, &msg);
+    }
+
+    static int64_t encode(VacuumEventKind kind, int channel, int64_t payload)
+    {
+        return (static_cast<int64_t>(kind) & 0x7f) << 56
+             | (static_cast<int64_t>(channel) & 0xff) << 48
+             | (payload & 0xffffffffffffLL);
+    }
+
+private:
+    std::atomic<PostFn>  postFn_{nullptr};
+    std::atomic<int64_t> port_{0};
+};
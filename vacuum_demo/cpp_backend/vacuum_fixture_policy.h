@@ -0,0 +1,129 @@
+// vacuum_fixture_policy.h
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+
+// 검사 지그 종류별 판정 정책. 전부 constexpr 이라 TU 마다 생기는 전역 변수가 없다.
+// 정책은 지그 종류(kId)로 등록하고, 어느 채널에 어떤 지그가 물려 있는지는
+// VacuumBackend::setChannelFixture (vacuum_set_channel_fixture) 로 실행 중에 정한다.
+//
+// 새 지그 추가: 아래 형식의 정책 struct 를 만들고 FixturePolicies 목록에 넣는다.
+// VacuumBackend 는 fixtureParams(fixtureId) 로만 읽으므로 수정할 필요 없음.
+//   struct XxxFixture {
+//       static constexpr int   kId             = 3;       // 지그 종류 id (1 ~ kMaxFixtureTypes-1, 중복 불가)
+//       static constexpr char  kName[]         = "XXX";   // 로그 표시용
+//       static constexpr float kHrate          = 0.5f;    // 측정 구간 압력 변화 보정 비율
+//       static constexpr int   kStartOffsetSec = 7;       // 준비시간 (STARTOFFSET)
+//   };
+
+// 채널 공통 판정 기본값 (setThresholds 로 변경)
+constexpr float kDefaultMinPress    = 62.0f;
+constexpr float kDefaultMinDiff     = 1.0f;
+constexpr float kDefaultOffsetClamp = 65.5f;
+
+struct PakFixture {
+    static constexpr int   kId             = 1;
+    static constexpr char  kName[]         = "PAK";
+    static constexpr float kHrate          = 0.5f;
+    static constexpr int   kStartOffsetSec = 25;
+};
+
+struct ChuckFixture {
+    static constexpr int   kId             = 2;
+    static constexpr char  kName[]         = "CHUCK";
+    static constexpr float kHrate          = 0.6f;
+    static constexpr int   kStartOffsetSec = 7;
+};
+
+// 지그가 지정되지 않은 채널 / 등록되지 않은 id
+struct GenericFixture {
+    static constexpr int   kId             = 0;
+    static constexpr char  kName[]         = "GENERIC";
+    static constexpr float kHrate          = 1.0f;
+    static constexpr int   kStartOffsetSec = 7;
+};
+
+template <typename... Policies>
+struct FixtureList {};
+
+// 등록된 지그
+using FixturePolicies = FixtureList<PakFixture, ChuckFixture>;
+
+// ───────────────────────────────────────
+//  지그 id -> 정책 table (컴파일 시 생성)
+// ───────────────────────────────────────
+constexpr int kMaxFixtureTypes = 16;   // id 0 = GenericFixture
+constexpr int kFixtureChannels = 4;    // AcquisitionTotals::kChannels 와 같음 (index = channel)
+
+struct FixtureParams {
+    const char* name;
+    float       hrate;
+    int         startOffsetSec;
+};
+
+template <typename Policy>
+constexpr FixtureParams fixtureParamsOf()
+{
+    static_assert(Policy::kId >= 0 && Policy::kId < kMaxFixtureTypes, "fixture id out of range");
+    static_assert(Policy::kStartOffsetSec > 0, "fixture start offset must be positive");
+    return FixtureParams{Policy::kName, Policy::kHrate, Policy::kStartOffsetSec};
+}
+
+// 장비 명령(VacuumDevice::buildCommand)으로 압력을 읽을 수 있는 채널. 3 (STP3) 은 응답이 없다
+constexpr bool isVacChannel(int channel)
+{
+    return channel == 1 || channel == 2;
+}
+
+template <typename... Policies>
+constexpr std::array<FixtureParams, kMaxFixtureTypes> makeFixtureTable(FixtureList<Policies...>)
+{
+    std::array<FixtureParams, kMaxFixtureTypes> table{};
+    for (int id = 0; id < kMaxFixtureTypes; ++id)
+        table[id] = fixtureParamsOf<GenericFixture>();
+    ((table[Policies::kId] = fixtureParamsOf<Policies>()), ...);
+    return table;
+}
+
+template <typename... Policies>
+constexpr std::array<bool, kMaxFixtureTypes> makeFixtureRegistry(FixtureList<Policies...>)
+{
+    std::array<bool, kMaxFixtureTypes> registered{};
+    registered[GenericFixture::kId] = true;
+    ((registered[Policies::kId] = true), ...);
+    return registered;
+}
+
+template <typename... Policies>
+constexpr bool uniqueFixtureIds(FixtureList<Policies...>)
+{
+    bool used[kMaxFixtureTypes] = {};
+    for (int id : {Policies::kId...}) {
+        if (id == GenericFixture::kId || used[id])
+            return false;
+        used[id] = true;
+    }
+    return true;
+}
+
+static_assert(uniqueFixtureIds(FixturePolicies{}), "fixture ids must be unique and non-zero");
+
+inline constexpr std::array<FixtureParams, kMaxFixtureTypes> kFixtureTable = makeFixtureTable(FixturePolicies{});
+inline constexpr std::array<bool, kMaxFixtureTypes> kFixtureRegistered = makeFixtureRegistry(FixturePolicies{});
+
+constexpr bool isFixtureRegistered(int fixtureId)
+{
+    return fixtureId >= 0 && fixtureId < kMaxFixtureTypes && kFixtureRegistered[static_cast<std::size_t>(fixtureId)];
+}
+
+// 등록되지 않은 id 는 GenericFixture
+constexpr const FixtureParams& fixtureParams(int fixtureId)
+{
+    return kFixtureTable[static_cast<std::size_t>(isFixtureRegistered(fixtureId) ? fixtureId : GenericFixture::kId)];
+}
+
+// 기본 배선: VAC1 = PAK, VAC2 = CHUCK (setChannelFixture 로 변경)
+inline constexpr std::array<int, kFixtureChannels> kDefaultChannelFixtures = {
+    GenericFixture::kId, PakFixture::kId, ChuckFixture::kId, GenericFixture::kId};
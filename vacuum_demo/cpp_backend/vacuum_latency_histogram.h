@@ -0,0 +1,121 @@
+// vacuum_latency_histogram.h
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Lock-free log-linear latency histogram (HDR 방식).
+// 2의 거듭제곱 구간마다 16개의 선형 sub-bucket -> 상대 오차 ~6%.
+// 단위는 호출자가 정한다 (backend 는 microseconds 사용).
+class LatencyHistogram
+{
+public:
+    static constexpr int kSubBits    = 4;
+    static constexpr int kSubBuckets = 1 << kSubBits;
+    static constexpr int kMaxExp     = 40;   // 2^40 us 이상은 마지막 bucket 으로
+    static constexpr int kBuckets    = kSubBuckets + (kMaxExp - kSubBits + 1) * kSubBuckets;
+
+    LatencyHistogram() { reset(); }
+
+    void record(std::uint64_t value)
+    {
+        buckets_[indexOf(value)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+
+        std::uint64_t cur = max_.load(std::memory_order_relaxed);
+        while (value > cur && !max_.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {}
+
+        cur = min_.load(std::memory_order_relaxed);
+        while (value < cur && !min_.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {}
+    }
+
+    void reset()
+    {
+        for (auto& b : buckets_)
+            b.store(0, std::memory_order_relaxed);
+        count_.store(0, std::memory_order_relaxed);
+        sum_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+        min_.store(UINT64_MAX, std::memory_order_relaxed);
+    }
+
+    std::uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    std::uint64_t sum() const   { return sum_.load(std::memory_order_relaxed); }
+    std::uint64_t max() const   { return max_.load(std::memory_order_relaxed); }
+    std::uint64_t min() const
+    {
+        const std::uint64_t m = min_.load(std::memory_order_relaxed);
+        return m == UINT64_MAX ? 0 : m;
+    }
+
+    double mean() const
+    {
+        const std::uint64_t n = count();
+        return n ? static_cast<double>(sum()) / static_cast<double>(n) : 0.0;
+    }
+
+    // q: 0.0 ~ 1.0, 해당 bucket 의 상한값 반환
+    std::uint64_t percentile(double q) const
+    {
+        const std::uint64_t n = count();
+        if (n == 0)
+            return 0;
+
+        if (q < 0.0) q = 0.0;
+        if (q > 1.0) q = 1.0;
+
+        std::uint64_t rank = static_cast<std::uint64_t>(q * static_cast<double>(n) + 0.5);
+        if (rank == 0) rank = 1;
+
+        std::uint64_t seen = 0;
+        for (int i = 0; i < kBuckets; ++i) {
+            seen += buckets_[i].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                const std::uint64_t hi = upperBound(i);
+                const std::uint64_t mx = max();
+                return hi < mx ? hi : mx;
+            }
+        }
+        return max();
+    }
+
+    std::uint64_t bucketCount(int index) const
+    {
+        return buckets_[index].load(std::memory_order_relaxed);
+    }
+
+    static int indexOf(std::uint64_t v)
+    {
+        if (v < static_cast<std::uint64_t>(kSubBuckets))
+            return static_cast<int>(v);
+
+        int e = 63;
+        while (!(v >> e))
+            --e;
+        if (e > kMaxExp)
+            return kBuckets - 1;
+
+        const int shift = e - kSubBits;
+        const int sub   = static_cast<int>(v >> shift) - kSubBuckets;
+        return kSubBuckets + shift * kSubBuckets + sub;
+    }
+
+    // bucket 이 포함하는 최대값
+    static std::uint64_t upperBound(int index)
+    {
+        if (index < kSubBuckets)
+            return static_cast<std::uint64_t>(index);
+
+        const int shift = (index - kSubBuckets) / kSubBuckets;
+        const int sub   = (index - kSubBuckets) % kSubBuckets;
+        return ((static_cast<std::uint64_t>(kSubBuckets + sub + 1)) << shift) - 1;
+    }
+
+private:
+    std::atomic<std::uint64_t> buckets_[kBuckets];
+    std::atomic<std::uint64_t> count_{0};
+    std::atomic<std::uint64_t> sum_{0};
+    std::atomic<std::uint64_t> max_{0};
+    std::atomic<std::uint64_t> min_{UINT64_MAX};
+};
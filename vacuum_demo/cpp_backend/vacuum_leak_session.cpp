@@ -0,0 +1,156 @@
+// vacuum_leak_session.cpp
+
+#include "vacuum_leak_session.h"
+
+#include <cmath>
+
+namespace {
+
+// t = counter / DIV 처럼 딱 떨어지는 시각이 경계에서 흔들리지 않도록
+constexpr double kTimeEpsilon = 1e-9;
+
+} // namespace
+
+void LeakTestSession::reset(const LeakTestConfig& config)
+{
+    config_ = config;
+    if (!AveragingFilter::isSupportedWindow(config_.averagingWindow))
+        config_.averagingWindow = AveragingFilter::kDefaultWindow;
+
+    startAvg_.setWindow(config_.averagingWindow);
+    stopAvg_.setWindow(config_.averagingWindow);
+
+    phase_       = LeakPhase::Stabilizing;
+    startPress_  = 0.0f;
+    offsetPress_ = 0.0f;
+    captureSec_  = -1.0;
+
+    settling_.reset(config_.settle);
+    settledSec_ = -1.0;
+
+    fit_.clear();
+    early_       = false;
+    decisionSec_ = 0.0;
+    earlyResult_ = LeakTestResult();
+}
+
+int LeakTestSession::projectVerdict(double xNow) const
+{
+    if (!fit_.valid() || xNow < config_.minHoldSec || xNow >= config_.durationSec)
+        return 0;
+
+    // durationSec 시점 압력 예측 구간 -> 시작 압력 대비 변화량 구간
+    const double x    = config_.durationSec;
+    const double yHat = fit_.predict(x);
+    const double half = config_.confidenceZ * fit_.predictStdError(x);
+    const double lo   = yHat - half - startPress_;
+    const double hi   = yHat + half - startPress_;
+
+    // Measuring 구간 판정식: diff = val + |val| * hrate (val 에 대해 단조 증가)
+    const auto withRate = [this](double v) { return v + std::fabs(v) * config_.hrate; };
+    const double band   = config_.minDiff;
+
+    const bool inside = withRate(lo) >= -band && withRate(hi) <= band &&
+                        lo >= -band && hi <= band &&
+                        startPress_ + withRate(lo) >= config_.minPress &&
+                        startPress_ + lo >= config_.minPress;
+    if (inside)
+        return +1;
+
+    const bool outside = withRate(hi) < -band || withRate(lo) > band ||
+                         startPress_ + withRate(hi) < config_.minPress;
+    if (outside)
+        return -1;
+
+    return 0;
+}
+
+LeakTestResult LeakTestSession::feed(double tSec, float pressure)
+{
+    if (early_) {
+        LeakTestResult r = earlyResult_;
+        r.pressure = pressure;
+        return r;
+    }
+
+    LeakTestResult r;
+    r.pressure = pressure;
+
+    if (phase_ == LeakPhase::Stabilizing) {
+        if (tSec <= config_.startOffsetSec + kTimeEpsilon) {
+            // 안정 판정된 샘플은 버리지 않고 Averaging 의 첫 샘플로 사용
+            const bool settled = config_.adaptiveSettling &&
+                                 settling_.add(tSec, pressure) &&
+                                 tSec >= config_.settleMinSec;
+            if (!settled) {
+                r.phase = LeakPhase::Stabilizing;
+                return r;   // PASS, no stop
+            }
+        }
+        phase_      = LeakPhase::Averaging;
+        settledSec_ = tSec;
+    }
+
+    if (phase_ == LeakPhase::Averaging) {
+        // 시작/종료 평균을 같은 샘플로 채움
+        const float st = startAvg_.push(pressure);
+        const float sp = stopAvg_.push(pressure);
+
+        offsetPress_ = (st > config_.offsetClamp) ? st - config_.offsetClamp : 0.0f;
+        startPress_  = st - offsetPress_;
+
+        if (static_cast<int>(startAvg_.size()) >= config_.averagingWindow) {
+            phase_      = LeakPhase::Measuring;
+            captureSec_ = tSec;
+        }
+
+        r.phase         = LeakPhase::Averaging;
+        r.startPressure = st;
+        r.stopPressure  = sp;
+        return r;   // PASS, no stop
+    }
+
+    if (phase_ == LeakPhase::Measuring && !manual() &&
+        tSec > captureSec_ + config_.durationSec + kTimeEpsilon) {
+        phase_ = LeakPhase::Done;
+    }
+
+    float sp = stopAvg_.push(pressure) - offsetPress_;
+    const float st = startPress_;
+
+    if (phase_ == LeakPhase::Measuring) {
+        // 압력 변화량에 hrate 만큼 가산 (변화 방향과 무관하게 +)
+        const float val  = sp - st;
+        const float hval = (val < 0.0f) ? -(val * config_.hrate) : (val * config_.hrate);
+        sp += hval;
+    }
+
+    const float diff = sp - st;
+    const bool  ok   = (sp >= config_.minPress) && (diff <= config_.minDiff && diff >= -config_.minDiff);
+
+    r.phase         = phase_;
+    r.startPressure = st;
+    r.stopPressure  = sp;
+    r.diffPressure  = diff;
+    r.pass          = ok;
+    r.stop          = (phase_ == LeakPhase::Done) ? true : (!ok && !manual());
+
+    if (phase_ == LeakPhase::Measuring && config_.earlyDecision && !manual() && !r.stop) {
+        const double x = tSec - captureSec_;
+        fit_.add(x, static_cast<double>(pressure) - offsetPress_);
+
+        const int verdict = projectVerdict(x);
+        if (verdict != 0) {
+            phase_       = LeakPhase::Done;
+            early_       = true;
+            decisionSec_ = tSec;
+
+            r.phase = LeakPhase::Done;
+            r.pass  = verdict > 0;
+            r.stop  = true;
+            r.early = true;
+            earlyResult_ = r;
+        }
+    }
+    return r;
+}
@@ -0,0 +1,112 @@
+// vacuum_leak_session.h
+#pragma once
+
+#include "vacuum_fixture_policy.h"
+#include "vacuum_linear_fit.h"
+#include "vacuum_moving_average.h"
+#include "vacuum_settling_detector.h"
+
+// 누설 검사 판정 엔진. I/O, 전역 변수 없음 -> 실장비와 저장된 trace 에 동일하게 사용.
+//
+//   Stabilizing : t <= startOffsetSec                   (판정 없음, PASS)
+//   Averaging   : 이후 averagingWindow 샘플               (시작 압력 평균)
+//   Measuring   : 시작 압력 확정 후 durationSec 동안       (FAIL 이면 즉시 stop)
+//   Done        : durationSec 경과                        (stop, 최종 판정)
+// durationSec <= 0 이면 manual 모드: Measuring 이 끝나지 않고 FAIL 이어도 stop 하지 않는다.
+//
+// earlyDecision: Measuring 구간 압력에 직선을 온라인 최소제곱으로 맞추고, durationSec 시점의
+// 예측 diff 신뢰구간이 minDiff 범위 안(PASS) 또는 밖(FAIL)에 완전히 들어가면 바로 Done.
+// minHoldSec 전에는 결정하지 않는다. manual 모드에서는 사용하지 않음.
+//
+// adaptiveSettling: Stabilizing 중 압력 기울기/잔차가 settle 기준 안으로 들어오면
+// startOffsetSec 를 기다리지 않고 Averaging 으로 넘어간다 (startOffsetSec 는 상한).
+enum class LeakPhase : int {
+    Stabilizing = 0,
+    Averaging   = 1,
+    Measuring   = 2,
+    Done        = 3,
+};
+
+struct LeakTestConfig {
+    double startOffsetSec  = 7.0;
+    int    averagingWindow = AveragingFilter::kDefaultWindow;   // 5/10/20/50/100
+    double durationSec     = 0.0;    // <= 0: manual
+    float  hrate           = 1.0f;   // 측정 구간 압력 변화 보정 비율
+    float  minPress        = kDefaultMinPress;
+    float  minDiff         = kDefaultMinDiff;
+    float  offsetClamp     = kDefaultOffsetClamp;  // 시작 압력이 이 값을 넘으면 초과분을 offset 으로 뺌
+
+    bool   earlyDecision   = false;
+    double minHoldSec      = 20.0;   // 시작 압력 확정 후 최소 유지 시간
+    double confidenceZ     = 3.0;    // 신뢰구간 폭 (표준오차 배수)
+
+    bool   adaptiveSettling = false;
+    double settleMinSec     = 2.0;   // 이보다 빨리 안정 판정하지 않음
+    SettlingDetector::Config settle;
+};
+
+struct LeakTestResult {
+    LeakPhase phase        = LeakPhase::Stabilizing;
+    float     pressure     = 0.0f;   // 입력 샘플
+    float     startPressure = 0.0f;
+    float     stopPressure  = 0.0f;
+    float     diffPressure  = 0.0f;
+    bool      pass = true;
+    bool      stop = false;
+    bool      early = false;         // earlyDecision 으로 조기 판정됨
+};
+
+class LeakTestSession
+{
+public:
+    LeakTestSession() = default;
+    explicit LeakTestSession(const LeakTestConfig& config) { reset(config); }
+
+    // 새 검사 시작
+    void reset(const LeakTestConfig& config);
+
+    // tSec: 검사 시작 기준 시각 (초, 단조 증가)
+    LeakTestResult feed(double tSec, float pressure);
+
+    const LeakTestConfig& config() const { return config_; }
+    LeakPhase phase() const { return phase_; }
+    bool  manual() const { return config_.durationSec <= 0.0; }
+    float startPressure() const { return startPress_; }
+    float offsetPressure() const { return offsetPress_; }
+    double captureTimeSec() const { return captureSec_; }   // 시작 압력 확정 시각 (<0: 아직)
+
+    bool   decidedEarly() const { return early_; }
+    // 조기 판정으로 줄인 측정 시간 (초). 조기 판정이 없으면 0
+    double earlySavedSec() const { return early_ ? captureSec_ + config_.durationSec - decisionSec_ : 0.0; }
+    double pressureSlope() const { return fit_.slope(); }   // kPa/s
+
+    // 안정화 완료 시각 (<0: 아직). adaptiveSettling 이 아니면 startOffsetSec 경과 시점
+    double settledSec() const { return settledSec_; }
+    // adaptiveSettling 으로 줄인 대기 시간 (초)
+    double settleSavedSec() const
+    {
+        return settledSec_ >= 0.0 && settledSec_ < config_.startOffsetSec
+                   ? config_.startOffsetSec - settledSec_ : 0.0;
+    }
+
+private:
+    // 0 = 아직 모름, +1 = PASS 확정, -1 = FAIL 확정
+    int projectVerdict(double xNow) const;
+
+    LeakTestConfig  config_;
+    LeakPhase       phase_ = LeakPhase::Stabilizing;
+    AveragingFilter startAvg_;
+    AveragingFilter stopAvg_;
+
+    float  startPress_  = 0.0f;
+    float  offsetPress_ = 0.0f;
+    double captureSec_  = -1.0;
+
+    SettlingDetector settling_;
+    double           settledSec_ = -1.0;
+
+    OnlineLinearFit fit_;            // x = t - captureSec_, y = 압력 - offset
+    bool            early_       = false;
+    double          decisionSec_ = 0.0;
+    LeakTestResult  earlyResult_;
+};
@@ -0,0 +1,65 @@
+// vacuum_linear_fit.h
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+// 온라인 최소제곱 직선 y = a + b*x. add 1회 O(1), 평균/공분산을 Welford 방식으로 갱신해
+// 큰 x 오프셋에서도 수치적으로 안정하다.
+class OnlineLinearFit
+{
+public:
+    void clear() { *this = OnlineLinearFit(); }
+
+    void add(double x, double y)
+    {
+        ++n_;
+        const double dx = x - meanX_;
+        meanX_ += dx / static_cast<double>(n_);
+        const double dy = y - meanY_;
+        meanY_ += dy / static_cast<double>(n_);
+
+        // 새 평균 기준 편차와 곱해야 정확한 co-moment
+        sxx_ += dx * (x - meanX_);
+        sxy_ += dx * (y - meanY_);
+        syy_ += dy * (y - meanY_);
+    }
+
+    std::uint64_t count() const { return n_; }
+    bool valid() const { return n_ >= 3 && sxx_ > 0.0; }
+
+    double slope() const { return valid() ? sxy_ / sxx_ : 0.0; }
+    double intercept() const { return meanY_ - slope() * meanX_; }
+    double predict(double x) const { return intercept() + slope() * x; }
+
+    // 잔차 분산 (자유도 n-2)
+    double residualVariance() const
+    {
+        if (!valid())
+            return 0.0;
+        const double sse = syy_ - sxy_ * sxy_ / sxx_;
+        return sse > 0.0 ? sse / static_cast<double>(n_ - 2) : 0.0;
+    }
+
+    double slopeStdError() const
+    {
+        return valid() ? std::sqrt(residualVariance() / sxx_) : 0.0;
+    }
+
+    // x 에서 회귀선(평균 응답) 값의 표준오차
+    double predictStdError(double x) const
+    {
+        if (!valid())
+            return 0.0;
+        const double d = x - meanX_;
+        return std::sqrt(residualVariance() * (1.0 / static_cast<double>(n_) + d * d / sxx_));
+    }
+
+private:
+    std::uint64_t n_ = 0;
+    double meanX_ = 0.0;
+    double meanY_ = 0.0;
+    double sxx_   = 0.0;
+    double sxy_   = 0.0;
+    double syy_   = 0.0;
+};
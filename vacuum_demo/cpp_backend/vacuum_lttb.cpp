@@ -0,0 +1,238 @@
+// vacuum_lttb.cpp
+
+#include "vacuum_lttb.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// a(고정점) - 후보 j - c(다음 버킷 평균) 삼각형 면적 x2. x 는 x0 기준 상대값 (double 정밀도 유지)
+inline double triangleArea2(double ax, double ay, double bx, double by, double cx, double cy)
+{
+    return std::fabs((ax - cx) * (by - ay) - (ax - bx) * (cy - ay));
+}
+
+// [from, to) 에서 a 와 다음 버킷 평균 (cx, cy) 기준 면적이 가장 큰 index
+std::size_t pickInBucket(const std::int64_t* x, const float* y, std::size_t from, std::size_t to,
+                         std::int64_t x0, double ax, double ay, double cx, double cy)
+{
+    std::size_t best = from;
+    double bestArea = -1.0;
+    for (std::size_t j = from; j < to; ++j) {
+        const double area = triangleArea2(ax, ay, static_cast<double>(x[j] - x0), y[j], cx, cy);
+        if (area > bestArea) {
+            bestArea = area;
+            best = j;
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+std::size_t lttbDownsample(const std::int64_t* x, const float* y, std::size_t n, std::size_t target,
+                           std::int64_t* outX, float* outY)
+{
+    if (n == 0 || target == 0)
+        return 0;
+
+    if (target >= n) {
+        std::copy(x, x + n, outX);
+        std::copy(y, y + n, outY);
+        return n;
+    }
+
+    if (target < 3) {
+        outX[0] = x[0];
+        outY[0] = y[0];
+        if (target == 1)
+            return 1;
+        outX[1] = x[n - 1];
+        outY[1] = y[n - 1];
+        return 2;
+    }
+
+    const std::int64_t x0 = x[0];
+    const double every = static_cast<double>(n - 2) / static_cast<double>(target - 2);
+
+    std::size_t out = 0;
+    std::size_t a = 0;
+    outX[out] = x[0];
+    outY[out] = y[0];
+    ++out;
+
+    for (std::size_t i = 0; i < target - 2; ++i) {
+        // 다음 버킷 평균 (마지막 버킷이면 마지막 점)
+        const std::size_t avgFrom = static_cast<std::size_t>((i + 1) * every) + 1;
+        const std::size_t avgTo   = std::min(static_cast<std::size_t>((i + 2) * every) + 1, n);
+        double cx = 0.0, cy = 0.0;
+        for (std::size_t j = avgFrom; j < avgTo; ++j) {
+            cx += static_cast<double>(x[j] - x0);
+            cy += y[j];
+        }
+        const double cnt = static_cast<double>(avgTo - avgFrom);
+        cx /= cnt;
+        cy /= cnt;
+
+        const std::size_t from = static_cast<std::size_t>(i * every) + 1;
+        const std::size_t to   = static_cast<std::size_t>((i + 1) * every) + 1;
+        a = pickInBucket(x, y, from, to, x0, static_cast<double>(x[a] - x0), y[a], cx, cy);
+
+        outX[out] = x[a];
+        outY[out] = y[a];
+        ++out;
+    }
+
+    outX[out] = x[n - 1];
+    outY[out] = y[n - 1];
+    return out + 1;
+}
+
+// ───────────────────────────────────────
+//  LttbPyramid
+// ───────────────────────────────────────
+void LttbPyramid::append(std::int64_t tUs, float value)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    levels_[0].t.push_back(tUs);
+    levels_[0].v.push_back(value);
+
+    for (std::size_t level = 1; level < static_cast<std::size_t>(kMaxLevels); ++level) {
+        if (level == levels_.size()) {
+            if (levels_[level - 1].t.size() <= 2 * kFactor)
+                break;
+            levels_.emplace_back();
+        }
+        const std::size_t before = levels_[level].t.size();
+        promote(level);
+        if (levels_[level].t.size() == before)
+            break;   // 이 level 이 그대로면 상위도 그대로
+    }
+}
+
+// 하위 level 에서 다음 버킷까지 다 찬 버킷을 닫는다 (mutex_ 보유)
+void LttbPyramid::promote(std::size_t level)
+{
+    const Level& src = levels_[level - 1];
+    Level&       dst = levels_[level];
+
+    if (dst.t.empty()) {
+        if (src.t.empty())
+            return;
+        dst.t.push_back(src.t[0]);
+        dst.v.push_back(src.v[0]);
+        dst.next = 1;
+    }
+
+    const std::int64_t* x = src.t.data();
+    const float*        y = src.v.data();
+    while (dst.next + 2 * kFactor <= src.t.size()) {
+        const std::size_t from = dst.next;
+        const std::size_t to   = from + kFactor;
+        const std::int64_t x0  = dst.t.back();
+
+        double cx = 0.0, cy = 0.0;
+        for (std::size_t j = to; j < to + kFactor; ++j) {
+            cx += static_cast<double>(x[j] - x0);
+            cy += y[j];
+        }
+        cx /= static_cast<double>(kFactor);
+        cy /= static_cast<double>(kFactor);
+
+        const std::size_t pick = pickInBucket(x, y, from, to, x0, 0.0, dst.v.back(), cx, cy);
+        dst.t.push_back(x[pick]);
+        dst.v.push_back(y[pick]);
+        dst.next = to;
+    }
+}
+
+void LttbPyramid::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    levels_.assign(1, Level{});
+}
+
+std::size_t LttbPyramid::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return levels_[0].t.size();
+}
+
+bool LttbPyramid::range(std::int64_t& firstUs, std::int64_t& lastUs) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Level& raw = levels_[0];
+    if (raw.t.empty())
+        return false;
+    firstUs = raw.t.front();
+    lastUs  = raw.t.back();
+    return true;
+}
+
+std::size_t LttbPyramid::countIn(const Level& l, std::int64_t fromUs, std::int64_t toUs) const
+{
+    const auto b = std::lower_bound(l.t.begin(), l.t.end(), fromUs);
+    const auto e = std::upper_bound(b, l.t.end(), toUs);
+    return static_cast<std::size_t>(e - b);
+}
+
+// level 의 [fromUs, toUs] 점 + 아직 이 level 로 올라오지 않은 꼬리 구간은 하위 level 에서 (mutex_ 보유)
+void LttbPyramid::gather(std::size_t level, std::int64_t fromUs, std::int64_t toUs) const
+{
+    const Level& l = levels_[level];
+    const auto b = std::lower_bound(l.t.begin(), l.t.end(), fromUs);
+    const auto e = std::upper_bound(b, l.t.end(), toUs);
+    const std::size_t first = static_cast<std::size_t>(b - l.t.begin());
+    const std::size_t last  = static_cast<std::size_t>(e - l.t.begin());
+    scratchT_.insert(scratchT_.end(), l.t.begin() + first, l.t.begin() + last);
+    scratchV_.insert(scratchV_.end(), l.v.begin() + first, l.v.begin() + last);
+
+    if (level == 0)
+        return;
+    if (l.t.empty())
+        gather(level - 1, fromUs, toUs);
+    else if (toUs > l.t.back())
+        gather(level - 1, std::max(fromUs, l.t.back() + 1), toUs);
+}
+
+std::size_t LttbPyramid::query(std::int64_t fromUs, std::int64_t toUs, std::size_t maxPoints,
+                               std::int64_t* outUs, float* outValue) const
+{
+    if (!outUs || !outValue || maxPoints == 0 || toUs < fromUs)
+        return 0;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // 창 안에 maxPoints * kOversample 개 이상 남는 가장 거친 level
+    std::size_t level = 0;
+    for (std::size_t l = levels_.size(); l-- > 1;) {
+        if (countIn(levels_[l], fromUs, toUs) >= maxPoints * kOversample) {
+            level = l;
+            break;
+        }
+    }
+
+    scratchT_.clear();
+    scratchV_.clear();
+    gather(level, fromUs, toUs);
+
+    // 거친 level 은 창 경계의 원본 점을 빠뜨릴 수 있다 -> 창의 첫/끝 원본 점은 항상 포함
+    const Level& raw = levels_[0];
+    const auto b = std::lower_bound(raw.t.begin(), raw.t.end(), fromUs);
+    const auto e = std::upper_bound(b, raw.t.end(), toUs);
+    if (b != e) {
+        const std::size_t first = static_cast<std::size_t>(b - raw.t.begin());
+        const std::size_t last  = static_cast<std::size_t>(e - raw.t.begin()) - 1;
+        if (scratchT_.empty() || raw.t[first] < scratchT_.front()) {
+            scratchT_.insert(scratchT_.begin(), raw.t[first]);
+            scratchV_.insert(scratchV_.begin(), raw.v[first]);
+        }
+        if (raw.t[last] > scratchT_.back()) {
+            scratchT_.push_back(raw.t[last]);
+            scratchV_.push_back(raw.v[last]);
+        }
+    }
+
+    return lttbDownsample(scratchT_.data(), scratchV_.data(), scratchT_.size(), maxPoints, outUs, outValue);
+}
@@ -0,0 +1,87 @@
+// vacuum_lttb.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "vacuum_acquisition.h"
+
+// Largest-Triangle-Three-Buckets 다운샘플링.
+// 첫/마지막 점을 유지하고, 가운데 점들을 (target - 2) 개 버킷으로 나눠 버킷마다
+// "직전 선택점 - 후보 - 다음 버킷 평균" 삼각형 면적이 가장 큰 점 하나를 고른다.
+// 결과는 항상 원본 점의 부분집합 (보간값 없음). target >= n 이면 그대로 복사.
+// 반환: 출력 개수
+std::size_t lttbDownsample(const std::int64_t* x, const float* y, std::size_t n, std::size_t target,
+                           std::int64_t* outX, float* outY);
+
+// 시계열 하나의 다중 해상도 LTTB 피라미드.
+//   level 0 = 원본, level k = level k-1 을 kFactor 개 버킷마다 LTTB 로 1 점 선택
+// append 시점에 버킷이 닫히는 대로 상위 level 을 채우므로 (다음 버킷 평균이 필요해 1 버킷 늦게)
+// query 는 창 안의 점이 maxPoints * kOversample 이상 남는 가장 거친 level 만 읽는다.
+// 창 크기와 무관하게 query 비용은 O(maxPoints), 원본이 몇 시간 분량이어도 같다.
+class LttbPyramid
+{
+public:
+    static constexpr std::size_t kFactor     = 4;
+    static constexpr std::size_t kOversample = 2;
+    static constexpr int         kMaxLevels  = 12;   // 4^11 원본 점 -> 1 점
+
+    // tUs 는 증가 순서로 append
+    void append(std::int64_t tUs, float value);
+    void clear();
+
+    std::size_t size() const;
+    bool range(std::int64_t& firstUs, std::int64_t& lastUs) const;
+
+    // [fromUs, toUs] 구간을 최대 maxPoints 개로 (maxPoints >= 3). 반환: 출력 개수
+    std::size_t query(std::int64_t fromUs, std::int64_t toUs, std::size_t maxPoints,
+                      std::int64_t* outUs, float* outValue) const;
+
+private:
+    struct Level {
+        std::vector<std::int64_t> t;
+        std::vector<float>        v;
+        std::size_t               next = 0;   // 하위 level 에서 아직 버킷으로 닫지 않은 첫 index
+    };
+
+    void promote(std::size_t level);
+    std::size_t countIn(const Level& l, std::int64_t fromUs, std::int64_t toUs) const;
+    void gather(std::size_t level, std::int64_t fromUs, std::int64_t toUs) const;
+
+    mutable std::mutex mutex_;
+    std::vector<Level> levels_ = std::vector<Level>(1);
+
+    // query 작업 버퍼 (mutex_ 보유 중에만 사용)
+    mutable std::vector<std::int64_t> scratchT_;
+    mutable std::vector<float>        scratchV_;
+};
+
+// 측정 세션의 채널별 압력 trace (ok 샘플만). acquisition 스레드가 record, UI 가 query
+class SessionTrace
+{
+public:
+    static constexpr int kChannels = AcquisitionTotals::kChannels;   // index = channel (0 미사용)
+
+    void record(const VacuumSample& s)
+    {
+        if (!s.ok)
+            return;
+        if (LttbPyramid* p = channel(s.channel))
+            p->append(s.timestampNs / 1000, s.pressure);
+    }
+
+    void clear()
+    {
+        for (LttbPyramid& p : channels_)
+            p.clear();
+    }
+
+    // 범위 밖 채널은 nullptr
+    LttbPyramid* channel(int ch) { return ch >= 0 && ch < kChannels ? &channels_[ch] : nullptr; }
+    const LttbPyramid* channel(int ch) const { return ch >= 0 && ch < kChannels ? &channels_[ch] : nullptr; }
+
+private:
+    LttbPyramid channels_[kChannels];
+};
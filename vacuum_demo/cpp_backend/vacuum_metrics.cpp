@@ -0,0 +1,137 @@
+// vacuum_metrics.cpp
+
+#include "vacuum_metrics.h"
+
+#include <cstdio>
+#include <sstream>
+#include <utility>
+
+namespace {
+
+struct CounterDef {
+    const char* name;
+    const char* help;
+    std::atomic<std::uint64_t> DeviceMetrics::*field;
+};
+
+const CounterDef kCounters[] = {
+    {"vacuum_commands_total",       "Commands written to the serial port",          &DeviceMetrics::commands},
+    {"vacuum_responses_total",      "Response frames received",                     &DeviceMetrics::responses},
+    {"vacuum_timeouts_total",       "Commands that got no response",                &DeviceMetrics::timeouts},
+    {"vacuum_short_reads_total",    "Responses shorter than the expected frame",    &DeviceMetrics::shortReads},
+    {"vacuum_write_errors_total",   "Failed or timed out serial writes",            &DeviceMetrics::writeErrors},
+    {"vacuum_stale_bytes_total",    "Unmatched bytes discarded from the port",      &DeviceMetrics::staleBytes},
+    {"vacuum_resyncs_total",        "Pipeline resynchronisations after a timeout",  &DeviceMetrics::resyncs},
+    {"vacuum_reconnects_total",     "Reconnects to the same serial port",           &DeviceMetrics::reconnects},
+    {"vacuum_samples_total",        "Valid samples published by acquisition",       &DeviceMetrics::samples},
+    {"vacuum_failed_samples_total", "Failed samples published by acquisition",      &DeviceMetrics::failedSamples},
+};
+
+// Prometheus 쪽 bucket 경계 (us). HDR bucket 을 이 경계로 누적해서 내보낸다
+const std::uint64_t kRttBoundsUs[] = {
+    250, 500, 1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000, 500000, 1000000,
+};
+
+static_assert(sizeof(kCounters) / sizeof(kCounters[0]) == kMetricsCounters, "kMetricsCounters mismatch");
+static_assert(sizeof(kRttBoundsUs) / sizeof(kRttBoundsUs[0]) == kRttBounds, "kRttBounds mismatch");
+
+std::string escapeLabel(const std::string& v)
+{
+    std::string out;
+    for (char c : v) {
+        if (c == '\\' || c == '"')
+            out += '\\';
+        if (c == '\n') {
+            out += "\\n";
+            continue;
+        }
+        out += c;
+    }
+    return out;
+}
+
+} // namespace
+
+MetricsSource snapshotMetrics(std::string device, const DeviceMetrics& metrics, const LatencyHistogram* rtt)
+{
+    MetricsSource s;
+    s.device = std::move(device);
+    for (int i = 0; i < kMetricsCounters; ++i)
+        s.counters[i] = (metrics.*kCounters[i].field).load(std::memory_order_relaxed);
+
+    s.hasRtt = rtt != nullptr;
+    if (!rtt) {
+        for (std::uint64_t& b : s.rttBuckets)
+            b = 0;
+        return s;
+    }
+
+    std::uint64_t cumulative = 0;
+    int bucket = 0;
+    for (int i = 0; i < kRttBounds; ++i) {
+        while (bucket < LatencyHistogram::kBuckets && LatencyHistogram::upperBound(bucket) <= kRttBoundsUs[i])
+            cumulative += rtt->bucketCount(bucket++);
+        s.rttBuckets[i] = cumulative;
+    }
+    s.rttCount = rtt->count();
+    s.rttSumUs = rtt->sum();
+    return s;
+}
+
+std::string formatPrometheus(const std::vector<MetricsSource>& sources)
+{
+    std::ostringstream os;
+
+    for (int i = 0; i < kMetricsCounters; ++i) {
+        const CounterDef& c = kCounters[i];
+        os << "# HELP " << c.name << ' ' << c.help << '\n'
+           << "# TYPE " << c.name << " counter\n";
+        for (const MetricsSource& s : sources)
+            os << c.name << "{device=\"" << escapeLabel(s.device) << "\"} " << s.counters[i] << '\n';
+    }
+
+    os << "# HELP vacuum_rtt_seconds Command to response frame round-trip time\n"
+       << "# TYPE vacuum_rtt_seconds histogram\n";
+    for (const MetricsSource& s : sources) {
+        if (!s.hasRtt)
+            continue;
+        const std::string label = "device=\"" + escapeLabel(s.device) + "\"";
+
+        for (int i = 0; i < kRttBounds; ++i) {
+            os << "vacuum_rtt_seconds_bucket{" << label << ",le=\"" << kRttBoundsUs[i] / 1e6 << "\"} "
+               << s.rttBuckets[i] << '\n';
+        }
+        os << "vacuum_rtt_seconds_bucket{" << label << ",le=\"+Inf\"} " << s.rttCount << '\n'
+           << "vacuum_rtt_seconds_sum{" << label << "} " << s.rttSumUs / 1e6 << '\n'
+           << "vacuum_rtt_seconds_count{" << label << "} " << s.rttCount << '\n';
+    }
+
+    return os.str();
+}
+
+bool writePrometheusFile(const std::string& path, const std::vector<MetricsSource>& sources,
+                         std::string* error)
+{
+    const std::string text = formatPrometheus(sources);
+    const std::string tmp  = path + ".tmp";
+
+    std::FILE* f = std::fopen(tmp.c_str(), "wb");
+    if (!f) {
+        if (error) *error = "cannot open " + tmp;
+        return false;
+    }
+
+    bool ok = std::fwrite(text.data(), 1, text.size(), f) == text.size();
+    ok = (std::fclose(f) == 0) && ok;
+#if defined(_WIN32)
+    if (ok)
+        std::remove(path.c_str());   // Windows rename 은 대상이 있으면 실패
+#endif
+    if (ok)
+        ok = std::rename(tmp.c_str(), path.c_str()) == 0;
+    if (!ok) {
+        std::remove(tmp.c_str());
+        if (error) *error = "write failed: " + path;
+    }
+    return ok;
+}
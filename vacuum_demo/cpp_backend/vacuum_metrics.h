@@ -0,0 +1,58 @@
+// vacuum_metrics.h
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "vacuum_latency_histogram.h"
+
+// 장비 1 대의 시리얼 링크 카운터. 어느 스레드에서든 relaxed 증가 (lock 없음).
+// 누적값만 보관하고 비율(samples/s 등)은 읽는 쪽이 두 snapshot 의 차이로 계산한다.
+struct DeviceMetrics {
+    std::atomic<std::uint64_t> commands{0};      // 전송 완료된 명령
+    std::atomic<std::uint64_t> responses{0};     // 응답 프레임 수신
+    std::atomic<std::uint64_t> timeouts{0};      // 응답 없음 (byte 0 개)
+    std::atomic<std::uint64_t> shortReads{0};    // 프레임 길이보다 적게 수신
+    std::atomic<std::uint64_t> writeErrors{0};   // write 실패 / waitForBytesWritten timeout
+    std::atomic<std::uint64_t> staleBytes{0};    // 요청과 매칭되지 않아 버린 byte
+    std::atomic<std::uint64_t> resyncs{0};       // pipeline resync
+    std::atomic<std::uint64_t> reconnects{0};    // 같은 포트 재연결
+    std::atomic<std::uint64_t> samples{0};       // 발행된 정상 샘플
+    std::atomic<std::uint64_t> failedSamples{0}; // 발행된 ok=0 샘플
+
+    static void add(std::atomic<std::uint64_t>& counter, std::uint64_t n = 1)
+    {
+        counter.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    void reset()
+    {
+        for (std::atomic<std::uint64_t>* c : {&commands, &responses, &timeouts, &shortReads, &writeErrors,
+                                              &staleBytes, &resyncs, &reconnects, &samples, &failedSamples})
+            c->store(0, std::memory_order_relaxed);
+    }
+};
+
+// Prometheus text exposition format 으로 여러 장비를 한 파일에 기록.
+// 장비 핸들을 잡고 있는 동안에는 snapshotMetrics 로 값만 복사하고, 포맷/파일 쓰기는 그 뒤에 한다
+constexpr int kMetricsCounters = 10;   // DeviceMetrics 카운터 수
+constexpr int kRttBounds       = 12;   // vacuum_rtt_seconds bucket 경계 수 (+Inf 제외)
+
+struct MetricsSource {
+    std::string   device;                       // label 값 (포트 이름)
+    std::uint64_t counters[kMetricsCounters];   // vacuum_metrics.cpp kCounters 순서
+    bool          hasRtt = false;
+    std::uint64_t rttBuckets[kRttBounds];       // 경계별 누적 수
+    std::uint64_t rttCount = 0;
+    std::uint64_t rttSumUs = 0;
+};
+
+MetricsSource snapshotMetrics(std::string device, const DeviceMetrics& metrics, const LatencyHistogram* rtt);
+
+std::string formatPrometheus(const std::vector<MetricsSource>& sources);
+
+// 임시 파일에 쓴 뒤 rename (node_exporter textfile collector 가 반쯤 쓴 파일을 읽지 않게)
+bool writePrometheusFile(const std::string& path, const std::vector<MetricsSource>& sources,
+                         std::string* error = nullptr);
@@ -0,0 +1,118 @@
+// vacuum_moving_average.h
+#pragma once
+
+#include <cstddef>
+#include <variant>
+
+// 고정 크기 ring buffer 이동 평균. push 1회 = O(1) (누적합 갱신)
+// 창이 차기 전에는 지금까지 들어온 값들의 평균을 반환한다.
+template<std::size_t N>
+class MovingAverage
+{
+    static_assert(N > 0, "window must be > 0");
+
+public:
+    static constexpr std::size_t kWindow = N;
+
+    float push(float value)
+    {
+        if (count_ < N) {
+            ++count_;
+        } else {
+            sum_ -= values_[head_];
+        }
+        values_[head_] = value;
+        sum_ += value;
+        head_ = (head_ + 1 == N) ? 0 : head_ + 1;
+
+        // 창이 한 바퀴 돌 때마다 누적 오차 제거
+        if (head_ == 0 && count_ == N) {
+            double exact = 0.0;
+            for (std::size_t i = 0; i < N; ++i)
+                exact += values_[i];
+            sum_ = exact;
+        }
+        return average();
+    }
+
+    float average() const
+    {
+        return count_ ? static_cast<float>(sum_ / static_cast<double>(count_)) : 0.0f;
+    }
+
+    // O(1): 이전 값은 count_ 밖이므로 다시 쓰기 전까지 읽히지 않음
+    void clear()
+    {
+        sum_   = 0.0;
+        head_  = 0;
+        count_ = 0;
+    }
+
+    std::size_t size() const { return count_; }
+    bool full() const { return count_ == N; }
+    static constexpr std::size_t window() { return N; }
+
+private:
+    float       values_[N] = {};
+    double      sum_   = 0.0;
+    std::size_t head_  = 0;
+    std::size_t count_ = 0;
+};
+
+// 채널별로 창 크기를 고를 수 있는 이동 평균 (5 / 10 / 20 / 50 / 100 샘플).
+// 창 크기별 타입을 variant 로 들고 있으므로 push 는 여전히 O(1) 이다.
+class AveragingFilter
+{
+public:
+    static constexpr int kDefaultWindow = 5;
+
+    static bool isSupportedWindow(int window)
+    {
+        return window == 5 || window == 10 || window == 20 || window == 50 || window == 100;
+    }
+
+    explicit AveragingFilter(int window = kDefaultWindow) { setWindow(window); }
+
+    // 지원하지 않는 크기면 false (기존 창 유지). 창을 바꾸면 내용은 비워진다
+    bool setWindow(int window)
+    {
+        switch (window) {
+        case 5:   filter_.emplace<MovingAverage<5>>();   break;
+        case 10:  filter_.emplace<MovingAverage<10>>();  break;
+        case 20:  filter_.emplace<MovingAverage<20>>();  break;
+        case 50:  filter_.emplace<MovingAverage<50>>();  break;
+        case 100: filter_.emplace<MovingAverage<100>>(); break;
+        default:  return false;
+        }
+        return true;
+    }
+
+    int window() const
+    {
+        return std::visit([](const auto& f) { return static_cast<int>(f.window()); }, filter_);
+    }
+
+    float push(float value)
+    {
+        return std::visit([value](auto& f) { return f.push(value); }, filter_);
+    }
+
+    float average() const
+    {
+        return std::visit([](const auto& f) { return f.average(); }, filter_);
+    }
+
+    void clear()
+    {
+        std::visit([](auto& f) { f.clear(); }, filter_);
+    }
+
+    std::size_t size() const
+    {
+        return std::visit([](const auto& f) { return f.size(); }, filter_);
+    }
+
+private:
+    std::variant<MovingAverage<5>, MovingAverage<10>, MovingAverage<20>,
+                 MovingAverage<50>, MovingAverage<100>> filter_;
+};
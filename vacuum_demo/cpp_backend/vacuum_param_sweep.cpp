@@ -0,0 +1,266 @@
+// vacuum_param_sweep.cpp
+//
+// 판정 파라미터 격자를 라벨된 corpus 에 대해 평가해서 격자 점별 false-pass / false-fail 비율과
+// 평균 검사 시간을 출력한다 (vacuum_sweep.h).
+//
+//   vacuum_param_sweep (DB | --corpus FILE) [--since yyyy-MM-dd] [--save-corpus FILE]
+//                      [--labels CSV] [--stored-as-label] [--channel 1|2]
+//                      [--start-offset LIST] [--window LIST] [--duration LIST] [--hrate LIST]
+//                      [--min-diff LIST] [--min-press LIST] [--offset-clamp LIST]
+//                      [--max-false-pass RATE] [--top N] [--threads N] [--csv FILE]
+//
+// LIST = "a,b,c" 또는 "from:to:step". 주지 않은 차원은 현재 기본값 하나
+// (준비시간/hrate 는 평가할 trace 채널의 기본값. PAK/CHUCK 이 섞인 corpus 는 --channel 이나
+//  --start-offset, --hrate 를 모두 줘야 한다).
+// 상위 N 개: false-pass 비율이 --max-false-pass (기본 0) 이하인 점 중 false-fail 비율, 평균 검사 시간 순.
+// 최대 압력(옛 MAXPRESS) 은 판정식(measureAndDecide)에서 쓰이지 않으므로 격자 차원이 아니다.
+
+#include "vacuum_sweep.h"
+#include "vacuum_work_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <QtCore/QCoreApplication>
+
+namespace {
+
+int usage()
+{
+    std::fprintf(stderr,
+                 "usage: vacuum_param_sweep (DB | --corpus FILE) [--since yyyy-MM-dd] [--save-corpus FILE]\n"
+                 "                          [--labels CSV] [--stored-as-label] [--channel 1|2]\n"
+                 "                          [--start-offset LIST] [--window LIST] [--duration LIST] [--hrate LIST]\n"
+                 "                          [--min-diff LIST] [--min-press LIST] [--offset-clamp LIST]\n"
+                 "                          [--max-false-pass RATE] [--top N] [--threads N] [--csv FILE]\n"
+                 "  LIST = a,b,c | from:to:step\n");
+    return 2;
+}
+
+// "a,b,c" 또는 "from:to:step"
+template <typename T>
+bool parseList(const char* text, std::vector<T>& out)
+{
+    out.clear();
+    double from = 0.0, to = 0.0, step = 0.0;
+    if (std::sscanf(text, "%lf:%lf:%lf", &from, &to, &step) == 3) {
+        if (step <= 0.0 || to < from)
+            return false;
+        const long n = static_cast<long>(std::floor((to - from) / step + 1e-6)) + 1;
+        for (long i = 0; i < n; ++i)
+            out.push_back(static_cast<T>(from + static_cast<double>(i) * step));
+        return true;
+    }
+    const char* p = text;
+    while (*p) {
+        char* end = nullptr;
+        const double v = std::strtod(p, &end);
+        if (end == p)
+            return false;
+        out.push_back(static_cast<T>(v));
+        p = (*end == ',') ? end + 1 : end;
+        if (*end && *end != ',')
+            return false;
+    }
+    return !out.empty();
+}
+
+void printPoint(std::FILE* out, const SweepResult& r)
+{
+    const SweepPoint& p = r.point;
+    std::fprintf(out, "offset %5.1f  win %3d  dur %5.0f  hrate %.2f  minDiff %.2f  minPress %5.1f  clamp %5.1f  "
+                      "| FP %6.2f%%  FF %6.2f%%  cycle %6.1fs  incomplete %u\n",
+                 p.startOffsetSec, p.averagingWindow, p.durationSec, p.hrate, p.minDiff, p.minPress, p.offsetClamp,
+                 r.falsePassRate() * 100.0, r.falseFailRate() * 100.0, r.meanCycleSec(), r.incomplete);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);   // QSQLITE plugin 경로
+
+    std::string dbPath, corpusPath, savePath, since, labelsPath, csvPath;
+    bool   storedAsLabel = false;
+    int    channel = 0;
+    int    threads = 0;
+    int    top = 10;
+    double maxFalsePass = 0.0;
+
+    SweepGrid grid;
+    bool hasOffset = false, hasHrate = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        bool ok = true;
+        if (!std::strcmp(a, "--stored-as-label")) {
+            storedAsLabel = true;
+        } else if (!hasValue && a[0] == '-') {
+            return usage();
+        } else if (!std::strcmp(a, "--corpus")) {
+            corpusPath = argv[++i];
+        } else if (!std::strcmp(a, "--save-corpus")) {
+            savePath = argv[++i];
+        } else if (!std::strcmp(a, "--since")) {
+            since = argv[++i];
+        } else if (!std::strcmp(a, "--labels")) {
+            labelsPath = argv[++i];
+        } else if (!std::strcmp(a, "--csv")) {
+            csvPath = argv[++i];
+        } else if (!std::strcmp(a, "--channel")) {
+            channel = std::atoi(argv[++i]);
+        } else if (!std::strcmp(a, "--threads")) {
+            threads = std::atoi(argv[++i]);
+        } else if (!std::strcmp(a, "--top")) {
+            top = std::atoi(argv[++i]);
+        } else if (!std::strcmp(a, "--max-false-pass")) {
+            maxFalsePass = std::atof(argv[++i]);
+        } else if (!std::strcmp(a, "--start-offset")) {
+            ok = parseList(argv[++i], grid.startOffsetSec);
+            hasOffset = true;
+        } else if (!std::strcmp(a, "--window")) {
+            ok = parseList(argv[++i], grid.averagingWindow);
+        } else if (!std::strcmp(a, "--duration")) {
+            ok = parseList(argv[++i], grid.durationSec);
+        } else if (!std::strcmp(a, "--hrate")) {
+            ok = parseList(argv[++i], grid.hrate);
+            hasHrate = true;
+        } else if (!std::strcmp(a, "--min-diff")) {
+            ok = parseList(argv[++i], grid.minDiff);
+        } else if (!std::strcmp(a, "--min-press")) {
+            ok = parseList(argv[++i], grid.minPress);
+        } else if (!std::strcmp(a, "--offset-clamp")) {
+            ok = parseList(argv[++i], grid.offsetClamp);
+        } else if (a[0] != '-' && dbPath.empty()) {
+            dbPath = a;
+        } else {
+            return usage();
+        }
+        if (!ok) {
+            std::fprintf(stderr, "bad list for %s: %s\n", a, argv[i]);
+            return 2;
+        }
+    }
+    if (dbPath.empty() == corpusPath.empty() || channel < 0 || channel > 2)
+        return usage();
+    for (int w : grid.averagingWindow) {
+        if (!AveragingFilter::isSupportedWindow(w)) {
+            std::fprintf(stderr, "--window must be 5, 10, 20, 50 or 100\n");
+            return 2;
+        }
+    }
+
+    ReplayCorpus corpus;
+    std::string error;
+    const bool loaded = corpusPath.empty() ? corpus.loadDatabase(dbPath, since, &error)
+                                           : corpus.load(corpusPath, &error);
+    if (!loaded) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    if (!labelsPath.empty()) {
+        const std::size_t labeled = corpus.loadLabels(labelsPath, &error);
+        if (!error.empty()) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+        std::printf("# %zu traces labeled from %s\n", labeled, labelsPath.c_str());
+    }
+    if (!savePath.empty() && !corpus.save(savePath, &error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    // 채널 기본값 (replayConfig / sessionConfig 와 같음). 격자 점 하나는 모든 trace 에 같은 값을 쓰므로
+    // 채널이 섞여 있으면 한쪽 채널 기본값으로 다른 채널을 채점하게 된다
+    if (!hasOffset || !hasHrate) {
+        int defaultsChannel = channel;
+        if (defaultsChannel == 0) {
+            bool seen[3] = {};
+            for (std::size_t i = 0; i < corpus.size(); ++i) {
+                const ReplayCorpus::Trace& t = corpus.trace(i);
+                const int label = t.label >= 0 ? t.label : (storedAsLabel ? t.storedPass : -1);
+                if (label >= 0)
+                    seen[t.channel == 1 ? 1 : 2] = true;
+            }
+            if (seen[1] && seen[2]) {
+                std::fprintf(stderr, "corpus mixes PAK and CHUCK traces: give --channel 1|2 "
+                                     "or both --start-offset and --hrate\n");
+                return 2;
+            }
+            defaultsChannel = seen[1] ? 1 : 2;
+        }
+        const VacuumReplayParams defaults = defaultReplayParams();
+        if (!hasOffset)
+            grid.startOffsetSec = {defaultsChannel == 1 ? defaults.vacStartOffsetSec : defaults.chkStartOffsetSec};
+        if (!hasHrate)
+            grid.hrate = {defaultsChannel == 1 ? defaults.hratePak : defaults.hrateChuck};
+    }
+
+    const WorkStealingPool pool(threads);
+    const auto started = std::chrono::steady_clock::now();
+    const std::vector<SweepResult> results = runSweep(corpus, grid, pool, channel, storedAsLabel);
+    const double elapsedMs =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+
+    if (!csvPath.empty()) {
+        std::FILE* out = std::fopen(csvPath.c_str(), "w");
+        if (!out) {
+            std::perror(csvPath.c_str());
+            return 1;
+        }
+        std::fprintf(out, "start_offset,window,duration,hrate,min_diff,min_press,offset_clamp,"
+                          "good,bad,false_pass,false_fail,incomplete,false_pass_rate,false_fail_rate,mean_cycle_sec\n");
+        for (const SweepResult& r : results) {
+            const SweepPoint& p = r.point;
+            std::fprintf(out, "%g,%d,%g,%g,%g,%g,%g,%u,%u,%u,%u,%u,%.6f,%.6f,%.2f\n", p.startOffsetSec,
+                         p.averagingWindow, p.durationSec, p.hrate, p.minDiff, p.minPress, p.offsetClamp,
+                         r.goodEvaluated, r.badEvaluated, r.falsePass, r.falseFail, r.incomplete, r.falsePassRate(),
+                         r.falseFailRate(), r.meanCycleSec());
+        }
+        std::fclose(out);
+    }
+
+    // 상위 N 개
+    std::vector<std::size_t> order;
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        if (results[i].goodEvaluated + results[i].badEvaluated > 0 &&
+            results[i].falsePassRate() <= maxFalsePass + 1e-12)
+            order.push_back(i);
+    }
+    const std::size_t shown = std::min(order.size(), static_cast<std::size_t>(std::max(0, top)));
+    std::partial_sort(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(shown), order.end(),
+                      [&results](std::size_t a, std::size_t b) {
+                          const SweepResult& x = results[a];
+                          const SweepResult& y = results[b];
+                          if (x.falseFailRate() != y.falseFailRate())
+                              return x.falseFailRate() < y.falseFailRate();
+                          if (x.meanCycleSec() != y.meanCycleSec())
+                              return x.meanCycleSec() < y.meanCycleSec();
+                          return x.falsePassRate() < y.falsePassRate();
+                      });
+    for (std::size_t i = 0; i < shown; ++i)
+        printPoint(stdout, results[order[i]]);
+
+    std::size_t good = 0, bad = 0;
+    for (std::size_t i = 0; i < corpus.size(); ++i) {
+        const ReplayCorpus::Trace& t = corpus.trace(i);
+        if (channel != 0 && t.channel != channel)
+            continue;
+        const int label = t.label >= 0 ? t.label : (storedAsLabel ? t.storedPass : -1);
+        good += label == 1;
+        bad += label == 0;
+    }
+    std::printf("# %zu points x %zu labeled traces (%zu good, %zu bad), %d threads, %.1f ms\n", results.size(),
+                good + bad, good, bad, pool.threads(), elapsedMs);
+    std::printf("# %zu points with false-pass rate <= %g\n", order.size(), maxFalsePass);
+    return 0;
+}
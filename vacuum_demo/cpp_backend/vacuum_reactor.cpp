@@ -0,0 +1,470 @@
+// vacuum_reactor.cpp
+
+#include "vacuum_reactor.h"
+
+#if defined(__linux__)
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace {
+
+// epoll data: (portId << 1) | isTimer, wake eventfd 는 0
+constexpr std::uint64_t kWakeTag = 0;
+
+std::uint64_t tagOf(int portId, bool timer)
+{
+    return (static_cast<std::uint64_t>(portId) << 1) | (timer ? 1u : 0u);
+}
+
+speed_t toSpeed(int baud)
+{
+    switch (baud) {
+    case 9600:   return B9600;
+    case 38400:  return B38400;
+    case 57600:  return B57600;
+    case 115200: return B115200;
+    case 19200:
+    default:     return B19200;
+    }
+}
+
+// VacuumDevice::buildCommand 의 VAC1/VAC2. 그 외 채널(STP3 등)은 압력 응답이 없으므로 발행하지 않음
+bool buildCommand(int channel, unsigned char cmd[5])
+{
+    if (channel != 1 && channel != 2)
+        return false;
+    cmd[0] = 'V';
+    cmd[1] = 'A';
+    cmd[2] = 'C';
+    cmd[3] = static_cast<unsigned char>('0' + channel);
+    cmd[4] = 0x00;
+    return true;
+}
+
+} // namespace
+
+VacuumReactor& VacuumReactor::shared()
+{
+    static VacuumReactor inst;
+    return inst;
+}
+
+VacuumReactor::VacuumReactor()
+{
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd_  = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    epoll_event ev{};
+    ev.events   = EPOLLIN;
+    ev.data.u64 = kWakeTag;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &ev);
+}
+
+VacuumReactor::~VacuumReactor()
+{
+    if (thread_.joinable()) {
+        stopRequested_.store(true, std::memory_order_release);
+        wake();
+        thread_.join();
+    }
+
+    for (auto& kv : ports_)
+        closePort(kv.second);
+    ports_.clear();
+
+    if (wakeFd_ >= 0)  ::close(wakeFd_);
+    if (epollFd_ >= 0) ::close(epollFd_);
+}
+
+std::int64_t VacuumReactor::nowNs()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+int VacuumReactor::openSerial(const std::string& path, int baud)
+{
+    const int fd = ::open(path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        std::fprintf(stderr, "[Reactor] open %s failed: %s\n", path.c_str(), std::strerror(errno));
+        return -1;
+    }
+
+    termios tio{};
+    if (tcgetattr(fd, &tio) != 0) {
+        ::close(fd);
+        return -1;
+    }
+
+    // 19200 8N1, no flow control, raw
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, toSpeed(baud));
+    cfsetospeed(&tio, toSpeed(baud));
+    tio.c_cflag |= (CLOCAL | CREAD);
+    tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+    tio.c_cc[VMIN]  = 0;
+    tio.c_cc[VTIME] = 0;
+
+    if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+        ::close(fd);
+        return -1;
+    }
+
+    tcflush(fd, TCIOFLUSH);
+    return fd;
+}
+
+bool VacuumReactor::armTimer(int timerFd, int periodMs)
+{
+    itimerspec spec{};
+    spec.it_interval.tv_sec  = periodMs / 1000;
+    spec.it_interval.tv_nsec = static_cast<long>(periodMs % 1000) * 1000000L;
+    spec.it_value.tv_nsec    = 1;   // 즉시 첫 발행
+    return timerfd_settime(timerFd, 0, &spec, nullptr) == 0;
+}
+
+bool VacuumReactor::ensureThread()
+{
+    if (thread_.joinable())
+        return true;
+
+    if (epollFd_ < 0 || wakeFd_ < 0)
+        return false;
+
+    stopRequested_.store(false, std::memory_order_release);
+    thread_ = std::thread(&VacuumReactor::run, this);
+    return true;
+}
+
+void VacuumReactor::wake()
+{
+    const std::uint64_t one = 1;
+    const ssize_t n = ::write(wakeFd_, &one, sizeof(one));
+    (void)n;
+}
+
+int VacuumReactor::addPort(const std::string& path, int baud, Client* client)
+{
+    if (!client)
+        return -1;
+
+    const int fd = openSerial(path, baud);
+    if (fd < 0)
+        return -1;
+
+    const int timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timerFd < 0) {
+        ::close(fd);
+        return -1;
+    }
+
+    Command cmd;
+    cmd.add           = true;
+    cmd.port.id       = nextId_.fetch_add(1, std::memory_order_relaxed);
+    cmd.port.fd       = fd;
+    cmd.port.timerFd  = timerFd;
+    cmd.port.client   = client;
+
+    std::future<void> done = cmd.done.get_future();
+    {
+        std::lock_guard<std::mutex> lock(commandMutex_);
+        if (dead_.load(std::memory_order_relaxed) || !ensureThread()) {
+            ::close(timerFd);
+            ::close(fd);
+            return -1;
+        }
+        commands_.push_back(&cmd);
+    }
+    wake();
+    done.wait();
+
+    return cmd.port.fd >= 0 ? cmd.port.id : -1;
+}
+
+void VacuumReactor::removePort(int portId)
+{
+    Command cmd;
+    cmd.add     = false;
+    cmd.port.id = portId;
+
+    std::future<void> done = cmd.done.get_future();
+    {
+        std::lock_guard<std::mutex> lock(commandMutex_);
+        if (!thread_.joinable() || dead_.load(std::memory_order_relaxed))
+            return;   // 죽은 reactor 는 포트를 이미 모두 닫았음
+        commands_.push_back(&cmd);
+    }
+    wake();
+    done.wait();
+}
+
+// ───────────────────────────────────────
+//  reactor thread
+// ───────────────────────────────────────
+void VacuumReactor::run()
+{
+    constexpr int kMaxEvents = 64;
+    epoll_event events[kMaxEvents];
+
+    while (!stopRequested_.load(std::memory_order_acquire)) {
+        const int n = epoll_wait(epollFd_, events, kMaxEvents, -1);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            std::fprintf(stderr, "[Reactor] epoll_wait: %s\n", std::strerror(errno));
+            failAll();
+            break;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            const std::uint64_t tag = events[i].data.u64;
+
+            if (tag == kWakeTag) {
+                std::uint64_t v = 0;
+                const ssize_t r = ::read(wakeFd_, &v, sizeof(v));
+                (void)r;
+                processCommands();
+                continue;
+            }
+
+            const int  id      = static_cast<int>(tag >> 1);
+            const bool isTimer = (tag & 1u) != 0;
+
+            auto it = ports_.find(id);
+            if (it == ports_.end())
+                continue;   // 같은 batch 에서 제거된 포트
+            Port& port = it->second;
+
+            if (isTimer) {
+                onTimer(port);
+            } else if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                Client* client = port.client;
+                closePort(port);
+                ports_.erase(it);
+                portCount_.fetch_sub(1, std::memory_order_relaxed);
+                client->onReactorError();
+            } else {
+                if (events[i].events & EPOLLOUT)
+                    onWritable(port);
+                if (events[i].events & EPOLLIN)
+                    onReadable(port);
+            }
+        }
+
+        timespec cpu{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu);
+        threadCpuNs_.store(static_cast<std::int64_t>(cpu.tv_sec) * 1000000000LL + cpu.tv_nsec,
+                           std::memory_order_relaxed);
+    }
+}
+
+// epoll 이 더 이상 동작하지 않음: 대기 중/이후 명령은 모두 실패, 등록된 포트는 오류 통지
+void VacuumReactor::failAll()
+{
+    std::vector<Command*> pending;
+    {
+        std::lock_guard<std::mutex> lock(commandMutex_);
+        dead_.store(true, std::memory_order_release);
+        pending.swap(commands_);
+    }
+
+    for (Command* cmd : pending) {
+        if (cmd->add) {
+            ::close(cmd->port.timerFd);
+            ::close(cmd->port.fd);
+            cmd->port.fd = -1;   // addPort 에 실패 전달
+        }
+        cmd->done.set_value();
+    }
+
+    std::unordered_map<int, Port> ports;
+    ports.swap(ports_);
+    portCount_.store(0, std::memory_order_relaxed);
+    for (auto& kv : ports) {
+        Client* client = kv.second.client;
+        closePort(kv.second);
+        client->onReactorError();
+    }
+}
+
+void VacuumReactor::processCommands()
+{
+    std::vector<Command*> pending;
+    {
+        std::lock_guard<std::mutex> lock(commandMutex_);
+        pending.swap(commands_);
+    }
+
+    for (Command* cmd : pending) {
+        if (cmd->add) {
+            Port port = cmd->port;
+            port.periodMs = port.client->reactorPeriodMs();
+
+            epoll_event ev{};
+            ev.events   = EPOLLIN;
+            ev.data.u64 = tagOf(port.id, false);
+            const bool okFd = epoll_ctl(epollFd_, EPOLL_CTL_ADD, port.fd, &ev) == 0;
+
+            ev.data.u64 = tagOf(port.id, true);
+            const bool okTimer = epoll_ctl(epollFd_, EPOLL_CTL_ADD, port.timerFd, &ev) == 0;
+
+            if (okFd && okTimer && armTimer(port.timerFd, port.periodMs)) {
+                ports_.emplace(port.id, std::move(port));
+                portCount_.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                closePort(port);
+                cmd->port.fd = -1;   // addPort 에 실패 전달
+            }
+        } else {
+            auto it = ports_.find(cmd->port.id);
+            if (it != ports_.end()) {
+                closePort(it->second);
+                ports_.erase(it);
+                portCount_.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+        cmd->done.set_value();
+    }
+}
+
+void VacuumReactor::onTimer(Port& port)
+{
+    std::uint64_t expirations = 0;
+    const ssize_t r = ::read(port.timerFd, &expirations, sizeof(expirations));
+    (void)r;
+
+    const std::int64_t now = nowNs();
+
+    // 주기가 바뀌었으면 재설정
+    const int periodMs = port.client->reactorPeriodMs();
+    if (periodMs > 0 && periodMs != port.periodMs) {
+        port.periodMs = periodMs;
+        armTimer(port.timerFd, periodMs);
+    }
+
+    // 가장 오래된 명령 timeout -> 응답 유실. 밀린 매칭을 막기 위해 in-flight 전체 폐기
+    if (!port.inFlight.empty() &&
+        now - port.inFlight.front().sentNs > static_cast<std::int64_t>(kResponseTimeoutMs) * 1000000) {
+        port.lostChannels.clear();
+        for (const Pending& p : port.inFlight)
+            port.lostChannels.push_back(p.channel);
+        port.inFlight.clear();
+        tcflush(port.fd, TCIFLUSH);
+        port.discardUntilNs = now + static_cast<std::int64_t>(kResyncQuietMs) * 1000000;
+        port.client->onReactorTimeout(port.lostChannels.data(), static_cast<int>(port.lostChannels.size()));
+    }
+
+    if (now < port.discardUntilNs || port.pendingOutLen > 0)
+        return;   // resync 중이거나 이전 명령을 아직 다 못 보냄
+
+    int depth = port.client->reactorPipelineDepth();
+    if (depth < 1)
+        depth = 1;
+    if (static_cast<int>(port.inFlight.size()) >= depth)
+        return;   // 장비가 느림 -> 이번 슬롯 건너뜀
+
+    const int channel = port.client->reactorChannel();
+    unsigned char cmd[5];
+    if (!buildCommand(channel, cmd))
+        return;   // 압력 응답이 없는 채널
+
+    const ssize_t written = ::write(port.fd, cmd, sizeof(cmd));
+    if (written <= 0)
+        return;   // 출력 버퍼가 찼음 (아무것도 안 나감) -> 다음 슬롯에서 재시도
+
+    if (written < static_cast<ssize_t>(sizeof(cmd))) {
+        // 앞부분은 이미 전송됨 -> 나머지를 EPOLLOUT 에서 보내야 장비 쪽 framing 이 유지된다
+        port.pendingOutLen = static_cast<int>(sizeof(cmd) - static_cast<std::size_t>(written));
+        std::memcpy(port.pendingOut, cmd + written, static_cast<std::size_t>(port.pendingOutLen));
+        port.pendingCommand = {channel, now};
+        watchWritable(port, true);
+        return;
+    }
+
+    port.inFlight.push_back({channel, now});
+    port.client->onReactorCommand();
+}
+
+void VacuumReactor::onWritable(Port& port)
+{
+    while (port.pendingOutLen > 0) {
+        const ssize_t n = ::write(port.fd, port.pendingOut, static_cast<std::size_t>(port.pendingOutLen));
+        if (n <= 0)
+            return;   // 아직 가득 참 -> 다음 EPOLLOUT
+        port.pendingOutLen -= static_cast<int>(n);
+        std::memmove(port.pendingOut, port.pendingOut + n, static_cast<std::size_t>(port.pendingOutLen));
+    }
+
+    // 명령이 다 나간 시점부터 응답 대기 (timeout 기준)
+    port.inFlight.push_back({port.pendingCommand.channel, nowNs()});
+    port.client->onReactorCommand();
+    watchWritable(port, false);
+}
+
+bool VacuumReactor::watchWritable(Port& port, bool enable)
+{
+    epoll_event ev{};
+    ev.events   = EPOLLIN | (enable ? EPOLLOUT : 0u);
+    ev.data.u64 = tagOf(port.id, false);
+    return epoll_ctl(epollFd_, EPOLL_CTL_MOD, port.fd, &ev) == 0;
+}
+
+void VacuumReactor::onReadable(Port& port)
+{
+    unsigned char buf[256];
+
+    for (;;) {
+        const ssize_t n = ::read(port.fd, buf, sizeof(buf));
+        if (n <= 0)
+            break;
+
+        const std::int64_t now = nowNs();
+        if (now < port.discardUntilNs) {
+            port.client->onReactorStale(static_cast<int>(n));   // resync 중 늦게 도착한 응답
+            continue;
+        }
+
+        int stale = 0;
+        for (ssize_t i = 0; i < n; ++i) {
+            if (port.inFlight.empty()) {
+                ++stale;   // 요청하지 않은 바이트
+                continue;
+            }
+
+            const Pending p = port.inFlight.front();
+            port.inFlight.pop_front();
+            port.client->onReactorSample(p.channel, buf[i], p.sentNs, now);
+        }
+        if (stale > 0)
+            port.client->onReactorStale(stale);
+    }
+}
+
+void VacuumReactor::closePort(Port& port)
+{
+    if (port.timerFd >= 0) {
+        epoll_ctl(epollFd_, EPOLL_CTL_DEL, port.timerFd, nullptr);
+        ::close(port.timerFd);
+        port.timerFd = -1;
+    }
+    if (port.fd >= 0) {
+        epoll_ctl(epollFd_, EPOLL_CTL_DEL, port.fd, nullptr);
+        ::close(port.fd);
+        port.fd = -1;
+    }
+    port.inFlight.clear();
+    port.pendingOutLen = 0;
+}
+
+#endif // __linux__
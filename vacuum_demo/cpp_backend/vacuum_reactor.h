@@ -0,0 +1,134 @@
+// vacuum_reactor.h
+#pragma once
+
+// Linux 전용 transport: termios raw fd + epoll + timerfd.
+// 하나의 reactor 스레드가 여러 포트의 명령 발행 / timeout / 응답 파싱을 모두 처리한다.
+// Qt 에 의존하지 않으므로 benchmark 에서도 그대로 사용한다.
+
+#if defined(__linux__)
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class VacuumReactor
+{
+public:
+    // 포트 하나를 사용하는 쪽 (VacuumAcquisition, benchmark).
+    // 모든 콜백은 reactor 스레드에서 호출된다.
+    class Client
+    {
+    public:
+        virtual ~Client() = default;
+
+        virtual int reactorChannel() const = 0;
+        virtual int reactorPeriodMs() const = 0;
+        virtual int reactorPipelineDepth() const = 0;
+
+        virtual void onReactorSample(int channel, std::uint8_t raw,
+                                     std::int64_t sentNs, std::int64_t receivedNs) = 0;
+        // 명령 5 byte 가 모두 전송됨 (일부만 나간 명령은 EPOLLOUT 에서 마저 보낸 뒤)
+        virtual void onReactorCommand() {}
+        // 요청과 매칭되지 않아 버린 byte (in-flight 없음 / resync 중 도착)
+        virtual void onReactorStale(int bytes) { (void)bytes; }
+        // 응답 유실 -> in-flight 전체 폐기 후 resync. channels[0..lost): 폐기한 명령의 채널 (발행 순)
+        virtual void onReactorTimeout(const int* channels, int lost) = 0;
+        // fd 오류/HUP. 이후 이 포트는 reactor 에서 제거된 상태
+        virtual void onReactorError() = 0;
+    };
+
+    static constexpr int kResponseTimeoutMs = 200;
+    static constexpr int kResyncQuietMs     = 50;
+
+    // 프로세스 공용 reactor
+    static VacuumReactor& shared();
+
+    VacuumReactor();
+    ~VacuumReactor();
+
+    VacuumReactor(const VacuumReactor&) = delete;
+    VacuumReactor& operator=(const VacuumReactor&) = delete;
+
+    // 포트를 열고 등록. 실패 시 (reactor 가 죽은 경우 포함) -1. 반환 후 즉시 주기 발행 시작
+    int addPort(const std::string& path, int baud, Client* client);
+
+    // 반환 시점 이후 client 콜백은 더 이상 호출되지 않는다
+    void removePort(int portId);
+
+    // epoll 오류로 reactor 스레드가 멈춤. 등록돼 있던 포트는 모두 onReactorError 를 받았고
+    // 이후 addPort 는 항상 실패한다
+    bool isDead() const { return dead_.load(std::memory_order_acquire); }
+
+    int portCount() const { return portCount_.load(std::memory_order_relaxed); }
+
+    // reactor 스레드가 사용한 CPU 시간 (ns)
+    std::int64_t threadCpuNs() const { return threadCpuNs_.load(std::memory_order_relaxed); }
+
+    static std::int64_t nowNs();
+
+private:
+    struct Pending {
+        int          channel;
+        std::int64_t sentNs;
+    };
+
+    struct Port {
+        int          id       = -1;
+        int          fd       = -1;
+        int          timerFd  = -1;
+        int          periodMs = 0;
+        Client*      client   = nullptr;
+        std::int64_t discardUntilNs = 0;
+        std::deque<Pending> inFlight;
+        std::vector<int>    lostChannels;   // onReactorTimeout 인자 (재사용 버퍼)
+
+        // write() 가 일부만 나간 명령. 나머지를 EPOLLOUT 에서 마저 보내기 전까지 새 명령 없음
+        unsigned char pendingOut[5] = {};
+        int           pendingOutLen = 0;
+        Pending       pendingCommand{0, 0};
+    };
+
+    struct Command {
+        bool               add = true;
+        Port               port;
+        std::promise<void> done;
+    };
+
+    bool ensureThread();
+    void run();
+    void wake();
+    void processCommands();
+    void failAll();
+
+    void onTimer(Port& port);
+    void onReadable(Port& port);
+    void onWritable(Port& port);
+    bool watchWritable(Port& port, bool enable);
+    void closePort(Port& port);
+
+    static int  openSerial(const std::string& path, int baud);
+    static bool armTimer(int timerFd, int periodMs);
+
+    int epollFd_ = -1;
+    int wakeFd_  = -1;
+
+    std::thread       thread_;
+    std::atomic<bool> stopRequested_{false};
+    std::atomic<bool> dead_{false};          // commandMutex_ 안에서 설정
+    std::atomic<int>  portCount_{0};
+    std::atomic<int>  nextId_{1};
+    std::atomic<std::int64_t> threadCpuNs_{0};   // loop 마다 갱신
+
+    std::mutex           commandMutex_;
+    std::vector<Command*> commands_;
+
+    std::unordered_map<int, Port> ports_;   // reactor 스레드 전용
+};
+
+#endif // __linux__
@@ -0,0 +1,288 @@
+// vacuum_reactor_bench.cpp
+//
+// VacuumReactor 확장성 측정.
+// 포트 수를 1, 2, 4 ... max 로 늘려가며 pty 쌍에 붙인 가짜 장비(응답 1 byte)를 구동하고
+// 샘플당 reactor CPU 시간, round-trip latency, 샘플 간격 jitter 를 출력한다.
+//
+//   vacuum_reactor_bench [--max-ports 32] [--seconds 5] [--period-ms 50]
+//                        [--depth 1] [--device-latency-ms 2]
+
+#include "vacuum_reactor.h"
+#include "vacuum_latency_histogram.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+namespace {
+
+struct Options {
+    int maxPorts        = 32;
+    int seconds         = 5;
+    int periodMs        = 50;
+    int depth           = 1;
+    int deviceLatencyMs = 2;
+};
+
+// ───────────────────────────────────────
+//  pty 기반 가짜 장비: 5-byte 명령마다 ADC 1 byte 응답
+// ───────────────────────────────────────
+class FakeDevices
+{
+public:
+    FakeDevices(int count, int latencyMs) : latencyNs_(static_cast<std::int64_t>(latencyMs) * 1000000)
+    {
+        epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+
+        for (int i = 0; i < count; ++i) {
+            const int master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+            if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+                std::perror("posix_openpt");
+                std::exit(1);
+            }
+
+            Dev dev;
+            dev.master    = master;
+            dev.slavePath = ptsname(master);
+            devs_.push_back(dev);
+
+            epoll_event ev{};
+            ev.events   = EPOLLIN;
+            ev.data.u32 = static_cast<std::uint32_t>(i);
+            epoll_ctl(epollFd_, EPOLL_CTL_ADD, master, &ev);
+        }
+
+        thread_ = std::thread(&FakeDevices::run, this);
+    }
+
+    ~FakeDevices()
+    {
+        stop_.store(true);
+        thread_.join();
+        for (Dev& d : devs_)
+            ::close(d.master);
+        ::close(epollFd_);
+    }
+
+    const std::string& path(int i) const { return devs_[static_cast<std::size_t>(i)].slavePath; }
+
+private:
+    struct Dev {
+        int         master = -1;
+        std::string slavePath;
+        int         partial = 0;   // 받은 명령 바이트 수 (5 byte 단위)
+    };
+
+    struct Due {
+        std::int64_t at;
+        int          dev;
+        bool operator>(const Due& o) const { return at > o.at; }
+    };
+
+    void run()
+    {
+        epoll_event events[64];
+        std::priority_queue<Due, std::vector<Due>, std::greater<Due>> due;
+
+        while (!stop_.load()) {
+            int timeoutMs = 10;
+            if (!due.empty()) {
+                const std::int64_t wait = due.top().at - VacuumReactor::nowNs();
+                timeoutMs = wait <= 0 ? 0 : static_cast<int>(wait / 1000000) + 1;
+                if (timeoutMs > 10) timeoutMs = 10;
+            }
+
+            const int n = epoll_wait(epollFd_, events, 64, timeoutMs);
+            for (int i = 0; i < n; ++i) {
+                Dev& d = devs_[events[i].data.u32];
+                unsigned char buf[256];
+                const ssize_t r = ::read(d.master, buf, sizeof(buf));
+                if (r <= 0)
+                    continue;
+
+                d.partial += static_cast<int>(r);
+                while (d.partial >= 5) {
+                    d.partial -= 5;
+                    due.push({VacuumReactor::nowNs() + latencyNs_, static_cast<int>(events[i].data.u32)});
+                }
+            }
+
+            const std::int64_t now = VacuumReactor::nowNs();
+            while (!due.empty() && due.top().at <= now) {
+                const unsigned char adc = 100;
+                const ssize_t w = ::write(devs_[static_cast<std::size_t>(due.top().dev)].master, &adc, 1);
+                (void)w;
+                due.pop();
+            }
+        }
+    }
+
+    std::int64_t      latencyNs_;
+    int               epollFd_ = -1;
+    std::vector<Dev>  devs_;
+    std::thread       thread_;
+    std::atomic<bool> stop_{false};
+};
+
+// ───────────────────────────────────────
+//  reactor client: 통계 수집 (reactor 스레드에서만 갱신)
+// ───────────────────────────────────────
+class BenchClient : public VacuumReactor::Client
+{
+public:
+    BenchClient(int periodMs, int depth, LatencyHistogram* rtt)
+        : periodMs_(periodMs), depth_(depth), rtt_(rtt) {}
+
+    int reactorChannel() const override { return 1; }
+    int reactorPeriodMs() const override { return periodMs_; }
+    int reactorPipelineDepth() const override { return depth_; }
+
+    void onReactorSample(int, std::uint8_t, std::int64_t sentNs, std::int64_t receivedNs) override
+    {
+        rtt_->record(static_cast<std::uint64_t>((receivedNs - sentNs) / 1000));
+
+        if (lastRxNs_ != 0) {
+            const double dev = static_cast<double>(receivedNs - lastRxNs_) / 1000.0 - periodMs_ * 1000.0;
+            jitterSum_   += dev;
+            jitterSumSq_ += dev * dev;
+            ++intervals_;
+        }
+        lastRxNs_ = receivedNs;
+        samples.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void onReactorTimeout(const int*, int lost) override { timeouts.fetch_add(lost, std::memory_order_relaxed); }
+    void onReactorError() override { errors.fetch_add(1, std::memory_order_relaxed); }
+
+    // 포트 제거 후에만 호출
+    double jitterStddevUs() const
+    {
+        if (intervals_ < 2)
+            return 0.0;
+        const double mean = jitterSum_ / intervals_;
+        return std::sqrt(std::max(0.0, jitterSumSq_ / intervals_ - mean * mean));
+    }
+
+    std::atomic<std::uint64_t> samples{0};
+    std::atomic<std::uint64_t> timeouts{0};
+    std::atomic<std::uint64_t> errors{0};
+
+private:
+    int               periodMs_;
+    int               depth_;
+    LatencyHistogram* rtt_;
+
+    std::int64_t lastRxNs_    = 0;
+    double       jitterSum_   = 0.0;
+    double       jitterSumSq_ = 0.0;
+    std::uint64_t intervals_  = 0;
+};
+
+void runStep(const Options& opt, int ports)
+{
+    FakeDevices devices(ports, opt.deviceLatencyMs);
+    VacuumReactor reactor;
+    LatencyHistogram rtt;
+
+    std::vector<std::unique_ptr<BenchClient>> clients;
+    std::vector<int> ids;
+
+    for (int i = 0; i < ports; ++i) {
+        clients.emplace_back(new BenchClient(opt.periodMs, opt.depth, &rtt));
+        const int id = reactor.addPort(devices.path(i), 19200, clients.back().get());
+        if (id < 0) {
+            std::fprintf(stderr, "addPort failed: %s\n", devices.path(i).c_str());
+            std::exit(1);
+        }
+        ids.push_back(id);
+    }
+
+    const std::int64_t cpu0 = reactor.threadCpuNs();
+    std::this_thread::sleep_for(std::chrono::seconds(opt.seconds));
+    const std::int64_t cpu1 = reactor.threadCpuNs();
+
+    for (int id : ids)
+        reactor.removePort(id);
+
+    std::uint64_t samples = 0, timeouts = 0, errors = 0;
+    double jitter = 0.0;
+    for (const auto& c : clients) {
+        samples  += c->samples.load();
+        timeouts += c->timeouts.load();
+        errors   += c->errors.load();
+        jitter   += c->jitterStddevUs();
+    }
+    jitter /= ports;
+
+    const double cpuPerSampleUs = samples ? static_cast<double>(cpu1 - cpu0) / 1000.0 / samples : 0.0;
+
+    std::printf("%5d %9llu %9.1f %12.2f %9llu %9llu %9llu %12.1f %8llu %6llu\n",
+                ports,
+                static_cast<unsigned long long>(samples),
+                static_cast<double>(samples) / opt.seconds,
+                cpuPerSampleUs,
+                static_cast<unsigned long long>(rtt.percentile(0.50)),
+                static_cast<unsigned long long>(rtt.percentile(0.99)),
+                static_cast<unsigned long long>(rtt.max()),
+                jitter,
+                static_cast<unsigned long long>(timeouts),
+                static_cast<unsigned long long>(errors));
+    std::fflush(stdout);
+}
+
+bool parseInt(const char* s, int& out)
+{
+    char* end = nullptr;
+    const long v = std::strtol(s, &end, 10);
+    if (!end || *end != '\0' || v <= 0)
+        return false;
+    out = static_cast<int>(v);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        int* target = nullptr;
+        if (arg == "--max-ports")              target = &opt.maxPorts;
+        else if (arg == "--seconds")           target = &opt.seconds;
+        else if (arg == "--period-ms")         target = &opt.periodMs;
+        else if (arg == "--depth")             target = &opt.depth;
+        else if (arg == "--device-latency-ms") target = &opt.deviceLatencyMs;
+
+        if (!target || i + 1 >= argc || !parseInt(argv[i + 1], *target)) {
+            std::fprintf(stderr,
+                         "usage: %s [--max-ports N] [--seconds S] [--period-ms P]"
+                         " [--depth D] [--device-latency-ms L]\n", argv[0]);
+            return 2;
+        }
+        ++i;
+    }
+
+    std::printf("period %d ms, depth %d, device latency %d ms, %d s per step\n",
+                opt.periodMs, opt.depth, opt.deviceLatencyMs, opt.seconds);
+    std::printf("%5s %9s %9s %12s %9s %9s %9s %12s %8s %6s\n",
+                "ports", "samples", "samp/s", "cpu_us/samp",
+                "rtt_p50", "rtt_p99", "rtt_max", "jitter_us", "timeout", "error");
+
+    for (int ports = 1; ports <= opt.maxPorts; ports *= 2)
+        runStep(opt, ports);
+
+    return 0;
+}
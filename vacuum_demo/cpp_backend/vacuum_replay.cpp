@@ -0,0 +1,445 @@
+// vacuum_replay.cpp
+
+#include "vacuum_replay.h"
+#include "vacuum_work_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cctype>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include <QtCore/QString>
+#include <QtCore/QVariant>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlError>
+#include <QtSql/QSqlQuery>
+
+namespace {
+
+static_assert(sizeof(ReplayCorpus::Trace) == 32, "ReplayCorpus::Trace is a file format");
+
+const char kCorpusMagic[8] = {'V', 'A', 'C', 'R', 'P', 'L', '1', '\0'};
+
+struct CorpusFileHeader {
+    char          magic[8];
+    double        tickSec;
+    std::uint64_t traceCount;
+    std::uint64_t tickCount;
+};
+
+// vacuums.pkck -> 채널 (main.dart 의 VAC=PAK=1, CHK=CHUCK=2)
+int channelOf(const QString& pkck)
+{
+    return pkck.compare(QStringLiteral("CHUCK"), Qt::CaseInsensitive) == 0 ? 2 : 1;
+}
+
+int passOf(const QString& result)
+{
+    if (result.compare(QStringLiteral("pass"), Qt::CaseInsensitive) == 0)
+        return 1;
+    if (result.compare(QStringLiteral("fail"), Qt::CaseInsensitive) == 0)
+        return 0;
+    return -1;
+}
+
+} // namespace
+
+// 경과 시간 = 준비 + 평균 + 측정 이므로 경과 시간 이하 중 가장 긴 모드
+double inferDurationSec(float recordedSec)
+{
+    static const double kModes[] = {300.0, 180.0, 120.0, 30.0};
+    for (double mode : kModes) {
+        if (recordedSec >= mode)
+            return mode;
+    }
+    return 0.0;
+}
+
+VacuumReplayParams defaultReplayParams()
+{
+    VacuumReplayParams p{};
+    p.minPress          = kDefaultMinPress;
+    p.minDiff           = kDefaultMinDiff;
+    p.hratePak          = PakFixture::kHrate;
+    p.hrateChuck        = ChuckFixture::kHrate;
+    p.offsetClamp       = kDefaultOffsetClamp;
+    p.vacStartOffsetSec = PakFixture::kStartOffsetSec;
+    p.chkStartOffsetSec = ChuckFixture::kStartOffsetSec;
+    p.averagingWindow   = AveragingFilter::kDefaultWindow;
+    p.durationSec       = -1.0f;
+    return p;
+}
+
+// ───────────────────────────────────────
+//  ReplayCorpus
+// ───────────────────────────────────────
+std::size_t ReplayCorpus::addTrace(std::int64_t lotid, int channel, int storedPass, float recordedSec,
+                                   const std::int64_t* tNs, const float* pressure, const std::int32_t* ok,
+                                   std::size_t n)
+{
+    Trace t{};
+    t.lotid       = lotid;
+    t.channel     = channel;
+    t.storedPass  = static_cast<std::int8_t>(storedPass);
+    t.label       = -1;
+    t.offset      = static_cast<std::uint32_t>(ticks_.size());
+    t.recordedSec = recordedSec;
+
+    const double tickNs = tickSec_ * 1e9;
+    std::int64_t t0 = 0;
+    bool haveT0 = false;
+
+    std::int64_t bin = -1;
+    double sum = 0.0;
+    int cnt = 0;
+    float last = 0.0f;
+
+    auto close = [&](std::int64_t upTo) {
+        // bin 의 평균, 이후 빈 tick 은 직전 값
+        if (bin < 0)
+            return;
+        last = cnt ? static_cast<float>(sum / cnt) : last;
+        ticks_.push_back(last);
+        for (std::int64_t b = bin + 1; b < upTo; ++b)
+            ticks_.push_back(last);
+    };
+
+    for (std::size_t i = 0; i < n; ++i) {
+        if (ok && !ok[i])
+            continue;
+        if (!haveT0) {
+            t0 = tNs[i];
+            haveT0 = true;
+        }
+        const std::int64_t b = static_cast<std::int64_t>(static_cast<double>(tNs[i] - t0) / tickNs);
+        if (b != bin) {
+            close(b);
+            bin = b;
+            sum = 0.0;
+            cnt = 0;
+        }
+        sum += pressure[i];
+        ++cnt;
+    }
+    close(bin + 1);
+
+    t.count = static_cast<std::uint32_t>(ticks_.size() - t.offset);
+    traces_.push_back(t);
+    return traces_.size() - 1;
+}
+
+void ReplayCorpus::clear()
+{
+    traces_.clear();
+    ticks_.clear();
+}
+
+bool ReplayCorpus::loadDatabase(const std::string& dbPath, const std::string& sinceDate, std::string* error)
+{
+    static std::atomic<int> connectionSeq{0};
+    const QString connection = QStringLiteral("vacuum_replay_%1").arg(connectionSeq.fetch_add(1));
+
+    bool ok = true;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), connection);
+        db.setDatabaseName(QString::fromStdString(dbPath));
+        db.setConnectOptions(QStringLiteral("QSQLITE_OPEN_READONLY;QSQLITE_BUSY_TIMEOUT=5000"));
+
+        if (!db.open()) {
+            if (error) *error = "cannot open " + dbPath + ": " + db.lastError().text().toStdString();
+            ok = false;
+        }
+
+        if (ok) {
+            // samples_lotid index 순서 (lotid, rowid) = 세션별 기록 순서 -> 정렬 단계 없음
+            QSqlQuery q(db);
+            q.setForwardOnly(true);
+            QString sql = QStringLiteral(
+                "SELECT s.lotid, s.channel, s.t_ns, s.pressure, s.ok, v.pkck, v.result, v.duration"
+                " FROM samples s JOIN vacuums v ON v.lotid = s.lotid"
+                " WHERE s.lotid IS NOT NULL");
+            if (!sinceDate.empty())
+                sql += QStringLiteral(" AND v.stmpdate >= ?");
+            sql += QStringLiteral(" ORDER BY s.lotid, s.rowid");
+
+            ok = q.prepare(sql);
+            if (ok && !sinceDate.empty())
+                q.addBindValue(QString::fromStdString(sinceDate));
+            ok = ok && q.exec();
+            if (!ok && error)
+                *error = "query failed: " + q.lastError().text().toStdString();
+
+            std::vector<std::int64_t> tNs;
+            std::vector<float>        pressure;
+            std::vector<std::int32_t> sampleOk;
+            std::int64_t lotid = 0;
+            int channel = 0, storedPass = -1;
+            float recordedSec = 0.0f;
+
+            auto flush = [&]() {
+                if (lotid != 0 && !tNs.empty())
+                    addTrace(lotid, channel, storedPass, recordedSec, tNs.data(), pressure.data(), sampleOk.data(),
+                             tNs.size());
+                tNs.clear();
+                pressure.clear();
+                sampleOk.clear();
+            };
+
+            while (ok && q.next()) {
+                const std::int64_t id = q.value(0).toLongLong();
+                if (id != lotid) {
+                    flush();
+                    lotid       = id;
+                    channel     = channelOf(q.value(5).toString());
+                    storedPass  = passOf(q.value(6).toString());
+                    recordedSec = q.value(7).toFloat();
+                }
+                // 검사 채널 샘플만 (측정 전후 다른 채널 폴링 제외)
+                if (q.value(1).toInt() != channel)
+                    continue;
+                tNs.push_back(q.value(2).toLongLong());
+                pressure.push_back(q.value(3).toFloat());
+                sampleOk.push_back(q.value(4).toInt());
+            }
+            flush();
+        }
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(connection);
+    return ok;
+}
+
+std::size_t ReplayCorpus::loadLabels(const std::string& csvPath, std::string* error)
+{
+    std::ifstream in(csvPath);
+    if (!in) {
+        if (error) *error = "cannot open " + csvPath;
+        return 0;
+    }
+
+    std::vector<std::pair<std::int64_t, int>> labels;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream ss(line);
+        std::string idText, labelText;
+        if (!std::getline(ss, idText, ',') || !std::getline(ss, labelText))
+            continue;
+        char* end = nullptr;
+        const long long id = std::strtoll(idText.c_str(), &end, 10);
+        if (end == idText.c_str())
+            continue;   // header
+        labelText.erase(std::remove_if(labelText.begin(), labelText.end(), ::isspace), labelText.end());
+        std::transform(labelText.begin(), labelText.end(), labelText.begin(), ::tolower);
+        if (labelText == "1" || labelText == "pass" || labelText == "good")
+            labels.emplace_back(id, 1);
+        else if (labelText == "0" || labelText == "fail" || labelText == "bad")
+            labels.emplace_back(id, 0);
+    }
+    std::sort(labels.begin(), labels.end());
+
+    std::size_t matched = 0;
+    for (Trace& t : traces_) {
+        const auto it = std::lower_bound(labels.begin(), labels.end(), std::make_pair(t.lotid, -1));
+        if (it != labels.end() && it->first == t.lotid) {
+            t.label = static_cast<std::int8_t>(it->second);
+            ++matched;
+        }
+    }
+    return matched;
+}
+
+bool ReplayCorpus::save(const std::string& path, std::string* error) const
+{
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        if (error) *error = "cannot create " + path;
+        return false;
+    }
+
+    CorpusFileHeader h{};
+    std::memcpy(h.magic, kCorpusMagic, sizeof(kCorpusMagic));
+    h.tickSec    = tickSec_;
+    h.traceCount = traces_.size();
+    h.tickCount  = ticks_.size();
+
+    bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1 &&
+              std::fwrite(traces_.data(), sizeof(Trace), traces_.size(), f) == traces_.size() &&
+              std::fwrite(ticks_.data(), sizeof(float), ticks_.size(), f) == ticks_.size();
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok && error)
+        *error = "write failed: " + path;
+    return ok;
+}
+
+bool ReplayCorpus::load(const std::string& path, std::string* error)
+{
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) {
+        if (error) *error = "cannot open " + path;
+        return false;
+    }
+
+    long fileSize = -1;
+    if (std::fseek(f, 0, SEEK_END) == 0) {
+        fileSize = std::ftell(f);
+        std::rewind(f);
+    }
+
+    // header 의 개수는 파일 크기와 정확히 맞아야 한다 (잘린/손상된 파일에서 거대한 resize 방지)
+    CorpusFileHeader h{};
+    bool ok = fileSize >= static_cast<long>(sizeof(h)) && std::fread(&h, sizeof(h), 1, f) == 1 &&
+              std::memcmp(h.magic, kCorpusMagic, sizeof(kCorpusMagic)) == 0 &&
+              std::isfinite(h.tickSec) && h.tickSec > 0.0;
+    if (ok) {
+        const std::uint64_t body = static_cast<std::uint64_t>(fileSize) - sizeof(h);
+        ok = h.traceCount <= body / sizeof(Trace) && h.tickCount <= body / sizeof(float) &&
+             h.traceCount * sizeof(Trace) + h.tickCount * sizeof(float) == body;
+    }
+    if (ok) {
+        traces_.resize(h.traceCount);
+        ticks_.resize(h.tickCount);
+        ok = std::fread(traces_.data(), sizeof(Trace), traces_.size(), f) == traces_.size() &&
+             std::fread(ticks_.data(), sizeof(float), ticks_.size(), f) == ticks_.size();
+        tickSec_ = h.tickSec;
+    }
+    std::fclose(f);
+
+    // 재채점은 ticks(i)[0..count) 를 그대로 읽으므로 trace 범위도 확인
+    for (std::size_t i = 0; ok && i < traces_.size(); ++i) {
+        const Trace& t = traces_[i];
+        ok = static_cast<std::uint64_t>(t.offset) + t.count <= ticks_.size();
+    }
+
+    if (!ok) {
+        clear();
+        if (error) *error = "not a replay corpus: " + path;
+    }
+    return ok;
+}
+
+// ───────────────────────────────────────
+//  재채점
+// ───────────────────────────────────────
+LeakTestConfig replayConfig(const VacuumReplayParams& params, const ReplayCorpus::Trace& trace)
+{
+    LeakTestConfig cfg;
+    if (trace.channel == 1) {
+        cfg.hrate          = params.hratePak;
+        cfg.startOffsetSec = params.vacStartOffsetSec;
+    } else {
+        cfg.hrate          = params.hrateChuck;
+        cfg.startOffsetSec = params.chkStartOffsetSec;
+    }
+    cfg.averagingWindow = params.averagingWindow;
+    cfg.durationSec     = params.durationSec < 0.0f ? inferDurationSec(trace.recordedSec) : params.durationSec;
+    cfg.minPress        = params.minPress;
+    cfg.minDiff         = params.minDiff;
+    cfg.offsetClamp     = params.offsetClamp;
+    return cfg;
+}
+
+ReplayResult replayTrace(LeakTestSession& session, const LeakTestConfig& config,
+                         const float* ticks, std::size_t count, double tickSec)
+{
+    session.reset(config);
+
+    ReplayResult out;
+    LeakTestResult r;
+    std::size_t k = 0;
+    for (; k < count; ++k) {
+        r = session.feed(static_cast<double>(k + 1) * tickSec, ticks[k]);
+        if (r.stop)
+            break;
+    }
+
+    out.pass         = r.pass ? 1 : 0;
+    out.complete     = (r.stop || session.manual()) ? 1 : 0;
+    out.early        = r.early ? 1 : 0;
+    out.diffPressure = r.diffPressure;
+    out.stopSec      = static_cast<float>(static_cast<double>(std::min(k + 1, count)) * tickSec);
+    return out;
+}
+
+VacuumReplaySummary rescoreCorpus(const ReplayCorpus& corpus, const VacuumReplayParams& baseline,
+                                  const VacuumReplayParams& candidate, const WorkStealingPool& pool,
+                                  std::vector<ReplayDiff>* diffs)
+{
+    const auto started = std::chrono::steady_clock::now();
+
+    struct Partial {
+        VacuumReplaySummary     sum{};
+        std::vector<ReplayDiff> diffs;
+    };
+    std::vector<Partial> partials(static_cast<std::size_t>(pool.threads()));
+
+    // trace 하나 = 수백 tick -> 64 개 묶음이면 chunk 당 수십 us
+    pool.parallelFor(corpus.size(), 64, [&](std::size_t begin, std::size_t end, int worker) {
+        Partial& part = partials[static_cast<std::size_t>(worker)];
+        LeakTestSession session;
+        for (std::size_t i = begin; i < end; ++i) {
+            const ReplayCorpus::Trace& t = corpus.trace(i);
+            const ReplayResult base = replayTrace(session, replayConfig(baseline, t), corpus.ticks(i), t.count,
+                                                  corpus.tickSec());
+            const ReplayResult cand = replayTrace(session, replayConfig(candidate, t), corpus.ticks(i), t.count,
+                                                  corpus.tickSec());
+
+            ++part.sum.traces;
+            if (t.storedPass >= 0 && base.complete && base.pass != t.storedPass)
+                ++part.sum.reproMismatch;
+
+            if (!cand.complete || t.storedPass < 0) {
+                ++part.sum.incomplete;
+                continue;
+            }
+            if (cand.pass == t.storedPass) {
+                ++part.sum.unchanged;
+                continue;
+            }
+            if (t.storedPass)
+                ++part.sum.passToFail;
+            else
+                ++part.sum.failToPass;
+            if (diffs)
+                part.diffs.push_back({t.lotid, t.channel, t.storedPass, base, cand});
+        }
+    });
+
+    VacuumReplaySummary total{};
+    for (Partial& p : partials) {
+        total.traces        += p.sum.traces;
+        total.passToFail    += p.sum.passToFail;
+        total.failToPass    += p.sum.failToPass;
+        total.unchanged     += p.sum.unchanged;
+        total.incomplete    += p.sum.incomplete;
+        total.reproMismatch += p.sum.reproMismatch;
+        if (diffs)
+            diffs->insert(diffs->end(), p.diffs.begin(), p.diffs.end());
+    }
+    if (diffs)
+        std::sort(diffs->begin(), diffs->end(),
+                  [](const ReplayDiff& a, const ReplayDiff& b) { return a.lotid < b.lotid; });
+
+    total.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    return total;
+}
+
+const char* replayVerdictName(const ReplayResult& r)
+{
+    return r.complete ? (r.pass ? "PASS" : "FAIL") : "INCOMPLETE";
+}
+
+void writeReplayDiffCsv(std::FILE* out, const std::vector<ReplayDiff>& diffs)
+{
+    std::fprintf(out, "lotid,channel,stored,baseline,candidate,candidate_diff,candidate_stop_sec\n");
+    for (const ReplayDiff& d : diffs)
+        std::fprintf(out, "%" PRId64 ",%d,%s,%s,%s,%.4f,%.1f\n", d.lotid, d.channel, d.storedPass ? "PASS" : "FAIL",
+                     replayVerdictName(d.baseline), replayVerdictName(d.candidate), d.candidate.diffPressure,
+                     d.candidate.stopSec);
+}
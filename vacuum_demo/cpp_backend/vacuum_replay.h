@@ -0,0 +1,134 @@
+// vacuum_replay.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "vacuum_leak_session.h"
+
+class WorkStealingPool;
+
+// 저장된 세션 trace 를 measureAndDecide 와 같은 판정 엔진(LeakTestSession)으로 다시 채점한다.
+//
+// 실장비에서는 Dart 가 1/DIV 초마다 measureAndDecide(counter) 를 부르고, 그 사이 acquisition 샘플의
+// 평균을 feed(counter / DIV) 한다. 재생도 같은 방식: 첫 샘플 기준 tickSec 구간별 평균 -> tick 압력.
+// (구간에 샘플이 없으면 직전 tick 값, acquirePressure 가 최신 샘플을 쓰는 것과 같음)
+//
+// vacuums.db 의 samples (lotid 연결된 세션) + vacuums (pkck, result, duration) 에서 읽고,
+// 읽은 corpus 는 binary 파일로 저장해 두었다가 다시 쓸 수 있다 (DB 읽기가 채점보다 훨씬 느림).
+
+extern "C" {
+
+// 판정 파라미터. 기본값 = 현재 backend 기본 설정
+struct VacuumReplayParams {
+    float   minPress;            // MINPRESS
+    float   minDiff;             // MINDIFF
+    float   hratePak;            // VAC1 (PAK) 측정 구간 보정 비율
+    float   hrateChuck;          // VAC2 (CHUCK)
+    float   offsetClamp;         // 시작 압력 offset clamp (65.5)
+    float   vacStartOffsetSec;   // PAK 준비시간
+    float   chkStartOffsetSec;   // CHUCK 준비시간
+    int32_t averagingWindow;     // 5/10/20/50/100
+    float   durationSec;         // < 0: trace 별 기록값에서 추정, 0: manual
+    int32_t reserved;
+};
+
+struct VacuumReplaySummary {
+    uint64_t traces;             // 채점한 trace 수
+    uint64_t passToFail;         // 기록 PASS -> 재채점 FAIL
+    uint64_t failToPass;         // 기록 FAIL -> 재채점 PASS
+    uint64_t unchanged;
+    uint64_t incomplete;         // trace 가 측정 시간보다 짧아 판정이 끝나지 않음 (flip 집계 제외)
+    uint64_t reproMismatch;      // 기준 파라미터로 재생해도 기록과 다른 trace (재생 충실도 확인용)
+    double   elapsedMs;          // 채점 시간 (로딩 제외)
+};
+
+} // extern "C"
+
+VacuumReplayParams defaultReplayParams();
+
+// 모든 trace 의 tick 압력을 한 배열에 이어 붙인 corpus
+class ReplayCorpus
+{
+public:
+    struct Trace {
+        std::int64_t  lotid;
+        std::int32_t  channel;        // 1=PAK, 2=CHUCK
+        std::int8_t   storedPass;     // vacuums.result (1/0, -1 = 없음)
+        std::int8_t   label;          // 실제 양/불량 (1/0, -1 = 모름). 검증 corpus 용
+        std::uint16_t reserved;
+        std::uint32_t offset;         // ticks() 시작 index
+        std::uint32_t count;
+        float         recordedSec;    // vacuums.duration (검사 경과 초)
+    };
+
+    double tickSec() const { return tickSec_; }
+    void   setTickSec(double sec) { tickSec_ = sec; }
+
+    // tNs 오름차순 샘플 -> tick 평균으로 변환해서 추가 (ok 가 0 인 샘플 제외). 반환: trace index
+    std::size_t addTrace(std::int64_t lotid, int channel, int storedPass, float recordedSec,
+                         const std::int64_t* tNs, const float* pressure, const std::int32_t* ok, std::size_t n);
+
+    // samples + vacuums 에서 읽기. sinceDate ("yyyy-MM-dd", 빈 문자열 = 전체) 이후 검사만
+    bool loadDatabase(const std::string& dbPath, const std::string& sinceDate, std::string* error = nullptr);
+
+    // lotid,label CSV (label: 1/pass/good, 0/fail/bad). 반환: 라벨을 붙인 trace 수
+    std::size_t loadLabels(const std::string& csvPath, std::string* error = nullptr);
+
+    bool save(const std::string& path, std::string* error = nullptr) const;
+    bool load(const std::string& path, std::string* error = nullptr);
+
+    void clear();
+    std::size_t size() const { return traces_.size(); }
+    const Trace& trace(std::size_t i) const { return traces_[i]; }
+    const float* ticks(std::size_t i) const { return ticks_.data() + traces_[i].offset; }
+    std::size_t tickCount() const { return ticks_.size(); }
+
+private:
+    double             tickSec_ = 0.5;   // 1 / DIV
+    std::vector<Trace> traces_;
+    std::vector<float> ticks_;
+};
+
+struct ReplayResult {
+    std::uint8_t pass     = 1;
+    std::uint8_t complete = 0;   // stop 까지 재생됨 (manual 은 trace 끝 = 완료)
+    std::uint8_t early    = 0;
+    float        diffPressure = 0.0f;
+    float        stopSec      = 0.0f;   // 판정 시각 (검사 시작 기준)
+};
+
+// 기록 vs 재채점 판정이 다른 trace
+struct ReplayDiff {
+    std::int64_t lotid;
+    std::int32_t channel;
+    std::int8_t  storedPass;
+    ReplayResult baseline;
+    ReplayResult candidate;
+};
+
+// 시간 모드(300/180/120/30 초)는 저장되지 않으므로 vacuums.duration (경과 초) 에서 추정. 30 초 미만이면 0 (manual)
+double inferDurationSec(float recordedSec);
+
+// trace 하나의 판정 설정 (sessionConfig 와 같은 채널별 규칙)
+LeakTestConfig replayConfig(const VacuumReplayParams& params, const ReplayCorpus::Trace& trace);
+
+// ticks[0..count) 를 feed((k + 1) * tickSec) 로 재생
+ReplayResult replayTrace(LeakTestSession& session, const LeakTestConfig& config,
+                         const float* ticks, std::size_t count, double tickSec);
+
+// 모든 trace 를 baseline / candidate 로 재생해 기록 판정과 비교.
+// diffs != nullptr 이면 candidate 판정이 기록과 다른 trace 를 lotid 순으로 채움
+VacuumReplaySummary rescoreCorpus(const ReplayCorpus& corpus, const VacuumReplayParams& baseline,
+                                  const VacuumReplayParams& candidate, const WorkStealingPool& pool,
+                                  std::vector<ReplayDiff>* diffs = nullptr);
+
+// "PASS" / "FAIL" / "INCOMPLETE"
+const char* replayVerdictName(const ReplayResult& r);
+
+// 판정이 바뀐 trace 목록 CSV (header 포함). vacuum_rescore --diff-csv 와 vacuum_replay_rescore 공용
+//   lotid,channel,stored,baseline,candidate,candidate_diff,candidate_stop_sec
+void writeReplayDiffCsv(std::FILE* out, const std::vector<ReplayDiff>& diffs);
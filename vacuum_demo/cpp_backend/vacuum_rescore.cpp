@@ -0,0 +1,138 @@
+// vacuum_rescore.cpp
+//
+// 판정 파라미터를 바꿨을 때 과거 검사 결과가 얼마나 뒤집히는지 계산한다.
+// vacuums.db 의 세션 샘플(samples)을 measureAndDecide 와 같은 판정 엔진으로 모든 코어에서 재생하고,
+// 기록된 판정(vacuums.result)과 다른 lot 과 PASS->FAIL / FAIL->PASS 개수를 출력한다.
+//
+//   vacuum_rescore (DB | --corpus FILE) [--since yyyy-MM-dd] [--save-corpus FILE]
+//                  [--min-press 62] [--min-diff 1.0] [--hrate-pak 0.5] [--hrate-chuck 0.6]
+//                  [--offset-clamp 65.5] [--vac-offset 25] [--chk-offset 7] [--window 5]
+//                  [--duration SEC] [--threads N] [--diff-csv FILE] [--quiet]
+//
+// 기준(baseline)은 현재 기본 파라미터. --duration 을 주지 않으면 trace 별 기록 경과 시간에서
+// 시간 모드를 추정한다 (vacuum_replay.cpp inferDurationSec).
+
+#include "vacuum_replay.h"
+#include "vacuum_work_pool.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <QtCore/QCoreApplication>
+
+namespace {
+
+int usage()
+{
+    std::fprintf(stderr,
+                 "usage: vacuum_rescore (DB | --corpus FILE) [--since yyyy-MM-dd] [--save-corpus FILE]\n"
+                 "                      [--min-press X] [--min-diff X] [--hrate-pak X] [--hrate-chuck X]\n"
+                 "                      [--offset-clamp X] [--vac-offset SEC] [--chk-offset SEC] [--window N]\n"
+                 "                      [--duration SEC] [--threads N] [--diff-csv FILE] [--quiet]\n");
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);   // QSQLITE plugin 경로
+
+    std::string dbPath, corpusPath, savePath, since, diffCsv;
+    VacuumReplayParams candidate = defaultReplayParams();
+    int  threads = 0;
+    bool quiet = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        const bool hasValue = i + 1 < argc;
+        auto num = [&]() { return static_cast<float>(std::atof(argv[++i])); };
+
+        if (!std::strcmp(a, "--quiet")) {
+            quiet = true;
+        } else if (!hasValue && a[0] == '-') {
+            return usage();
+        } else if (!std::strcmp(a, "--corpus")) {
+            corpusPath = argv[++i];
+        } else if (!std::strcmp(a, "--save-corpus")) {
+            savePath = argv[++i];
+        } else if (!std::strcmp(a, "--since")) {
+            since = argv[++i];
+        } else if (!std::strcmp(a, "--diff-csv")) {
+            diffCsv = argv[++i];
+        } else if (!std::strcmp(a, "--threads")) {
+            threads = std::atoi(argv[++i]);
+        } else if (!std::strcmp(a, "--min-press")) {
+            candidate.minPress = num();
+        } else if (!std::strcmp(a, "--min-diff")) {
+            candidate.minDiff = num();
+        } else if (!std::strcmp(a, "--hrate-pak")) {
+            candidate.hratePak = num();
+        } else if (!std::strcmp(a, "--hrate-chuck")) {
+            candidate.hrateChuck = num();
+        } else if (!std::strcmp(a, "--offset-clamp")) {
+            candidate.offsetClamp = num();
+        } else if (!std::strcmp(a, "--vac-offset")) {
+            candidate.vacStartOffsetSec = num();
+        } else if (!std::strcmp(a, "--chk-offset")) {
+            candidate.chkStartOffsetSec = num();
+        } else if (!std::strcmp(a, "--window")) {
+            candidate.averagingWindow = std::atoi(argv[++i]);
+        } else if (!std::strcmp(a, "--duration")) {
+            candidate.durationSec = num();
+        } else if (a[0] != '-' && dbPath.empty()) {
+            dbPath = a;
+        } else {
+            return usage();
+        }
+    }
+    if (dbPath.empty() == corpusPath.empty())
+        return usage();
+    if (!AveragingFilter::isSupportedWindow(candidate.averagingWindow)) {
+        std::fprintf(stderr, "--window must be 5, 10, 20, 50 or 100\n");
+        return 2;
+    }
+
+    ReplayCorpus corpus;
+    std::string error;
+    const bool loaded = corpusPath.empty() ? corpus.loadDatabase(dbPath, since, &error)
+                                           : corpus.load(corpusPath, &error);
+    if (!loaded) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    if (!savePath.empty() && !corpus.save(savePath, &error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    const WorkStealingPool pool(threads);
+    std::vector<ReplayDiff> diffs;
+    const VacuumReplaySummary s = rescoreCorpus(corpus, defaultReplayParams(), candidate, pool, &diffs);
+
+    if (!diffCsv.empty()) {
+        std::FILE* out = std::fopen(diffCsv.c_str(), "w");
+        if (!out) {
+            std::perror(diffCsv.c_str());
+            return 1;
+        }
+        writeReplayDiffCsv(out, diffs);
+        std::fclose(out);
+    } else if (!quiet) {
+        for (const ReplayDiff& d : diffs)
+            std::printf("lot %" PRId64 " ch%d %s -> %s (baseline %s, diff %.3f @ %.1fs)\n", d.lotid, d.channel,
+                        d.storedPass ? "PASS" : "FAIL", replayVerdictName(d.candidate),
+                        replayVerdictName(d.baseline), d.candidate.diffPressure, d.candidate.stopSec);
+    }
+
+    std::printf("# %" PRIu64 " traces (%zu ticks), %d threads, %.1f ms\n", s.traces, corpus.tickCount(),
+                pool.threads(), s.elapsedMs);
+    std::printf("# PASS->FAIL %" PRIu64 "  FAIL->PASS %" PRIu64 "  unchanged %" PRIu64 "  incomplete %" PRIu64 "\n",
+                s.passToFail, s.failToPass, s.unchanged, s.incomplete);
+    std::printf("# baseline replay differs from stored verdict: %" PRIu64 "\n", s.reproMismatch);
+    return 0;
+}
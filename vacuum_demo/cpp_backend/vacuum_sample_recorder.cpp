@@ -0,0 +1,324 @@
+// vacuum_sample_recorder.cpp
+
+#include "vacuum_sample_recorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <unordered_map>
+
+#include <QtCore/QDebug>
+#include <QtCore/QString>
+#include <QtCore/QVariant>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlError>
+#include <QtSql/QSqlQuery>
+
+namespace {
+
+// 여러 프로세스가 같은 DB 를 쓰므로 카운터 대신 난수 (양수 63-bit)
+int64_t newSessionId()
+{
+    static std::mutex       m;
+    static std::mt19937_64  rng(std::random_device{}() ^
+                                static_cast<std::uint64_t>(std::chrono::system_clock::now().time_since_epoch().count()));
+    std::lock_guard<std::mutex> lock(m);
+    int64_t id = 0;
+    while (id == 0)
+        id = static_cast<int64_t>(rng() >> 1);
+    return id;
+}
+
+bool exec(QSqlDatabase& db, const char* sql)
+{
+    QSqlQuery q(db);
+    if (!q.exec(QString::fromUtf8(sql))) {
+        qWarning() << "[Recorder]" << sql << ":" << q.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+const char* const kSchema[] = {
+    "CREATE TABLE IF NOT EXISTS sample_sessions ("
+    " session INTEGER PRIMARY KEY, lotid INTEGER, station TEXT, started_at TEXT)",
+    "CREATE TABLE IF NOT EXISTS samples ("
+    " session INTEGER NOT NULL, lotid INTEGER, t_ns INTEGER NOT NULL,"
+    " channel INTEGER, raw INTEGER, pressure REAL, ok INTEGER)",
+    "CREATE INDEX IF NOT EXISTS samples_lotid ON samples(lotid)",
+    "CREATE INDEX IF NOT EXISTS samples_session ON samples(session)",
+};
+
+} // namespace
+
+SampleRecorder& SampleRecorder::shared()
+{
+    static SampleRecorder inst;
+    return inst;
+}
+
+SampleRecorder::~SampleRecorder()
+{
+    close();
+}
+
+bool SampleRecorder::open(const std::string& dbPath)
+{
+    close();
+
+    static std::atomic<int> connectionSeq{0};
+    const std::string connection = "vacuum_recorder_" + std::to_string(connectionSeq.fetch_add(1));
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = false;
+    }
+
+    std::promise<bool> opened;
+    std::future<bool>  openedResult = opened.get_future();
+
+    thread_ = std::thread(&SampleRecorder::run, this, dbPath, connection, &opened);
+
+    if (!openedResult.get()) {
+        thread_.join();
+        return false;
+    }
+
+    running_.store(true, std::memory_order_release);
+    qDebug() << "[Recorder] recording to" << QString::fromStdString(dbPath);
+    return true;
+}
+
+void SampleRecorder::close()
+{
+    if (!thread_.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wakeCv_.notify_all();
+
+    thread_.join();
+    running_.store(false, std::memory_order_release);
+}
+
+int64_t SampleRecorder::beginSession(const std::shared_ptr<RecorderStream>& stream, const std::string& station)
+{
+    if (!stream || !isOpen())
+        return 0;
+
+    const int64_t session = newSessionId();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (std::find(streams_.begin(), streams_.end(), stream) == streams_.end())
+            streams_.push_back(stream);
+        commands_.push_back({Command::Kind::Begin, session, 0, station});
+    }
+    stream->session_.store(session, std::memory_order_release);
+    return session;
+}
+
+bool SampleRecorder::endSession(const std::shared_ptr<RecorderStream>& stream, int64_t lotid)
+{
+    if (!stream)
+        return false;
+
+    const int64_t session = stream->session_.exchange(0, std::memory_order_acq_rel);
+    if (session == 0)
+        return false;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        commands_.push_back({Command::Kind::End, session, lotid, std::string()});
+    }
+    wakeCv_.notify_all();   // 남은 샘플을 바로 commit
+    return true;
+}
+
+// ───────────────────────────────────────
+//  writer thread
+// ───────────────────────────────────────
+void SampleRecorder::run(std::string dbPath, std::string connection, std::promise<bool>* opened)
+{
+    {
+        // QSqlDatabase 연결은 만든 스레드에서만 사용
+        QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), QString::fromStdString(connection));
+        db.setDatabaseName(QString::fromStdString(dbPath));
+        db.setConnectOptions(QStringLiteral("QSQLITE_BUSY_TIMEOUT=5000"));
+
+        bool ok = db.open();
+        if (!ok)
+            qWarning() << "[Recorder] cannot open" << QString::fromStdString(dbPath) << ":" << db.lastError().text();
+
+        // WAL: 읽는 쪽(Dart UI, 다른 스테이션)이 writer 를 막지 않음
+        ok = ok && exec(db, "PRAGMA journal_mode=WAL") && exec(db, "PRAGMA synchronous=NORMAL");
+        for (const char* sql : kSchema)
+            ok = ok && exec(db, sql);
+
+        QSqlQuery insertSample(db);
+        QSqlQuery insertSession(db);
+        QSqlQuery linkSamples(db);
+        QSqlQuery linkSession(db);
+        ok = ok
+            && insertSample.prepare(QStringLiteral(
+                   "INSERT INTO samples (session, lotid, t_ns, channel, raw, pressure, ok) VALUES (?, ?, ?, ?, ?, ?, ?)"))
+            && insertSession.prepare(QStringLiteral(
+                   "INSERT OR REPLACE INTO sample_sessions (session, station, started_at)"
+                   " VALUES (?, ?, datetime('now', 'localtime'))"))
+            && linkSamples.prepare(QStringLiteral("UPDATE samples SET lotid = ? WHERE session = ?"))
+            && linkSession.prepare(QStringLiteral("UPDATE sample_sessions SET lotid = ? WHERE session = ?"));
+
+        opened->set_value(ok);   // 이후 opened 는 더 이상 유효하지 않음
+
+        std::vector<RecordedSample>                  batch(RecorderStream::kCapacity);
+        std::vector<std::shared_ptr<RecorderStream>> streams;
+        std::vector<Command>                         incoming;
+        // commit 실패 시 다음 주기에 다시 넣을 샘플 / 명령 (kMaxCommitRetries 번까지)
+        std::vector<RecordedSample>                  pending;
+        std::vector<Command>                         commands;
+        int                                          retries = 0;
+
+        // End 된 세션 -> lotid. End 가 drain 한 뒤에 push 된 샘플도 INSERT 때 lotid 를 넣도록
+        // End 를 commit 한 다음 batch 까지 유지한다 (linked = End 가 commit 됨)
+        struct EndedSession {
+            int64_t lotid;
+            bool    linked;
+        };
+        std::unordered_map<int64_t, EndedSession> ended;
+
+        bool stopping = !ok;
+        while (ok) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wakeCv_.wait_for(lock, std::chrono::milliseconds(kCommitIntervalMs), [this] {
+                    return stop_ || !commands_.empty();
+                });
+                stopping = stop_;
+                streams = streams_;
+                incoming.swap(commands_);
+            }
+            commands.insert(commands.end(), incoming.begin(), incoming.end());
+            incoming.clear();
+
+            // group commit: 이번 주기에 쌓인 샘플 + 세션 명령을 transaction 하나로.
+            // 어느 단계든 실패하면 batch 전체를 rollback 해서 재시도 때 중복 행이 생기지 않게 한다
+            const bool began = db.transaction();
+            bool       committed = began;
+            QString    failure = began ? QString() : db.lastError().text();
+            const auto execInBatch = [&](QSqlQuery& q) {
+                if (committed && !q.exec()) {
+                    committed = false;
+                    failure   = q.lastError().text();
+                }
+            };
+
+            // Begin 이 샘플보다 먼저 (세션 행이 있어야 조회가 자연스러움)
+            for (const Command& c : commands) {
+                if (c.kind != Command::Kind::Begin)
+                    continue;
+                insertSession.bindValue(0, static_cast<qlonglong>(c.session));
+                insertSession.bindValue(1, QString::fromStdString(c.station));
+                execInBatch(insertSession);
+            }
+
+            for (const Command& c : commands) {
+                if (c.kind == Command::Kind::End && c.lotid > 0)
+                    ended.emplace(c.session, EndedSession{c.lotid, false});
+            }
+
+            for (const auto& s : streams) {
+                std::size_t n;
+                while ((n = s->ring_.drain(batch.data(), batch.size())) > 0)
+                    pending.insert(pending.end(), batch.begin(), batch.begin() + n);
+            }
+
+            for (const RecordedSample& r : pending) {
+                if (!committed)
+                    break;
+                const auto endedIt = ended.find(r.session);
+                insertSample.bindValue(0, static_cast<qlonglong>(r.session));
+                insertSample.bindValue(1, endedIt != ended.end() ? QVariant(static_cast<qlonglong>(endedIt->second.lotid))
+                                                                 : QVariant(QVariant::LongLong));
+                insertSample.bindValue(2, static_cast<qlonglong>(r.sample.timestampNs));
+                insertSample.bindValue(3, r.sample.channel);
+                insertSample.bindValue(4, r.sample.raw);
+                insertSample.bindValue(5, static_cast<double>(r.sample.pressure));
+                insertSample.bindValue(6, r.sample.ok);
+                execInBatch(insertSample);
+            }
+
+            // End 는 해당 세션 샘플을 모두 넣은 뒤
+            for (const Command& c : commands) {
+                if (c.kind != Command::Kind::End || c.lotid <= 0)
+                    continue;
+                for (QSqlQuery* q : {&linkSamples, &linkSession}) {
+                    q->bindValue(0, static_cast<qlonglong>(c.lotid));
+                    q->bindValue(1, static_cast<qlonglong>(c.session));
+                    execInBatch(*q);
+                }
+            }
+
+            if (committed && !db.commit()) {
+                committed = false;
+                failure   = db.lastError().text();
+            }
+
+            bool retry = false;
+            if (committed) {
+                written_.fetch_add(pending.size(), std::memory_order_relaxed);
+                retries = 0;
+
+                // 이전 batch 에서 link 된 세션은 이번 drain 으로 늦은 샘플까지 들어갔으므로 제거
+                for (auto it = ended.begin(); it != ended.end();) {
+                    if (it->second.linked) {
+                        it = ended.erase(it);
+                    } else {
+                        it->second.linked = true;
+                        ++it;
+                    }
+                }
+            } else {
+                failedCommits_.fetch_add(1, std::memory_order_relaxed);
+                qWarning() << "[Recorder] batch failed:" << failure;
+                if (began)
+                    db.rollback();
+
+                // 샘플과 Begin/End 명령을 그대로 두고 다음 주기에 다시 시도
+                retry = ++retries <= kMaxCommitRetries;
+                if (!retry) {
+                    droppedSamples_.fetch_add(pending.size(), std::memory_order_relaxed);
+                    qWarning() << "[Recorder] giving up after" << kMaxCommitRetries << "retries, dropped"
+                               << static_cast<qulonglong>(pending.size()) << "samples";
+                    retries = 0;
+                }
+            }
+            if (!retry) {
+                pending.clear();
+                commands.clear();
+            }
+
+            streams.clear();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                streams_.erase(std::remove_if(streams_.begin(), streams_.end(),
+                                              [](const std::shared_ptr<RecorderStream>& s) {
+                                                  return s.use_count() == 1 && s->ring_.size() == 0;
+                                              }),
+                               streams_.end());
+            }
+
+            // 종료 중이어도 재시도할 것이 남아 있으면 한 번 더 (wait 는 stop_ 이라 바로 반환)
+            if (stopping && !retry)
+                break;
+        }
+
+        insertSample.finish();
+        insertSession.finish();
+        linkSamples.finish();
+        linkSession.finish();
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(QString::fromStdString(connection));
+}
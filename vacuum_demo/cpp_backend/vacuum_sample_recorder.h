@@ -0,0 +1,110 @@
+// vacuum_sample_recorder.h
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "vacuum_acquisition.h"
+#include "vacuum_sample_ring.h"
+
+// 세션의 모든 샘플을 vacuums.db 의 samples 테이블에 기록한다.
+//  - acquisition 스레드는 장비별 RecorderStream (SPSC ring) 에 push 만 한다 (lock / I/O 없음)
+//  - 전용 writer 스레드가 주기적으로 모든 stream 을 비우고 한 transaction 으로 commit
+//  - WAL + busy_timeout 이라 여러 스테이션(프로세스)이 같은 DB 를 공유해도 된다
+//
+// lotid 는 Dart 가 검사 종료 후 vacuums 행을 INSERT 해야 정해지므로,
+// 샘플은 session id 로 기록하고 endSession(lotid) 에서 lotid 를 채운다.
+// record() 가 endSession 직전에 읽은 session 으로 End 처리 뒤에 push 한 샘플도 있으므로,
+// writer 는 End 를 commit 한 다음 batch 까지 그 세션 샘플을 lotid 를 넣어 INSERT 한다.
+//
+//   samples(session, lotid, t_ns, channel, raw, pressure, ok)      index: lotid, session
+//   sample_sessions(session PK, lotid, station, started_at)
+struct RecordedSample {
+    int64_t      session;
+    VacuumSample sample;
+};
+
+class RecorderStream
+{
+public:
+    static constexpr std::size_t kCapacity = 4096;   // 50 Hz 기준 80 s 분량
+
+    // acquisition 스레드. 기록 중인 세션이 없으면 무시
+    void record(const VacuumSample& s)
+    {
+        const int64_t session = session_.load(std::memory_order_acquire);
+        if (session != 0)
+            ring_.push(RecordedSample{session, s});
+    }
+
+    int64_t session() const { return session_.load(std::memory_order_acquire); }
+    std::uint64_t dropped() const { return ring_.dropped(); }
+
+private:
+    friend class SampleRecorder;
+
+    SampleRing<RecordedSample, kCapacity> ring_;
+    std::atomic<int64_t> session_{0};
+};
+
+class SampleRecorder
+{
+public:
+    static constexpr int kCommitIntervalMs = 250;
+    static constexpr int kMaxCommitRetries = 8;   // batch (BEGIN/INSERT/COMMIT) 실패 시 재시도 횟수. 넘으면 그 샘플은 버림
+
+    // 프로세스 공용 recorder
+    static SampleRecorder& shared();
+
+    SampleRecorder() = default;
+    ~SampleRecorder();
+
+    SampleRecorder(const SampleRecorder&) = delete;
+    SampleRecorder& operator=(const SampleRecorder&) = delete;
+
+    // DB 를 열고 테이블을 만든 뒤 writer 스레드 시작. 이미 열려 있으면 닫고 다시 연다
+    bool open(const std::string& dbPath);
+    // 남은 샘플을 모두 기록하고 종료
+    void close();
+    bool isOpen() const { return running_.load(std::memory_order_acquire); }
+
+    // stream 의 새 세션 시작. 실패(닫힘) 시 0
+    int64_t beginSession(const std::shared_ptr<RecorderStream>& stream, const std::string& station);
+    // 이후 샘플은 기록하지 않고, 이 세션의 샘플에 lotid 를 채운다 (lotid <= 0 이면 lotid 없이 종료)
+    bool endSession(const std::shared_ptr<RecorderStream>& stream, int64_t lotid);
+
+    std::uint64_t writtenSamples() const { return written_.load(std::memory_order_relaxed); }
+    std::uint64_t failedCommits() const { return failedCommits_.load(std::memory_order_relaxed); }
+    std::uint64_t droppedSamples() const { return droppedSamples_.load(std::memory_order_relaxed); }
+
+private:
+    struct Command {
+        enum class Kind { Begin, End } kind;
+        int64_t     session;
+        int64_t     lotid;
+        std::string station;
+    };
+
+    void run(std::string dbPath, std::string connection, std::promise<bool>* opened);
+
+    std::thread             thread_;
+    std::mutex              mutex_;      // streams_, commands_, stop_
+    // 소유자(backend)가 사라진 stream 은 남은 샘플을 기록한 뒤 목록에서 뺀다
+    std::condition_variable wakeCv_;
+    bool                    stop_ = false;
+
+    std::vector<std::shared_ptr<RecorderStream>> streams_;
+    std::vector<Command>                         commands_;
+
+    std::atomic<bool>          running_{false};
+    std::atomic<std::uint64_t> written_{0};
+    std::atomic<std::uint64_t> failedCommits_{0};
+    std::atomic<std::uint64_t> droppedSamples_{0};
+};
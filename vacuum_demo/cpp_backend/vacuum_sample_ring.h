@@ -0,0 +1,74 @@
+// vacuum_sample_ring.h
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Lock-free single-producer / single-consumer ring buffer.
+//  - producer: acquisition thread (push)
+//  - consumer: C API caller (drain)
+// 가득 차면 새 샘플을 버리고 dropped() 를 증가시킨다.
+template <typename T, std::size_t Capacity>
+class SampleRing
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SampleRing capacity must be a power of two");
+
+public:
+    bool push(const T& value)
+    {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+
+        if (head - tail >= Capacity) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        slots_[head & kMask] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 최대 maxCount 개를 out 으로 복사, 복사한 개수 반환
+    std::size_t drain(T* out, std::size_t maxCount)
+    {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        const std::size_t head = head_.load(std::memory_order_acquire);
+
+        std::size_t n = head - tail;
+        if (n > maxCount)
+            n = maxCount;
+
+        for (std::size_t i = 0; i < n; ++i)
+            out[i] = slots_[(tail + i) & kMask];
+
+        tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    // consumer 쪽에서만 호출
+    void clear()
+    {
+        tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    std::size_t size() const
+    {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+    static constexpr std::size_t kMask = Capacity - 1;
+
+    T slots_[Capacity] = {};
+
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    alignas(64) std::atomic<std::uint64_t> dropped_{0};
+};
@@ -0,0 +1,78 @@
+// vacuum_seqlock.h
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// 단일 writer / 다중 reader 시퀀스 락.
+// writer 는 절대 대기하지 않고, reader 는 쓰기 도중이면 다시 읽는다.
+// 값은 atomic word 배열에 저장하므로 reader/writer 간 data race 가 없다.
+template <typename T>
+class Seqlock
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Seqlock<T> requires a trivially copyable T");
+
+public:
+    Seqlock()
+    {
+        for (auto& w : words_)
+            w.store(0, std::memory_order_relaxed);
+    }
+
+    // writer thread only
+    void store(const T& value)
+    {
+        std::uint64_t buf[kWords] = {};
+        std::memcpy(buf, &value, sizeof(T));
+
+        const std::uint64_t s = seq_.load(std::memory_order_relaxed);
+        seq_.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (std::size_t i = 0; i < kWords; ++i)
+            words_[i].store(buf[i], std::memory_order_relaxed);
+
+        seq_.store(s + 2, std::memory_order_release);
+    }
+
+    // any thread; false until the first store()
+    bool load(T& out) const
+    {
+        std::uint64_t buf[kWords];
+        std::uint64_t s0 = 0;
+
+        for (;;) {
+            s0 = seq_.load(std::memory_order_acquire);
+            if (s0 & 1u)
+                continue;   // 쓰는 중
+
+            for (std::size_t i = 0; i < kWords; ++i)
+                buf[i] = words_[i].load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == s0)
+                break;
+        }
+
+        if (s0 == 0)
+            return false;
+
+        std::memcpy(&out, buf, sizeof(T));
+        return true;
+    }
+
+    // 발행 횟수 (store 1회당 1 증가)
+    std::uint64_t version() const
+    {
+        return seq_.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    static constexpr std::size_t kWords = (sizeof(T) + 7) / 8;
+
+    std::atomic<std::uint64_t> seq_{0};
+    std::atomic<std::uint64_t> words_[kWords];
+};
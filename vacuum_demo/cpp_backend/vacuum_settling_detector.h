@@ -0,0 +1,95 @@
+// vacuum_settling_detector.h
+#pragma once
+
+#include <cmath>
+#include <deque>
+
+// 최근 windowSec 동안의 압력으로 안정 여부 판단.
+//   |기울기| <= maxSlope (kPa/s)  그리고  잔차 표준편차 <= maxStddev (kPa)
+// 창 안의 합계를 유지하므로 add 는 amortized O(1).
+class SettlingDetector
+{
+public:
+    struct Config {
+        double windowSec = 2.0;
+        double maxSlope  = 0.05;
+        double maxStddev = 0.10;
+    };
+
+    SettlingDetector() = default;
+    explicit SettlingDetector(const Config& config) : config_(config) {}
+
+    void reset(const Config& config)
+    {
+        config_ = config;
+        clear();
+    }
+
+    void clear()
+    {
+        window_.clear();
+        sx_ = sy_ = sxx_ = sxy_ = syy_ = 0.0;
+    }
+
+    // t 는 단조 증가. 반환값 = 지금 안정 상태인지
+    bool add(double t, double pressure)
+    {
+        window_.push_back({t, pressure});
+        accumulate(t, pressure, +1.0);
+
+        // 창 길이를 넘는 가장 오래된 샘플 제거 (span 은 windowSec 이상 유지)
+        while (window_.size() > 2 && t - window_[1].t >= config_.windowSec) {
+            accumulate(window_.front().t, window_.front().p, -1.0);
+            window_.pop_front();
+        }
+        return stable();
+    }
+
+    bool stable() const
+    {
+        if (window_.size() < 3 || span() < config_.windowSec)
+            return false;
+        return std::fabs(slope()) <= config_.maxSlope && residualStddev() <= config_.maxStddev;
+    }
+
+    double span() const { return window_.empty() ? 0.0 : window_.back().t - window_.front().t; }
+
+    double slope() const
+    {
+        const double n   = static_cast<double>(window_.size());
+        const double cxx = sxx_ - sx_ * sx_ / n;
+        return cxx > 0.0 ? (sxy_ - sx_ * sy_ / n) / cxx : 0.0;
+    }
+
+    double residualStddev() const
+    {
+        const double n = static_cast<double>(window_.size());
+        if (n < 3)
+            return 0.0;
+        const double cxx = sxx_ - sx_ * sx_ / n;
+        const double cxy = sxy_ - sx_ * sy_ / n;
+        const double cyy = syy_ - sy_ * sy_ / n;
+        const double sse = cxx > 0.0 ? cyy - cxy * cxy / cxx : cyy;
+        return sse > 0.0 ? std::sqrt(sse / (n - 2.0)) : 0.0;
+    }
+
+private:
+    struct Sample {
+        double t;
+        double p;
+    };
+
+    // t 는 검사 시작 기준 수십 초 -> 직접 합계를 써도 정밀도 충분
+    void accumulate(double t, double p, double sign)
+    {
+        sx_  += sign * t;
+        sy_  += sign * p;
+        sxx_ += sign * t * t;
+        sxy_ += sign * t * p;
+        syy_ += sign * p * p;
+    }
+
+    Config             config_;
+    std::deque<Sample> window_;
+    double sx_ = 0.0, sy_ = 0.0, sxx_ = 0.0, sxy_ = 0.0, syy_ = 0.0;
+};
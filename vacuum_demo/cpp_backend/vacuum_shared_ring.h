@@ -0,0 +1,73 @@
+// vacuum_shared_ring.h
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// 다른 언어(Dart FFI)가 포인터로 직접 읽는 single-producer / single-consumer ring.
+// SampleRing 과 같은 규칙이지만 용량은 실행 시간에 정하고, index 는 64-bit 로 고정해
+// 외부에서 uint64_t* 로 접근할 수 있게 한다.
+//  - producer (acquisition 스레드): slot 기록 후 head 를 release store
+//  - consumer (Dart):               head acquire load -> slot 읽기 -> tail release store
+// index 는 감싸지 않고 계속 증가 (slot = index & (capacity - 1)).
+template <typename T>
+class SharedRing
+{
+    static_assert(sizeof(std::atomic<std::uint64_t>) == sizeof(std::uint64_t),
+                  "atomic<uint64_t> must be layout-compatible with uint64_t");
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+                  "lock-free 64-bit atomics required for cross-language access");
+
+public:
+    // capacity 는 2 의 거듭제곱으로 올림 (최소 2)
+    explicit SharedRing(std::uint32_t capacity)
+        : capacity_(roundUp(capacity)), mask_(capacity_ - 1), slots_(new T[capacity_]())
+    {
+    }
+
+    SharedRing(const SharedRing&) = delete;
+    SharedRing& operator=(const SharedRing&) = delete;
+
+    bool push(const T& value)
+    {
+        const std::uint64_t head = head_.load(std::memory_order_relaxed);
+        const std::uint64_t tail = tail_.load(std::memory_order_acquire);
+
+        if (head - tail >= capacity_) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        slots_[head & mask_] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    T*            slots() { return slots_.get(); }
+    std::uint32_t capacity() const { return capacity_; }
+
+    std::uint64_t* headWord() { return reinterpret_cast<std::uint64_t*>(&head_); }
+    std::uint64_t* tailWord() { return reinterpret_cast<std::uint64_t*>(&tail_); }
+    std::uint64_t* droppedWord() { return reinterpret_cast<std::uint64_t*>(&dropped_); }
+
+    std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    static std::uint32_t roundUp(std::uint32_t v)
+    {
+        std::uint32_t c = 2;
+        while (c < v && c < (1u << 30))
+            c <<= 1;
+        return c;
+    }
+
+    const std::uint32_t  capacity_;
+    const std::uint64_t  mask_;
+    std::unique_ptr<T[]> slots_;
+
+    alignas(64) std::atomic<std::uint64_t> head_{0};
+    alignas(64) std::atomic<std::uint64_t> tail_{0};
+    alignas(64) std::atomic<std::uint64_t> dropped_{0};
+};
@@ -0,0 +1,354 @@
+// vacuum_sim.cpp
+//
+// 가상 진공 컨트롤러. pty 쌍을 열고 VAC1 / VAC2 / STP3 프로토콜로 응답한다.
+// 출력된 slave 경로(또는 --link 경로)를 VacuumDevice::connectPort 에 그대로 넘기면 된다.
+//
+// 채널별 압력 곡선:
+//   pump-down : p = target * (1 - exp(-t / tau))          (0 <= t < pump-sec)
+//   hold/leak : p = p(pump-sec) - leak-rate * (t - pump-sec)
+// + gaussian noise, 응답 지연(latency + jitter), 응답 유실(drop-rate).
+// 압력은 convertRawToPressure 와 같은 보정 테이블(kDefaultCalibrationPoints)로 ADC byte 로 역변환해서 보낸다.
+//
+//   vacuum_sim [--link PATH] [--pump-sec 5] [--target-kpa 66] [--tau-sec 1.5]
+//              [--leak-rate 0] [--leak-rate2 0] [--noise-kpa 0.05]
+//              [--latency-ms 5] [--jitter-ms 1] [--drop-rate 0]
+//              [--idle-reset-sec 3] [--seed N] [--quiet]
+
+#include "vacuum_calibration.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace {
+
+volatile std::sig_atomic_t g_stop = 0;
+
+void onSignal(int)
+{
+    g_stop = 1;
+}
+
+struct Options {
+    std::string link;
+    double pumpSec      = 5.0;
+    double targetKpa    = 66.0;
+    double tauSec       = 1.5;
+    double leakRate[3]  = {0.0, 0.0, 0.0};   // index = channel (kPa/s)
+    double noiseKpa     = 0.05;
+    double latencyMs    = 5.0;
+    double jitterMs     = 1.0;
+    double dropRate     = 0.0;
+    double idleResetSec = 3.0;
+    unsigned seed       = 1;
+    bool   quiet        = false;
+};
+
+double nowSec()
+{
+    using namespace std::chrono;
+    return duration_cast<duration<double>>(steady_clock::now().time_since_epoch()).count();
+}
+
+// kPa -> ADC (보정 테이블 역보간)
+int pressureToRaw(double kpa)
+{
+    const CalibrationPoint* cal = kDefaultCalibrationPoints;
+    const int n = static_cast<int>(kDefaultCalibrationPointCount);
+
+    if (kpa >= cal[0].kpa)
+        return cal[0].adc;
+    if (kpa <= cal[n - 1].kpa)
+        return cal[n - 1].adc;
+
+    for (int i = 0; i < n - 1; ++i) {
+        const CalibrationPoint& a = cal[i];
+        const CalibrationPoint& b = cal[i + 1];
+        if (kpa <= a.kpa && kpa >= b.kpa) {
+            const double t = (a.kpa - kpa) / (a.kpa - b.kpa);
+            const int raw  = static_cast<int>(std::lround(a.adc + t * (b.adc - a.adc)));
+            return raw < 0 ? 0 : (raw > 255 ? 255 : raw);
+        }
+    }
+    return cal[n - 1].adc;
+}
+
+// ───────────────────────────────────────
+//  채널 모델
+// ───────────────────────────────────────
+struct Channel {
+    double startSec    = -1.0;   // 세션 시작 시각 (<0: 대기 중)
+    double lastCmdSec  = -1.0;
+
+    double pressureAt(const Options& opt, int ch, double t) const
+    {
+        if (t < opt.pumpSec)
+            return opt.targetKpa * (1.0 - std::exp(-t / opt.tauSec));
+
+        const double atHold = opt.targetKpa * (1.0 - std::exp(-opt.pumpSec / opt.tauSec));
+        const double p      = atHold - opt.leakRate[ch] * (t - opt.pumpSec);
+        return p < 0.0 ? 0.0 : p;
+    }
+};
+
+struct Response {
+    double        dueSec;
+    unsigned char raw;
+    bool operator>(const Response& o) const { return dueSec > o.dueSec; }
+};
+
+class Simulator
+{
+public:
+    explicit Simulator(const Options& opt)
+        : opt_(opt), rng_(opt.seed), noise_(0.0, opt.noiseKpa > 0.0 ? opt.noiseKpa : 1e-9),
+          jitter_(-opt.jitterMs, opt.jitterMs), drop_(0.0, 1.0) {}
+
+    bool open()
+    {
+        master_ = posix_openpt(O_RDWR | O_NOCTTY);
+        if (master_ < 0 || grantpt(master_) != 0 || unlockpt(master_) != 0) {
+            std::perror("posix_openpt");
+            return false;
+        }
+
+        slavePath_ = ptsname(master_);
+
+        // slave 를 하나 열어 두면 클라이언트가 닫았다 다시 열어도 EIO 가 나지 않는다.
+        // echo/canonical 모드를 끄지 않으면 응답 byte 가 명령으로 되돌아온다.
+        holdSlave_ = ::open(slavePath_.c_str(), O_RDWR | O_NOCTTY);
+        if (holdSlave_ < 0) {
+            std::perror("open slave");
+            return false;
+        }
+
+        termios tio{};
+        tcgetattr(holdSlave_, &tio);
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, B19200);
+        cfsetospeed(&tio, B19200);
+        tcsetattr(holdSlave_, TCSANOW, &tio);
+
+        if (!opt_.link.empty()) {
+            ::unlink(opt_.link.c_str());
+            if (::symlink(slavePath_.c_str(), opt_.link.c_str()) != 0) {
+                std::perror("symlink");
+                return false;
+            }
+        }
+
+        std::printf("%s\n", opt_.link.empty() ? slavePath_.c_str() : opt_.link.c_str());
+        std::fflush(stdout);
+        return true;
+    }
+
+    void close()
+    {
+        if (!opt_.link.empty())
+            ::unlink(opt_.link.c_str());
+        if (holdSlave_ >= 0) ::close(holdSlave_);
+        if (master_ >= 0)    ::close(master_);
+    }
+
+    void run()
+    {
+        std::vector<unsigned char> pending;
+
+        while (!g_stop) {
+            int timeoutMs = 100;
+            if (!responses_.empty()) {
+                const double wait = responses_.top().dueSec - nowSec();
+                timeoutMs = wait <= 0.0 ? 0 : static_cast<int>(wait * 1000.0) + 1;
+                if (timeoutMs > 100) timeoutMs = 100;
+            }
+
+            pollfd pfd{master_, POLLIN, 0};
+            const int r = ::poll(&pfd, 1, timeoutMs);
+            if (r < 0 && errno != EINTR)
+                break;
+
+            if (r > 0 && (pfd.revents & POLLIN)) {
+                unsigned char buf[256];
+                const ssize_t n = ::read(master_, buf, sizeof(buf));
+                if (n > 0)
+                    pending.insert(pending.end(), buf, buf + n);
+                parseCommands(pending);
+            }
+
+            const double now = nowSec();
+            while (!responses_.empty() && responses_.top().dueSec <= now) {
+                const unsigned char raw = responses_.top().raw;
+                const ssize_t w = ::write(master_, &raw, 1);
+                (void)w;
+                responses_.pop();
+            }
+        }
+    }
+
+private:
+    // 5-byte 명령 단위로 자른다. 'V' / 'S' 로 시작하지 않는 바이트는 버려서 재동기화
+    void parseCommands(std::vector<unsigned char>& buf)
+    {
+        std::size_t pos = 0;
+        while (buf.size() - pos >= 5) {
+            const unsigned char c = buf[pos];
+            if (c != 'V' && c != 'S') {
+                ++pos;
+                continue;
+            }
+            handleCommand(&buf[pos]);
+            pos += 5;
+        }
+        buf.erase(buf.begin(), buf.begin() + static_cast<std::ptrdiff_t>(pos));
+    }
+
+    void handleCommand(const unsigned char* cmd)
+    {
+        const double now = nowSec();
+
+        if (cmd[0] == 'S' && cmd[1] == 'T' && cmd[2] == 'P') {
+            // 펌프 정지 -> 다음 VAC 명령에서 새 세션
+            for (Channel& ch : channels_)
+                ch.startSec = -1.0;
+            log("STP3 -> reset");
+            return;
+        }
+
+        if (!(cmd[0] == 'V' && cmd[1] == 'A' && cmd[2] == 'C'))
+            return;
+
+        const int chIndex = (cmd[3] == '2') ? 2 : 1;
+        Channel& ch = channels_[chIndex];
+
+        if (ch.startSec < 0.0 || (ch.lastCmdSec >= 0.0 && now - ch.lastCmdSec > opt_.idleResetSec)) {
+            ch.startSec = now;
+            log(chIndex == 2 ? "VAC2 session start" : "VAC1 session start");
+        }
+        ch.lastCmdSec = now;
+
+        if (opt_.dropRate > 0.0 && drop_(rng_) < opt_.dropRate)
+            return;   // 응답 유실 시뮬레이션
+
+        double p = ch.pressureAt(opt_, chIndex, now - ch.startSec);
+        if (opt_.noiseKpa > 0.0)
+            p += noise_(rng_);
+
+        double delayMs = opt_.latencyMs + (opt_.jitterMs > 0.0 ? jitter_(rng_) : 0.0);
+        if (delayMs < 0.0)
+            delayMs = 0.0;
+
+        // 응답 순서 보존: 앞선 응답보다 먼저 나가지 않음
+        double due = now + delayMs / 1000.0;
+        if (due < lastDueSec_)
+            due = lastDueSec_;
+        lastDueSec_ = due;
+
+        responses_.push({due, static_cast<unsigned char>(pressureToRaw(p))});
+    }
+
+    void log(const char* msg) const
+    {
+        if (!opt_.quiet)
+            std::fprintf(stderr, "[vacuum_sim] %s\n", msg);
+    }
+
+    Options     opt_;
+    int         master_    = -1;
+    int         holdSlave_ = -1;
+    std::string slavePath_;
+    Channel     channels_[3];
+    double      lastDueSec_ = 0.0;
+
+    std::priority_queue<Response, std::vector<Response>, std::greater<Response>> responses_;
+
+    std::mt19937                           rng_;
+    std::normal_distribution<double>       noise_;
+    std::uniform_real_distribution<double> jitter_;
+    std::uniform_real_distribution<double> drop_;
+};
+
+bool parseDouble(const char* s, double& out)
+{
+    char* end = nullptr;
+    out = std::strtod(s, &end);
+    return end && *end == '\0';
+}
+
+void usage(const char* argv0)
+{
+    std::fprintf(stderr,
+                 "usage: %s [--link PATH] [--pump-sec S] [--target-kpa K] [--tau-sec S]\n"
+                 "          [--leak-rate KPA_PER_S] [--leak-rate2 KPA_PER_S] [--noise-kpa K]\n"
+                 "          [--latency-ms MS] [--jitter-ms MS] [--drop-rate P]\n"
+                 "          [--idle-reset-sec S] [--seed N] [--quiet]\n", argv0);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+
+        if (arg == "--quiet") {
+            opt.quiet = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return 2;
+        }
+
+        const char* val = argv[++i];
+        double d = 0.0;
+        bool ok = true;
+
+        if (arg == "--link")                opt.link = val;
+        else if (arg == "--seed")           opt.seed = static_cast<unsigned>(std::strtoul(val, nullptr, 10));
+        else if (!(ok = parseDouble(val, d))) {}
+        else if (arg == "--pump-sec")       opt.pumpSec = d;
+        else if (arg == "--target-kpa")     opt.targetKpa = d;
+        else if (arg == "--tau-sec")        opt.tauSec = d > 0.0 ? d : 1e-3;
+        else if (arg == "--leak-rate")      opt.leakRate[1] = d;
+        else if (arg == "--leak-rate2")     opt.leakRate[2] = d;
+        else if (arg == "--noise-kpa")      opt.noiseKpa = d;
+        else if (arg == "--latency-ms")     opt.latencyMs = d;
+        else if (arg == "--jitter-ms")      opt.jitterMs = d;
+        else if (arg == "--drop-rate")      opt.dropRate = d;
+        else if (arg == "--idle-reset-sec") opt.idleResetSec = d;
+        else ok = false;
+
+        if (!ok) {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    Simulator sim(opt);
+    if (!sim.open()) {
+        sim.close();
+        return 1;
+    }
+
+    sim.run();
+    sim.close();
+    return 0;
+}
@@ -0,0 +1,445 @@
+// vacuum_sweep.cpp
+
+#include "vacuum_sweep.h"
+#include "vacuum_work_pool.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// vacuum_leak_session.cpp 와 같은 시각 경계 보정
+constexpr double kTimeEpsilon = 1e-9;
+
+// trace 를 이만큼 묶어 격자 점 루프 안쪽에서 돈다.
+// 격자 점별 누적값을 trace 마다 읽고 쓰면 (10^5 점 = 수 MB) 메모리 대역폭에 묶이므로
+// 묶음당 한 번만 더하고, 묶음 안 trace 방향 루프는 분기 없이 SIMD 로 돈다
+constexpr std::size_t kBlock = 64;
+
+// worker 별 격자 점 누적값
+struct Partial {
+    std::vector<std::uint32_t> goodEvaluated, badEvaluated, falsePass, falseFail, incomplete;
+    std::vector<double>        cycleSec;
+
+    explicit Partial(std::size_t points)
+        : goodEvaluated(points), badEvaluated(points), falsePass(points), falseFail(points), incomplete(points),
+          cycleSec(points)
+    {
+    }
+};
+
+// trace 하나의 측정 구간 계열 (worker 별로 재사용)
+struct Series {
+    std::vector<float>         stopAvg;      // 측정 tick 별 이동 평균 (offset 빼기 전)
+    std::vector<float>         val;          // stopAvg - 시작 압력
+    std::vector<float>         posMax;       // prefix max(val, 0)
+    std::vector<float>         negMax;       // prefix max(-val, 0)
+    std::vector<float>         pressMin;     // prefix min(stopAvg + |val| * hrate)
+    std::vector<std::uint32_t> sameClamp;    // offset 이 같은 첫 clamp index (결과 복사)
+};
+
+// trace 묶음의 (startOffset, window) 하나에 대한 중간값. 모든 배열은 trace 가 가장 안쪽 (stride kBlock).
+// 판정 루프가 한 폭(32 bit)으로 SIMD 되도록 flag 도 int32, 판정 시각은 tick 수 (feed 시각 = tick 수 * tickSec)
+struct Block {
+    std::size_t n = 0;
+
+    // trace 별
+    std::vector<std::int32_t> good;
+    std::vector<std::int32_t> measured;    // 측정 tick 이 하나 이상 있음
+    std::vector<float>        startRaw;    // 시작 평균 (offset 빼기 전)
+    std::vector<float>        lastAvg;     // 마지막 측정 tick 이동 평균 (manual 판정)
+    std::vector<std::int32_t> traceTicks;
+    std::vector<std::int32_t> firstTick;   // 측정 tick j 의 feed 시각 = (firstTick + j) tick
+
+    // (duration, trace) 별
+    std::vector<std::int32_t> manual;
+    std::vector<std::int32_t> reached;     // Done tick 이 trace 안에 있음
+    std::vector<std::int32_t> doneTick;    // 측정 tick index (없으면 측정 tick 수)
+    std::vector<float>        doneAvg;
+    std::vector<std::int32_t> doneAt;      // Done tick 의 feed 시각 (tick 수)
+
+    // (clamp, trace) 별
+    std::vector<float> offset;
+
+    // (hrate, lane, trace) / (hrate, minDiff, trace) 별 처음 기준을 벗어나는 측정 tick
+    std::vector<std::int32_t> failPress;
+    std::vector<std::int32_t> failDiff;
+};
+
+// 단조 증가 prefix 에서 처음 prefix * scale > limit 인 index (없으면 size)
+std::int32_t firstAbove(const std::vector<float>& prefix, float scale, float limit)
+{
+    const auto it = std::partition_point(prefix.begin(), prefix.end(),
+                                         [scale, limit](float v) { return !(v * scale > limit); });
+    return static_cast<std::int32_t>(it - prefix.begin());
+}
+
+class BlockSweeper
+{
+public:
+    BlockSweeper(const SweepGrid& grid, double tickSec) : grid_(grid), tickSec_(tickSec)
+    {
+        lanes_ = grid.minPress.size() * grid.offsetClamp.size();
+
+        // 격자 stride (offsetClamp 가 가장 안쪽)
+        strideMinDiff_ = lanes_;
+        strideHrate_   = grid.minDiff.size() * strideMinDiff_;
+        strideDur_     = grid.hrate.size() * strideHrate_;
+        strideWindow_  = grid.durationSec.size() * strideDur_;
+        strideOffset_  = grid.averagingWindow.size() * strideWindow_;
+
+        pressOrder_.resize(grid.minPress.size());
+        for (std::size_t p = 0; p < pressOrder_.size(); ++p)
+            pressOrder_[p] = static_cast<std::uint32_t>(p);
+        std::sort(pressOrder_.begin(), pressOrder_.end(),
+                  [&grid](std::uint32_t a, std::uint32_t c) { return grid.minPress[a] > grid.minPress[c]; });
+    }
+
+    // traces[0..n) (n <= kBlock) 를 모든 격자 점에 대해 평가해서 out 에 더함
+    void run(const ReplayCorpus& corpus, const std::pair<std::size_t, bool>* traces, std::size_t n, Partial& out,
+             Block& b, Series& s) const
+    {
+        for (std::size_t oi = 0; oi < grid_.startOffsetSec.size(); ++oi) {
+            for (std::size_t wi = 0; wi < grid_.averagingWindow.size(); ++wi) {
+                prepare(b, n);
+                for (std::size_t t = 0; t < n; ++t) {
+                    const std::size_t index = traces[t].first;
+                    const ReplayCorpus::Trace& trace = corpus.trace(index);
+                    b.good[t] = traces[t].second ? 1 : 0;
+                    fillTrace(corpus.ticks(index), trace.count, trace.recordedSec, grid_.startOffsetSec[oi],
+                              grid_.averagingWindow[wi], t, b, s);
+                }
+                accumulate(b, oi * strideOffset_ + wi * strideWindow_, out);
+            }
+        }
+    }
+
+private:
+    void prepare(Block& b, std::size_t n) const
+    {
+        const std::size_t durations = grid_.durationSec.size();
+        b.n = n;
+        b.good.assign(kBlock, 0);
+        b.measured.assign(kBlock, 0);
+        b.startRaw.assign(kBlock, 0.0f);
+        b.lastAvg.assign(kBlock, 0.0f);
+        b.traceTicks.assign(kBlock, 0);
+        b.firstTick.assign(kBlock, 0);
+        b.manual.assign(durations * kBlock, 0);
+        b.reached.assign(durations * kBlock, 0);
+        b.doneTick.assign(durations * kBlock, 0);
+        b.doneAvg.assign(durations * kBlock, 0.0f);
+        b.doneAt.assign(durations * kBlock, 0);
+        b.offset.assign(grid_.offsetClamp.size() * kBlock, 0.0f);
+        b.failPress.assign(grid_.hrate.size() * lanes_ * kBlock, 0);
+        b.failDiff.assign(grid_.hrate.size() * grid_.minDiff.size() * kBlock, 0);
+    }
+
+    double durationOf(std::size_t di, float recordedSec) const
+    {
+        const float d = grid_.durationSec[di];
+        return d < 0.0f ? inferDurationSec(recordedSec) : static_cast<double>(d);
+    }
+
+    // trace 하나의 시작 압력 / stopAvg 계열 -> hrate, minDiff, (minPress, clamp) 별 FAIL tick
+    void fillTrace(const float* ticks, std::size_t count, float recordedSec, float startOffsetSec, int window,
+                   std::size_t t, Block& b, Series& s) const
+    {
+        if (!AveragingFilter::isSupportedWindow(window))
+            window = AveragingFilter::kDefaultWindow;   // LeakTestSession::reset 과 같음
+
+        const std::size_t durations = grid_.durationSec.size();
+        b.traceTicks[t] = static_cast<std::int32_t>(count);
+        for (std::size_t di = 0; di < durations; ++di)
+            b.manual[di * kBlock + t] = durationOf(di, recordedSec) <= 0.0 ? 1 : 0;
+
+        // Stabilizing: feed((k + 1) * tick) 가 startOffset 이하인 tick
+        std::size_t first = 0;
+        while (first < count &&
+               static_cast<double>(first + 1) * tickSec_ <= static_cast<double>(startOffsetSec) + kTimeEpsilon)
+            ++first;
+        const std::size_t capture = first + static_cast<std::size_t>(window) - 1;   // 시작 압력 확정 tick
+        if (capture + 1 >= count)
+            return;   // 측정 tick 없음: manual 은 PASS (Averaging 까지는 항상 PASS), 자동은 미완료
+
+        // 시작/종료 평균은 같은 샘플로 채우므로 filter 하나로 둘 다 얻는다
+        AveragingFilter avg(window);
+        float startRaw = 0.0f;
+        for (std::size_t k = first; k <= capture; ++k)
+            startRaw = avg.push(ticks[k]);
+
+        // 측정 tick j = capture + 1 + j
+        const std::size_t m = count - capture - 1;
+        s.stopAvg.resize(m);
+        s.val.resize(m);
+        s.posMax.resize(m);
+        s.negMax.resize(m);
+        s.pressMin.resize(m);
+        float pos = 0.0f, neg = 0.0f;
+        for (std::size_t j = 0; j < m; ++j) {
+            const float sp = avg.push(ticks[capture + 1 + j]);
+            const float v  = sp - startRaw;
+            s.stopAvg[j] = sp;
+            s.val[j]     = v;
+            pos = std::max(pos, v);
+            neg = std::max(neg, -v);
+            s.posMax[j] = pos;
+            s.negMax[j] = neg;
+        }
+
+        b.measured[t]  = 1;
+        b.startRaw[t]  = startRaw;
+        b.lastAvg[t]   = s.stopAvg[m - 1];
+        b.firstTick[t] = static_cast<std::int32_t>(capture + 2);
+
+        // Done tick: feed 시각이 captureSec + duration 을 처음 넘는 측정 tick
+        const double captureSec = static_cast<double>(capture + 1) * tickSec_;
+        for (std::size_t di = 0; di < durations; ++di) {
+            const std::size_t at = di * kBlock + t;
+            if (b.manual[at]) {
+                b.doneTick[at] = static_cast<std::int32_t>(m);
+                continue;
+            }
+            const double limitSec = captureSec + durationOf(di, recordedSec) + kTimeEpsilon;
+            const double k = std::floor(limitSec / tickSec_);
+            std::size_t done = k > static_cast<double>(capture + 1) ? static_cast<std::size_t>(k) - capture - 1 : 0;
+            while (done > 0 && static_cast<double>(capture + 1 + done) * tickSec_ > limitSec)
+                --done;
+            while (static_cast<double>(capture + 2 + done) * tickSec_ <= limitSec)
+                ++done;
+
+            b.reached[at]  = done < m ? 1 : 0;
+            b.doneTick[at] = static_cast<std::int32_t>(std::min(done, m));
+            b.doneAvg[at]  = done < m ? s.stopAvg[done] : 0.0f;
+            b.doneAt[at]   = static_cast<std::int32_t>(capture + 2 + done);
+        }
+
+        // lane = (minPress, clamp). offset 은 clamp 에만 의존
+        const std::size_t clamps = grid_.offsetClamp.size();
+        for (std::size_t ci = 0; ci < clamps; ++ci) {
+            const float clamp = grid_.offsetClamp[ci];
+            b.offset[ci * kBlock + t] = startRaw > clamp ? startRaw - clamp : 0.0f;
+        }
+        // 시작 압력보다 큰 clamp 는 모두 offset 0 -> 보통 offset 종류는 clamp 수보다 훨씬 적다
+        s.sameClamp.resize(clamps);
+        for (std::size_t ci = 0; ci < clamps; ++ci) {
+            std::size_t same = 0;
+            while (b.offset[same * kBlock + t] != b.offset[ci * kBlock + t])
+                ++same;
+            s.sameClamp[ci] = static_cast<std::uint32_t>(same);
+        }
+
+        const std::size_t diffs = grid_.minDiff.size();
+        for (std::size_t hi = 0; hi < grid_.hrate.size(); ++hi) {
+            const float h = grid_.hrate[hi];
+
+            // sp < minPress  <=>  stopAvg + |val| * h < minPress + offset
+            float lo = 0.0f;
+            for (std::size_t j = 0; j < m; ++j) {
+                const float v  = s.val[j];
+                const float sp = s.stopAvg[j] + (v < 0.0f ? -(v * h) : v * h);
+                lo = j ? std::min(lo, sp) : sp;
+                s.pressMin[j] = lo;
+            }
+            // offset 하나에 대해 minPress 내림차순으로 돌면 FAIL index 가 되돌아가지 않으므로 prefix 를 한 번만 훑는다
+            std::int32_t* failPress = b.failPress.data() + hi * lanes_ * kBlock + t;
+            for (std::size_t ci = 0; ci < clamps; ++ci) {
+                const std::size_t same = s.sameClamp[ci];
+                if (same != ci) {
+                    for (std::size_t p = 0; p < grid_.minPress.size(); ++p)
+                        failPress[(p * clamps + ci) * kBlock] = failPress[(p * clamps + same) * kBlock];
+                    continue;
+                }
+                const float offset = b.offset[ci * kBlock + t];
+                std::size_t j = 0;
+                for (std::uint32_t p : pressOrder_) {
+                    const float limit = grid_.minPress[p] + offset;
+                    while (j < m && !(s.pressMin[j] < limit))
+                        ++j;
+                    failPress[(p * clamps + ci) * kBlock] = static_cast<std::int32_t>(j);
+                }
+            }
+
+            // diff = val + |val| * h -> 양수 쪽 val * (1 + h), 음수 쪽 |val| * |1 - h|
+            const float upScale   = 1.0f + h;
+            const float downScale = std::fabs(1.0f - h);
+            for (std::size_t dd = 0; dd < diffs; ++dd) {
+                const float limit = grid_.minDiff[dd];
+                b.failDiff[(hi * diffs + dd) * kBlock + t] =
+                    std::min(firstAbove(s.posMax, upScale, limit), firstAbove(s.negMax, downScale, limit));
+            }
+        }
+    }
+
+    // 격자 점 x 묶음 trace. trace 방향 루프는 분기 없음.
+    // 판정식은 LeakTestSession::feed 그대로 (Done tick 은 hrate 미적용, manual 은 마지막 tick 에 hrate 적용)
+    void accumulate(const Block& b, std::size_t base, Partial& out) const
+    {
+        const std::size_t n      = b.n;
+        const std::size_t clamps = grid_.offsetClamp.size();
+        const std::size_t diffs  = grid_.minDiff.size();
+        const std::int32_t* isGood    = b.good.data();
+        const std::int32_t* measured  = b.measured.data();
+        const float*        startRaw  = b.startRaw.data();
+        const float*        lastAvg   = b.lastAvg.data();
+        const std::int32_t* traceTicks = b.traceTicks.data();
+        const std::int32_t* firstTick = b.firstTick.data();
+
+        for (std::size_t di = 0; di < grid_.durationSec.size(); ++di) {
+            const std::int32_t* manual   = b.manual.data() + di * kBlock;
+            const std::int32_t* reached  = b.reached.data() + di * kBlock;
+            const std::int32_t* doneTick = b.doneTick.data() + di * kBlock;
+            const float*        doneAvg  = b.doneAvg.data() + di * kBlock;
+            const std::int32_t* doneAt   = b.doneAt.data() + di * kBlock;
+
+            for (std::size_t hi = 0; hi < grid_.hrate.size(); ++hi) {
+                const float h = grid_.hrate[hi];
+                for (std::size_t dd = 0; dd < diffs; ++dd) {
+                    const float         minDiff  = grid_.minDiff[dd];
+                    const std::int32_t* failDiff = b.failDiff.data() + (hi * diffs + dd) * kBlock;
+
+                    for (std::size_t q = 0; q < lanes_; ++q) {
+                        const float         minPress  = grid_.minPress[q / clamps];
+                        const float*        offset    = b.offset.data() + (q % clamps) * kBlock;
+                        const std::int32_t* failPress = b.failPress.data() + (hi * lanes_ + q) * kBlock;
+
+                        std::int32_t goodEval = 0, badEval = 0, falsePass = 0, falseFail = 0, incomplete = 0;
+                        std::int32_t cycleTicks = 0;
+                        for (std::size_t t = 0; t < n; ++t) {
+                            // 조건부 load 가 있으면 vectorize 되지 않으므로 전부 읽고 고른다
+                            const float        off   = offset[t];
+                            const float        st    = startRaw[t] - off;
+                            const std::int32_t man   = manual[t];
+                            const std::int32_t done  = reached[t];
+                            const std::int32_t good  = isGood[t];
+
+                            const std::int32_t failAt = std::min(failDiff[t], failPress[t]);
+                            const std::int32_t failed = failAt < doneTick[t];
+
+                            const float spDone   = doneAvg[t] - off;
+                            const float diffDone = spDone - st;
+                            const std::int32_t donePass =
+                                done & (spDone >= minPress) & (diffDone <= minDiff) & (diffDone >= -minDiff);
+
+                            float spLast = lastAvg[t] - off;
+                            spLast += std::fabs((spLast - st) * h);
+                            const float diffLast = spLast - st;
+                            const std::int32_t manualPass =
+                                (1 - measured[t]) | ((spLast >= minPress) & (diffLast <= minDiff) & (diffLast >= -minDiff));
+
+                            const std::int32_t finished = man | failed | done;
+                            const std::int32_t pass     = (man & manualPass) | ((1 - man) & (1 - failed) & donePass);
+                            // 판정 시각 선택도 0/1 flag 를 mask 로 써서 (삼항 연산자는 분기로 남음)
+                            const std::int32_t traceEnd = traceTicks[t];
+                            const std::int32_t failEnd  = firstTick[t] + failAt;
+                            const std::int32_t doneEnd  = doneAt[t];
+                            const std::int32_t end =
+                                (-man & traceEnd) | (~-man & ((-failed & failEnd) | (~-failed & doneEnd)));
+
+                            goodEval   += finished & good;
+                            badEval    += finished & (1 - good);
+                            falseFail  += finished & good & (1 - pass);
+                            falsePass  += (1 - good) & pass;
+                            incomplete += 1 - finished;
+                            cycleTicks += -finished & end;
+                        }
+
+                        const std::size_t i = base + di * strideDur_ + hi * strideHrate_ + dd * strideMinDiff_ + q;
+                        out.goodEvaluated[i] += static_cast<std::uint32_t>(goodEval);
+                        out.badEvaluated[i]  += static_cast<std::uint32_t>(badEval);
+                        out.falsePass[i]     += static_cast<std::uint32_t>(falsePass);
+                        out.falseFail[i]     += static_cast<std::uint32_t>(falseFail);
+                        out.incomplete[i]    += static_cast<std::uint32_t>(incomplete);
+                        out.cycleSec[i]      += static_cast<double>(cycleTicks) * tickSec_;
+                    }
+                }
+            }
+        }
+    }
+
+    const SweepGrid& grid_;
+    double           tickSec_;
+    std::size_t      lanes_         = 0;
+    std::size_t      strideMinDiff_ = 0;
+    std::size_t      strideHrate_   = 0;
+    std::size_t      strideDur_     = 0;
+    std::size_t      strideWindow_  = 0;
+    std::size_t      strideOffset_  = 0;
+
+    std::vector<std::uint32_t> pressOrder_;   // minPress 내림차순 index
+};
+
+} // namespace
+
+SweepPoint sweepPoint(const SweepGrid& grid, std::size_t index)
+{
+    SweepPoint p;
+    p.offsetClamp     = grid.offsetClamp[index % grid.offsetClamp.size()];
+    index /= grid.offsetClamp.size();
+    p.minPress        = grid.minPress[index % grid.minPress.size()];
+    index /= grid.minPress.size();
+    p.minDiff         = grid.minDiff[index % grid.minDiff.size()];
+    index /= grid.minDiff.size();
+    p.hrate           = grid.hrate[index % grid.hrate.size()];
+    index /= grid.hrate.size();
+    p.durationSec     = grid.durationSec[index % grid.durationSec.size()];
+    index /= grid.durationSec.size();
+    p.averagingWindow = grid.averagingWindow[index % grid.averagingWindow.size()];
+    index /= grid.averagingWindow.size();
+    p.startOffsetSec  = grid.startOffsetSec[index % grid.startOffsetSec.size()];
+    return p;
+}
+
+std::vector<SweepResult> runSweep(const ReplayCorpus& corpus, const SweepGrid& grid, const WorkStealingPool& pool,
+                                  int channel, bool useStoredVerdict)
+{
+    const std::size_t points = grid.size();
+    std::vector<SweepResult> results(points);
+    for (std::size_t i = 0; i < points; ++i)
+        results[i].point = sweepPoint(grid, i);
+    if (points == 0)
+        return results;
+
+    // 평가 대상 trace 와 라벨 (true = 양품)
+    std::vector<std::pair<std::size_t, bool>> work;
+    work.reserve(corpus.size());
+    for (std::size_t i = 0; i < corpus.size(); ++i) {
+        const ReplayCorpus::Trace& t = corpus.trace(i);
+        if (channel != 0 && t.channel != channel)
+            continue;
+        const int label = t.label >= 0 ? t.label : (useStoredVerdict ? t.storedPass : -1);
+        if (label >= 0)
+            work.emplace_back(i, label != 0);
+    }
+
+    const BlockSweeper sweeper(grid, corpus.tickSec());
+    std::vector<Partial> partials;
+    partials.reserve(static_cast<std::size_t>(pool.threads()));
+    for (int w = 0; w < pool.threads(); ++w)
+        partials.emplace_back(points);
+
+    // chunk = trace 묶음 하나 (격자 점 수 x kBlock 판정)
+    const std::size_t blocks = (work.size() + kBlock - 1) / kBlock;
+    pool.parallelFor(blocks, 1, [&](std::size_t begin, std::size_t end, int worker) {
+        Partial& part = partials[static_cast<std::size_t>(worker)];
+        Block  block;
+        Series series;
+        for (std::size_t i = begin; i < end; ++i) {
+            const std::size_t first = i * kBlock;
+            sweeper.run(corpus, work.data() + first, std::min(kBlock, work.size() - first), part, block, series);
+        }
+    });
+
+    for (const Partial& part : partials) {
+        for (std::size_t i = 0; i < points; ++i) {
+            SweepResult& r = results[i];
+            r.goodEvaluated += part.goodEvaluated[i];
+            r.badEvaluated  += part.badEvaluated[i];
+            r.falsePass     += part.falsePass[i];
+            r.falseFail     += part.falseFail[i];
+            r.incomplete    += part.incomplete[i];
+            r.cycleSecSum   += part.cycleSec[i];
+        }
+    }
+    return results;
+}
@@ -0,0 +1,86 @@
+// vacuum_sweep.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "vacuum_replay.h"
+
+class WorkStealingPool;
+
+// 판정 파라미터 격자를 라벨된 trace corpus 전체에 대해 평가한다.
+//
+// 격자 점 = (startOffsetSec, averagingWindow, durationSec, hrate, minDiff, minPress, offsetClamp).
+// startOffset/window 가 같으면 시작 압력과 이동 평균(stopAvg) 계열이 같으므로 trace 당 한 번만 만들고,
+// 나머지 차원은 그 계열의 prefix max/min 위에서 "처음 기준을 벗어나는 tick" 을 찾는 문제로 바꾼다.
+//   diff = val + |val| * hrate        (val = stopAvg - 시작압력, offset 은 양쪽에서 상쇄)
+//   sp   = stopAvg + |val| * hrate - offset(clamp)
+//   FAIL tick = min(first k: |diff| > minDiff, first k: sp < minPress)
+// -> (hrate, minDiff) 별 / (hrate, minPress + offset) 별 FAIL tick 을 trace 당 한 번 구하고, 격자 점 하나는 min/비교 몇 번.
+//    trace 64 개씩 묶어 격자 점 루프 안쪽에서 trace 방향으로 분기 없이 돌기 때문에 SIMD 로 묶인다.
+// LeakTestSession 과 식은 같고 float 반올림 순서만 다르다 (경계값에서만 차이 가능).
+// earlyDecision / adaptiveSettling 은 평가하지 않는다.
+//
+// 준비시간/hrate 기본값은 둘 다 CHUCK 지그 값이다. PAK trace 를 평가할 때는 forFixture<PakFixture>()
+// 로 만들거나 두 차원을 함께 지정한다 (한쪽만 바꾸면 두 지그의 값이 섞인다).
+struct SweepGrid {
+    std::vector<float> startOffsetSec{static_cast<float>(ChuckFixture::kStartOffsetSec)};
+    std::vector<int>   averagingWindow{5};
+    std::vector<float> durationSec{-1.0f};   // < 0: trace 별 추정 (replayConfig 와 같음), 0: manual
+    std::vector<float> hrate{ChuckFixture::kHrate};
+    std::vector<float> minDiff{kDefaultMinDiff};
+    std::vector<float> minPress{kDefaultMinPress};
+    std::vector<float> offsetClamp{kDefaultOffsetClamp};
+
+    // 준비시간/hrate 를 지그 Policy 기본값으로 채운 격자
+    template <typename Policy>
+    static SweepGrid forFixture()
+    {
+        SweepGrid grid;
+        grid.startOffsetSec = {static_cast<float>(Policy::kStartOffsetSec)};
+        grid.hrate          = {Policy::kHrate};
+        return grid;
+    }
+
+    std::size_t size() const
+    {
+        return startOffsetSec.size() * averagingWindow.size() * durationSec.size() * hrate.size() *
+               minDiff.size() * minPress.size() * offsetClamp.size();
+    }
+};
+
+struct SweepPoint {
+    float startOffsetSec;
+    int   averagingWindow;
+    float durationSec;
+    float hrate;
+    float minDiff;
+    float minPress;
+    float offsetClamp;
+};
+
+struct SweepResult {
+    SweepPoint    point;
+    std::uint32_t goodEvaluated = 0;   // 라벨 양품 중 판정이 끝난 trace
+    std::uint32_t badEvaluated  = 0;   // 라벨 불량 중 판정이 끝난 trace
+    std::uint32_t falsePass     = 0;   // 불량인데 PASS
+    std::uint32_t falseFail     = 0;   // 양품인데 FAIL
+    std::uint32_t incomplete    = 0;   // trace 가 짧아 판정이 끝나지 않음
+    double        cycleSecSum   = 0.0; // 판정이 끝난 trace 의 검사 시간 합
+
+    double falsePassRate() const { return badEvaluated ? double(falsePass) / badEvaluated : 0.0; }
+    double falseFailRate() const { return goodEvaluated ? double(falseFail) / goodEvaluated : 0.0; }
+    double meanCycleSec() const
+    {
+        const std::uint32_t n = goodEvaluated + badEvaluated;
+        return n ? cycleSecSum / n : 0.0;
+    }
+};
+
+// point index -> 파라미터 (hrate 이하 안쪽 차원이 빠르게 변함, offsetClamp 가 가장 안쪽)
+SweepPoint sweepPoint(const SweepGrid& grid, std::size_t index);
+
+// 라벨(trace.label, 없으면 useStoredVerdict 일 때 기록 판정)이 있는 trace 만 평가. channel 0 = 전체
+std::vector<SweepResult> runSweep(const ReplayCorpus& corpus, const SweepGrid& grid, const WorkStealingPool& pool,
+                                  int channel = 0, bool useStoredVerdict = false);
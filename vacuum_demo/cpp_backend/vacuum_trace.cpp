@@ -0,0 +1,121 @@
+// vacuum_trace.cpp
+
+#include "vacuum_trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<std::uint8_t> TraceLog::level_{static_cast<std::uint8_t>(TraceLevel::Info)};
+
+namespace {
+
+struct ThreadRing {
+    std::atomic<std::uint64_t> head{0};
+    std::atomic<bool>          inUse{false};
+    std::uint8_t               id = 0;
+    TraceRecord                slots[TraceLog::kRingSize];
+};
+
+std::mutex                               g_ringsMutex;
+std::vector<std::unique_ptr<ThreadRing>> g_rings;
+
+// 종료된 스레드의 ring 은 다음 스레드가 이어서 쓴다 (acquisition 재시작마다 늘지 않게)
+ThreadRing* claimRing()
+{
+    std::lock_guard<std::mutex> lock(g_ringsMutex);
+    for (const auto& r : g_rings) {
+        bool expected = false;
+        if (r->inUse.compare_exchange_strong(expected, true))
+            return r.get();
+    }
+
+    std::unique_ptr<ThreadRing> ring(new ThreadRing());
+    ring->id = static_cast<std::uint8_t>(g_rings.size());
+    ring->inUse.store(true);
+    g_rings.push_back(std::move(ring));
+    return g_rings.back().get();
+}
+
+struct ThreadRingHolder {
+    ThreadRing* ring = nullptr;
+
+    ~ThreadRingHolder()
+    {
+        if (ring)
+            ring->inUse.store(false, std::memory_order_release);
+    }
+};
+
+thread_local ThreadRingHolder t_ring;
+
+} // namespace
+
+void TraceLog::write(TraceLevel level, TraceEvent event, std::int32_t a, std::int32_t b,
+                     float f0, float f1, float f2)
+{
+    ThreadRing* ring = t_ring.ring;
+    if (!ring)
+        ring = t_ring.ring = claimRing();
+
+    const std::uint64_t h = ring->head.load(std::memory_order_relaxed);
+    TraceRecord& rec = ring->slots[h & (kRingSize - 1)];
+
+    rec.timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::steady_clock::now().time_since_epoch()).count();
+    rec.event  = static_cast<std::uint16_t>(event);
+    rec.level  = static_cast<std::uint8_t>(level);
+    rec.thread = ring->id;
+    rec.a      = a;
+    rec.b      = b;
+    rec.f[0]   = f0;
+    rec.f[1]   = f1;
+    rec.f[2]   = f2;
+
+    ring->head.store(h + 1, std::memory_order_release);
+}
+
+bool TraceLog::dump(const std::string& path, std::string* error)
+{
+    std::vector<TraceRecord> records;
+    std::uint64_t dropped = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(g_ringsMutex);
+        for (const auto& r : g_rings) {
+            const std::uint64_t head  = r->head.load(std::memory_order_acquire);
+            const std::uint64_t first = head > kRingSize ? head - kRingSize : 0;
+            dropped += first;
+            for (std::uint64_t i = first; i < head; ++i)
+                records.push_back(r->slots[i & (kRingSize - 1)]);
+        }
+    }
+
+    std::stable_sort(records.begin(), records.end(),
+                     [](const TraceRecord& x, const TraceRecord& y) { return x.timestampNs < y.timestampNs; });
+
+    TraceFileHeader header{};
+    std::memcpy(header.magic, "VACTRC1", 8);
+    header.recordSize = sizeof(TraceRecord);
+    header.count      = records.size();
+    header.dropped    = dropped;
+
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        if (error) *error = "cannot open " + path;
+        return false;
+    }
+
+    bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1;
+    if (ok && !records.empty())
+        ok = std::fwrite(records.data(), sizeof(TraceRecord), records.size(), f) == records.size();
+    ok = (std::fclose(f) == 0) && ok;
+
+    if (!ok && error)
+        *error = "write failed: " + path;
+    return ok;
+}
@@ -0,0 +1,110 @@
+// vacuum_trace.h
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// 측정 경로용 binary trace log.
+// 문자열 포맷/stderr 대신 32-byte 고정 레코드를 스레드별 ring 에 기록하고,
+// vacuum_trace_dump() 로 파일에 내린 뒤 vacuum_trace_decode 로 읽는다.
+//  - 컴파일 타임: VACUUM_TRACE_MIN_LEVEL 미만의 VACUUM_TRACE 는 코드에서 사라진다
+//  - 실행 시간:   TraceLog::setLevel() 미만은 atomic load 1 회 후 return
+// 기록 비용은 timestamp + 32-byte store 정도 (lock / 할당 없음).
+
+#ifndef VACUUM_TRACE_MIN_LEVEL
+#define VACUUM_TRACE_MIN_LEVEL 1   // 0=Debug 까지 컴파일, 1=Info 이상만
+#endif
+
+enum class TraceLevel : std::uint8_t {
+    Debug = 0,
+    Info  = 1,
+    Warn  = 2,
+    Off   = 3,
+};
+
+// 레코드 종류. 값은 파일 포맷의 일부이므로 바꾸지 말고 뒤에 추가할 것
+enum class TraceEvent : std::uint16_t {
+    CommandSent   = 1,   // a = 명령 길이, b = 명령 앞 4 byte
+    BytesReceived = 2,   // a = 길이, b = 앞 4 byte
+    StaleDropped  = 3,   // a = 길이, b = 앞 4 byte
+    ShortFrame    = 4,   // a = 받은 길이, b = 기대 길이
+    NoResponse    = 5,   // a = channel
+    Measure       = 6,   // a = channel, b = raw, f0 = kPa
+    Decision      = 7,   // a = counter, b = channel<<16 | phase<<8 | flags, f0 = kPa, f1 = stop, f2 = diff
+    Settled       = 8,   // a = channel, f0 = settledSec, f1 = savedSec
+    EarlyDecision = 9,   // a = channel, b = pass, f0 = slope, f1 = savedSec
+    Step          = 10,  // a = elapsedSteps, b = pass, f0 = kPa
+    PipelineTimeout = 11,// a = in-flight 수
+};
+
+// Decision 레코드 flags
+enum : std::int32_t {
+    kTracePass  = 1 << 0,
+    kTraceStop  = 1 << 1,
+    kTraceEarly = 1 << 2,
+};
+
+struct TraceRecord {
+    std::int64_t  timestampNs;   // steady clock
+    std::uint16_t event;         // TraceEvent
+    std::uint8_t  level;         // TraceLevel
+    std::uint8_t  thread;        // 스레드 등록 순서 (0~255)
+    std::int32_t  a;
+    std::int32_t  b;
+    float         f[3];
+};
+static_assert(sizeof(TraceRecord) == 32, "TraceRecord is a file format");
+
+// dump 파일: TraceFileHeader + TraceRecord[count] (시간순 정렬)
+struct TraceFileHeader {
+    char          magic[8];      // "VACTRC1\0"
+    std::uint32_t recordSize;    // sizeof(TraceRecord)
+    std::uint32_t reserved;
+    std::uint64_t count;
+    std::uint64_t dropped;       // ring 이 덮어써서 잃은 레코드 수 (전체 스레드 합)
+};
+static_assert(sizeof(TraceFileHeader) == 32, "TraceFileHeader is a file format");
+
+class TraceLog
+{
+public:
+    static constexpr std::uint32_t kRingSize = 4096;   // 스레드당 레코드 수 (2 의 거듭제곱)
+
+    static void setLevel(TraceLevel level) { level_.store(static_cast<std::uint8_t>(level), std::memory_order_relaxed); }
+    static TraceLevel level() { return static_cast<TraceLevel>(level_.load(std::memory_order_relaxed)); }
+
+    static bool enabled(TraceLevel level)
+    {
+        return static_cast<std::uint8_t>(level) >= level_.load(std::memory_order_relaxed);
+    }
+
+    static void write(TraceLevel level, TraceEvent event, std::int32_t a, std::int32_t b,
+                      float f0, float f1, float f2);
+
+    // 모든 스레드의 ring 을 시간순으로 합쳐 파일에 기록. 기록 중인 스레드와 동시에 호출 가능
+    // (동시에 덮어써진 slot 은 깨질 수 있으므로 측정 종료 후 호출 권장)
+    static bool dump(const std::string& path, std::string* error = nullptr);
+
+    // 명령/응답 byte 앞 4 개를 b 필드로 (little endian)
+    static std::int32_t packBytes(const char* data, int size)
+    {
+        std::uint32_t v = 0;
+        for (int i = 0; i < size && i < 4; ++i)
+            v |= static_cast<std::uint32_t>(static_cast<std::uint8_t>(data[i])) << (8 * i);
+        return static_cast<std::int32_t>(v);
+    }
+
+private:
+    static std::atomic<std::uint8_t> level_;
+};
+
+#define VACUUM_TRACE_AT(lvl, event, a, b, f0, f1, f2)                                        \
+    do {                                                                                     \
+        if (static_cast<int>(lvl) >= VACUUM_TRACE_MIN_LEVEL && TraceLog::enabled(lvl))       \
+            TraceLog::write((lvl), (event), (a), (b), (f0), (f1), (f2));                     \
+    } while (0)
+
+#define VACUUM_TRACE_DEBUG(event, a, b, f0, f1, f2) VACUUM_TRACE_AT(TraceLevel::Debug, event, a, b, f0, f1, f2)
+#define VACUUM_TRACE_INFO(event, a, b, f0, f1, f2)  VACUUM_TRACE_AT(TraceLevel::Info, event, a, b, f0, f1, f2)
+#define VACUUM_TRACE_WARN(event, a, b, f0, f1, f2)  VACUUM_TRACE_AT(TraceLevel::Warn, event, a, b, f0, f1, f2)
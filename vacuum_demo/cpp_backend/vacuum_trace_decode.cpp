@@ -0,0 +1,167 @@
+// vacuum_trace_decode.cpp
+//
+// vacuum_trace_dump() 로 내린 binary trace 를 사람이 읽는 텍스트로 출력한다.
+// 시간은 첫 레코드 기준 상대 시간(ms).
+//
+//   vacuum_trace_decode FILE [--level debug|info|warn] [--csv]
+
+#include "vacuum_trace.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* eventName(std::uint16_t e)
+{
+    switch (static_cast<TraceEvent>(e)) {
+    case TraceEvent::CommandSent:     return "CMD";
+    case TraceEvent::BytesReceived:   return "RX";
+    case TraceEvent::StaleDropped:    return "STALE";
+    case TraceEvent::ShortFrame:      return "SHORT";
+    case TraceEvent::NoResponse:      return "NORESP";
+    case TraceEvent::Measure:         return "MEASURE";
+    case TraceEvent::Decision:        return "DECIDE";
+    case TraceEvent::Settled:         return "SETTLED";
+    case TraceEvent::EarlyDecision:   return "EARLY";
+    case TraceEvent::Step:            return "STEP";
+    case TraceEvent::PipelineTimeout: return "PIPE_TIMEOUT";
+    }
+    return "?";
+}
+
+const char* levelName(std::uint8_t l)
+{
+    static const char* const kNames[] = {"D", "I", "W"};
+    return l < 3 ? kNames[l] : "?";
+}
+
+// 명령/응답 앞 byte 들을 hex 로 (길이 최대 4)
+std::string hexBytes(std::int32_t packed, std::int32_t len)
+{
+    std::string s;
+    char buf[4];
+    const std::uint32_t v = static_cast<std::uint32_t>(packed);
+    for (int i = 0; i < len && i < 4; ++i) {
+        std::snprintf(buf, sizeof(buf), i ? " %02x" : "%02x", (v >> (8 * i)) & 0xff);
+        s += buf;
+    }
+    if (len > 4)
+        s += " ..";
+    return s;
+}
+
+void printDetail(const TraceRecord& r)
+{
+    switch (static_cast<TraceEvent>(r.event)) {
+    case TraceEvent::CommandSent:
+    case TraceEvent::BytesReceived:
+    case TraceEvent::StaleDropped:
+        std::printf("len=%d [%s]", r.a, hexBytes(r.b, r.a).c_str());
+        break;
+    case TraceEvent::ShortFrame:
+        std::printf("got=%d expected=%d", r.a, r.b);
+        break;
+    case TraceEvent::NoResponse:
+        std::printf("ch=%d", r.a);
+        break;
+    case TraceEvent::Measure:
+        std::printf("ch=%d raw=%d p=%.3f", r.a, r.b, r.f[0]);
+        break;
+    case TraceEvent::Decision:
+        std::printf("counter=%d ch=%d phase=%d p=%.3f stop=%.3f diff=%.3f%s%s%s",
+                    r.a, (r.b >> 16) & 0xff, (r.b >> 8) & 0xff, r.f[0], r.f[1], r.f[2],
+                    (r.b & kTracePass) ? " PASS" : " FAIL",
+                    (r.b & kTraceStop) ? " STOP" : "",
+                    (r.b & kTraceEarly) ? " EARLY" : "");
+        break;
+    case TraceEvent::Settled:
+        std::printf("ch=%d at=%.2fs saved=%.2fs", r.a, r.f[0], r.f[1]);
+        break;
+    case TraceEvent::EarlyDecision:
+        std::printf("ch=%d %s slope=%.5f saved=%.2fs", r.a, r.b ? "PASS" : "FAIL", r.f[0], r.f[1]);
+        break;
+    case TraceEvent::Step:
+        std::printf("elapsed=%d p=%.3f %s", r.a, r.f[0], r.b ? "PASS" : "FAIL");
+        break;
+    case TraceEvent::PipelineTimeout:
+        std::printf("in-flight=%d", r.a);
+        break;
+    default:
+        std::printf("a=%d b=%d f=%g,%g,%g", r.a, r.b, r.f[0], r.f[1], r.f[2]);
+        break;
+    }
+}
+
+int usage()
+{
+    std::fprintf(stderr, "usage: vacuum_trace_decode FILE [--level debug|info|warn] [--csv]\n");
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+        return usage();
+
+    const char* path = argv[1];
+    int  minLevel = 0;
+    bool csv = false;
+
+    for (int i = 2; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--csv")) {
+            csv = true;
+        } else if (!std::strcmp(argv[i], "--level") && i + 1 < argc) {
+            const char* l = argv[++i];
+            minLevel = !std::strcmp(l, "warn") ? 2 : !std::strcmp(l, "info") ? 1 : 0;
+        } else {
+            return usage();
+        }
+    }
+
+    std::FILE* f = std::fopen(path, "rb");
+    if (!f) {
+        std::perror(path);
+        return 1;
+    }
+
+    TraceFileHeader header{};
+    if (std::fread(&header, sizeof(header), 1, f) != 1 ||
+        std::memcmp(header.magic, "VACTRC1", 8) != 0 ||
+        header.recordSize != sizeof(TraceRecord)) {
+        std::fprintf(stderr, "%s: not a vacuum trace file\n", path);
+        std::fclose(f);
+        return 1;
+    }
+
+    std::vector<TraceRecord> records(static_cast<std::size_t>(header.count));
+    const std::size_t n = records.empty() ? 0 : std::fread(records.data(), sizeof(TraceRecord), records.size(), f);
+    std::fclose(f);
+    records.resize(n);
+
+    if (csv)
+        std::printf("timestamp_ns,thread,level,event,a,b,f0,f1,f2\n");
+    else
+        std::printf("# %zu records, %" PRIu64 " overwritten\n", n, header.dropped);
+
+    const std::int64_t t0 = records.empty() ? 0 : records.front().timestampNs;
+    for (const TraceRecord& r : records) {
+        if (r.level < minLevel)
+            continue;
+        if (csv) {
+            std::printf("%" PRId64 ",%u,%u,%s,%d,%d,%g,%g,%g\n", r.timestampNs, r.thread, r.level,
+                        eventName(r.event), r.a, r.b, r.f[0], r.f[1], r.f[2]);
+            continue;
+        }
+        std::printf("%12.3f T%-2u %s %-12s ", (r.timestampNs - t0) / 1e6, r.thread,
+                    levelName(r.level), eventName(r.event));
+        printDetail(r);
+        std::printf("\n");
+    }
+    return 0;
+}
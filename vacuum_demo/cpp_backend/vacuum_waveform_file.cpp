@@ -0,0 +1,478 @@
+// vacuum_waveform_file.cpp
+
+#include "vacuum_waveform_file.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char kFileMagic[8]    = {'V', 'A', 'C', 'W', 'A', 'V', '1', '\0'};
+const char kTrailerMagic[8] = {'V', 'W', 'F', 'E', 'N', 'D', '1', '\0'};
+
+inline std::uint64_t zigzag(std::int64_t v)
+{
+    return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+}
+
+inline std::int64_t unzigzag(std::uint64_t v)
+{
+    return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+}
+
+inline void putVarint(std::vector<std::uint8_t>& out, std::uint64_t v)
+{
+    while (v >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(v));
+}
+
+// 범위를 넘으면 p == end 로 멈춤 (손상된 파일에서 읽기 범위를 벗어나지 않게)
+inline std::uint64_t getVarint(const std::uint8_t*& p, const std::uint8_t* end)
+{
+    std::uint64_t v = 0;
+    int shift = 0;
+    while (p < end) {
+        const std::uint8_t b = *p++;
+        v |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+        if (!(b & 0x80))
+            break;
+        shift += 7;
+        if (shift > 63)
+            break;
+    }
+    return v;
+}
+
+template <typename T>
+void appendBytes(std::vector<std::uint8_t>& out, const T& value)
+{
+    const std::uint8_t* p = reinterpret_cast<const std::uint8_t*>(&value);
+    out.insert(out.end(), p, p + sizeof(T));
+}
+
+} // namespace
+
+// ───────────────────────────────────────
+//  WaveformWriter
+// ───────────────────────────────────────
+WaveformWriter::~WaveformWriter()
+{
+    finish();
+}
+
+bool WaveformWriter::active() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return file_ != nullptr;
+}
+
+bool WaveformWriter::begin(const std::string& path, const CalibrationSet* calibration, std::string* error)
+{
+    finish();
+
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        if (error) *error = "cannot create " + path;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_ = f;
+    path_ = path;
+
+    for (int ch = 0; ch < CalibrationSet::kChannels; ++ch)
+        for (int raw = 0; raw < CalibrationLut::kSize; ++raw)
+            lut_[ch][raw] = calibration ? calibration->convert(ch, raw) : kDefaultCalibration[raw];
+
+    ts_.clear();
+    raw_.clear();
+    meta_.clear();
+    blockCount_ = 0;
+    metaValue_  = -1;
+    metaRun_    = 0;
+    pending_.clear();
+    index_.clear();
+    total_   = 0;
+    ioError_ = false;
+
+    WaveformFileHeader header{};
+    std::memcpy(header.magic, kFileMagic, sizeof(kFileMagic));
+    header.version      = 1;
+    header.blockSamples = kBlockSamples;
+    header.startUs      = VacuumAcquisition::nowNs() / 1000;
+    header.wallClockMs  = std::chrono::duration_cast<std::chrono::milliseconds>(
+                              std::chrono::system_clock::now().time_since_epoch()).count();
+    appendBytes(pending_, header);
+    offset_ = 0;
+
+    // header 를 바로 써 두어야 finish 전에 죽어도 reader 가 블록 헤더를 따라갈 수 있다
+    if (!flush()) {
+        std::fclose(file_);
+        file_ = nullptr;
+        if (error) *error = "cannot write " + path;
+        return false;
+    }
+    return true;
+}
+
+void WaveformWriter::append(const VacuumSample& s)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_)
+        return;
+
+    const std::int64_t us = s.timestampNs / 1000;
+
+    if (blockCount_ == 0) {
+        blockFirstUs_ = us;
+        prevDeltaUs_  = 0;
+        prevRaw_      = 0;
+    } else {
+        const std::int64_t delta = us - prevUs_;
+        putVarint(ts_, zigzag(delta - prevDeltaUs_));
+        prevDeltaUs_ = delta;
+    }
+    prevUs_ = us;
+    lastUs_ = us;
+
+    const int raw = s.raw & 0xff;
+    putVarint(raw_, zigzag(raw - prevRaw_));
+    prevRaw_ = raw;
+
+    const int meta = (s.channel & 0x7f) << 1 | (s.ok ? 1 : 0);
+    if (meta != metaValue_) {
+        if (metaRun_ > 0) {
+            putVarint(meta_, static_cast<std::uint64_t>(metaValue_));
+            putVarint(meta_, metaRun_);
+        }
+        metaValue_ = meta;
+        metaRun_   = 0;
+    }
+    ++metaRun_;
+
+    if (++blockCount_ >= kBlockSamples)
+        sealBlock();
+}
+
+// mutex_ 보유 상태에서 호출
+void WaveformWriter::sealBlock()
+{
+    if (blockCount_ == 0)
+        return;
+
+    if (metaRun_ > 0) {
+        putVarint(meta_, static_cast<std::uint64_t>(metaValue_));
+        putVarint(meta_, metaRun_);
+    }
+
+    WaveformBlockHeader bh{};
+    bh.magic     = kBlockMagic;
+    bh.count     = blockCount_;
+    bh.tsBytes   = static_cast<std::uint32_t>(ts_.size());
+    bh.rawBytes  = static_cast<std::uint32_t>(raw_.size());
+    bh.metaBytes = static_cast<std::uint32_t>(meta_.size());
+    bh.firstTsUs = blockFirstUs_;
+
+    WaveformIndexEntry entry{};
+    entry.offset    = offset_ + pending_.size();
+    entry.firstTsUs = blockFirstUs_;
+    entry.lastTsUs  = lastUs_;
+    entry.count     = blockCount_;
+    index_.push_back(entry);
+    total_ += blockCount_;
+
+    appendBytes(pending_, bh);
+    pending_.insert(pending_.end(), ts_.begin(), ts_.end());
+    pending_.insert(pending_.end(), raw_.begin(), raw_.end());
+    pending_.insert(pending_.end(), meta_.begin(), meta_.end());
+
+    ts_.clear();
+    raw_.clear();
+    meta_.clear();
+    blockCount_ = 0;
+    metaValue_  = -1;
+    metaRun_    = 0;
+
+    // 블록 단위로 디스크까지 내려 보낸다 (50 Hz 기준 ~10 s 에 한 번)
+    flush();
+}
+
+bool WaveformWriter::flush()
+{
+    if (pending_.empty())
+        return true;
+    if (std::fwrite(pending_.data(), 1, pending_.size(), file_) != pending_.size() ||
+        std::fflush(file_) != 0)
+        ioError_ = true;
+    offset_ += pending_.size();
+    pending_.clear();
+    return !ioError_;
+}
+
+std::int64_t WaveformWriter::finish()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_)
+        return 0;
+
+    sealBlock();
+
+    const std::uint64_t indexOffset = offset_ + pending_.size();
+    for (const WaveformIndexEntry& e : index_)
+        appendBytes(pending_, e);
+    for (const auto& table : lut_)
+        appendBytes(pending_, table);
+
+    WaveformFileTrailer trailer{};
+    trailer.indexOffset  = indexOffset;
+    trailer.totalSamples = total_;
+    trailer.blockCount   = static_cast<std::uint32_t>(index_.size());
+    trailer.lutChannels  = CalibrationSet::kChannels;
+    std::memcpy(trailer.magic, kTrailerMagic, sizeof(kTrailerMagic));
+    appendBytes(pending_, trailer);
+
+    flush();
+    if (std::fclose(file_) != 0)
+        ioError_ = true;
+    file_ = nullptr;
+
+    return ioError_ ? -1 : static_cast<std::int64_t>(total_);
+}
+
+// ───────────────────────────────────────
+//  WaveformReader
+// ───────────────────────────────────────
+WaveformReader::~WaveformReader()
+{
+    close();
+}
+
+void WaveformReader::close()
+{
+#if defined(_WIN32)
+    if (data_)
+        UnmapViewOfFile(data_);
+    if (mapHandle_)
+        CloseHandle(mapHandle_);
+    if (fileHandle_)
+        CloseHandle(fileHandle_);
+    mapHandle_  = nullptr;
+    fileHandle_ = nullptr;
+#else
+    if (data_)
+        munmap(const_cast<std::uint8_t*>(data_), size_);
+#endif
+    data_     = nullptr;
+    size_     = 0;
+    header_   = nullptr;
+    lut_      = nullptr;
+    complete_ = false;
+    blocks_.clear();
+    total_ = 0;
+}
+
+bool WaveformReader::open(const std::string& path, std::string* error)
+{
+    close();
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        if (error) *error = "cannot open " + path;
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(WaveformFileHeader))) {
+        CloseHandle(file);
+        if (error) *error = "not a waveform file: " + path;
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        if (error) *error = "mmap failed: " + path;
+        return false;
+    }
+    fileHandle_ = file;
+    mapHandle_  = mapping;
+    size_       = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        if (error) *error = "cannot open " + path;
+        return false;
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(WaveformFileHeader))) {
+        ::close(fd);
+        if (error) *error = "not a waveform file: " + path;
+        return false;
+    }
+    void* view = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);   // mapping 은 fd 를 닫아도 유지
+    if (view == MAP_FAILED) {
+        if (error) *error = "mmap failed: " + path;
+        return false;
+    }
+    size_ = static_cast<std::size_t>(st.st_size);
+#endif
+
+    data_   = static_cast<const std::uint8_t*>(view);
+    header_ = reinterpret_cast<const WaveformFileHeader*>(data_);
+
+    if (std::memcmp(header_->magic, kFileMagic, sizeof(kFileMagic)) != 0 || header_->version != 1) {
+        close();
+        if (error) *error = "not a waveform file: " + path;
+        return false;
+    }
+
+    // trailer + index 가 있으면 그대로 사용
+    const std::size_t lutBytes = sizeof(float) * CalibrationSet::kChannels * CalibrationLut::kSize;
+    if (size_ >= sizeof(WaveformFileHeader) + sizeof(WaveformFileTrailer) + lutBytes) {
+        const auto* trailer = reinterpret_cast<const WaveformFileTrailer*>(data_ + size_ - sizeof(WaveformFileTrailer));
+        const std::uint64_t indexBytes = static_cast<std::uint64_t>(trailer->blockCount) * sizeof(WaveformIndexEntry);
+        const std::uint64_t indexOffset = trailer->indexOffset;
+        if (std::memcmp(trailer->magic, kTrailerMagic, sizeof(kTrailerMagic)) == 0 &&
+            trailer->lutChannels == CalibrationSet::kChannels &&
+            indexOffset >= sizeof(WaveformFileHeader) && indexOffset <= size_ &&
+            indexOffset + indexBytes + lutBytes + sizeof(WaveformFileTrailer) == size_) {
+            const auto* index = reinterpret_cast<const WaveformIndexEntry*>(data_ + indexOffset);
+            blocks_.reserve(trailer->blockCount);
+            for (std::uint32_t i = 0; i < trailer->blockCount; ++i) {
+                // index 도 복구 경로와 같은 기준으로 검증 (헤더 + 본문이 index 앞에 있어야 함)
+                const std::uint64_t offset = index[i].offset;
+                if (offset < sizeof(WaveformFileHeader) || offset + sizeof(WaveformBlockHeader) > indexOffset)
+                    break;
+                const auto* bh = reinterpret_cast<const WaveformBlockHeader*>(data_ + offset);
+                const std::uint64_t bytes = static_cast<std::uint64_t>(bh->tsBytes) + bh->rawBytes + bh->metaBytes;
+                if (bh->magic != WaveformWriter::kBlockMagic || bh->count == 0 || bh->count != index[i].count ||
+                    offset + sizeof(WaveformBlockHeader) + bytes > indexOffset)
+                    break;
+                blocks_.push_back({bh, total_, index[i].firstTsUs});
+                total_ += bh->count;
+            }
+            lut_      = reinterpret_cast<const float*>(data_ + indexOffset + indexBytes);
+            complete_ = blocks_.size() == trailer->blockCount;
+            if (complete_)
+                return true;
+            blocks_.clear();
+            total_ = 0;
+            lut_   = nullptr;
+        }
+    }
+
+    // 기록 도중 중단된 파일: 블록 헤더를 따라가며 index 재구성 (보정은 기본 테이블)
+    std::size_t pos = sizeof(WaveformFileHeader);
+    while (pos + sizeof(WaveformBlockHeader) <= size_) {
+        const auto* bh = reinterpret_cast<const WaveformBlockHeader*>(data_ + pos);
+        const std::size_t bytes = static_cast<std::size_t>(bh->tsBytes) + bh->rawBytes + bh->metaBytes;
+        if (bh->magic != WaveformWriter::kBlockMagic || bh->count == 0 ||
+            pos + sizeof(WaveformBlockHeader) + bytes > size_)
+            break;
+        blocks_.push_back({bh, total_, bh->firstTsUs});
+        total_ += bh->count;
+        pos += sizeof(WaveformBlockHeader) + bytes;
+    }
+    return true;
+}
+
+std::size_t WaveformReader::decodeBlock(std::size_t block, std::uint32_t skip, WaveformPoint* out,
+                                        std::size_t maxCount) const
+{
+    const WaveformBlockHeader* bh = blocks_[block].header;
+    const std::uint8_t* ts      = reinterpret_cast<const std::uint8_t*>(bh + 1);
+    const std::uint8_t* tsEnd   = ts + bh->tsBytes;
+    const std::uint8_t* raw     = tsEnd;
+    const std::uint8_t* rawEnd  = raw + bh->rawBytes;
+    const std::uint8_t* meta    = rawEnd;
+    const std::uint8_t* metaEnd = meta + bh->metaBytes;
+
+    std::int64_t  us = bh->firstTsUs;
+    std::int64_t  delta = 0;
+    int           prevRaw = 0;
+    std::uint64_t metaValue = 0;
+    std::uint64_t metaLeft = 0;
+
+    std::size_t n = 0;
+    for (std::uint32_t i = 0; i < bh->count && n < maxCount; ++i) {
+        if (i > 0) {
+            delta += unzigzag(getVarint(ts, tsEnd));
+            us += delta;
+        }
+        prevRaw = static_cast<int>((prevRaw + unzigzag(getVarint(raw, rawEnd))) & 0xff);
+        if (metaLeft == 0) {
+            metaValue = getVarint(meta, metaEnd);
+            metaLeft  = getVarint(meta, metaEnd);
+        }
+        --metaLeft;
+
+        if (i < skip)
+            continue;
+
+        WaveformPoint& p = out[n++];
+        p.timestampUs = us;
+        p.raw         = static_cast<std::uint8_t>(prevRaw);
+        p.channel     = static_cast<std::uint8_t>(metaValue >> 1);
+        p.ok          = static_cast<std::uint8_t>(metaValue & 1);
+        // 범위 밖 채널은 CalibrationSet::lut 와 같이 기본 테이블
+        p.pressure    = (lut_ && p.channel < CalibrationSet::kChannels)
+                            ? lut_[p.channel * CalibrationLut::kSize + p.raw]
+                            : kDefaultCalibration[p.raw];
+    }
+    return n;
+}
+
+std::size_t WaveformReader::read(std::uint64_t first, WaveformPoint* out, std::size_t maxCount) const
+{
+    if (!out || first >= total_)
+        return 0;
+
+    // first 를 포함하는 블록
+    auto it = std::upper_bound(blocks_.begin(), blocks_.end(), first,
+                               [](std::uint64_t v, const Block& b) { return v < b.firstSample; });
+    std::size_t block = static_cast<std::size_t>(it - blocks_.begin()) - 1;
+
+    std::size_t n = 0;
+    std::uint32_t skip = static_cast<std::uint32_t>(first - blocks_[block].firstSample);
+    for (; block < blocks_.size() && n < maxCount; ++block, skip = 0)
+        n += decodeBlock(block, skip, out + n, maxCount - n);
+    return n;
+}
+
+std::uint64_t WaveformReader::lowerBound(std::int64_t fromUs) const
+{
+    if (blocks_.empty())
+        return 0;
+
+    // fromUs 이전에 시작하는 마지막 블록부터 찾는다
+    auto it = std::upper_bound(blocks_.begin(), blocks_.end(), fromUs,
+                               [](std::int64_t v, const Block& b) { return v < b.firstTsUs; });
+    if (it == blocks_.begin())
+        return 0;
+    const std::size_t block = static_cast<std::size_t>(it - blocks_.begin()) - 1;
+
+    WaveformPoint points[WaveformWriter::kBlockSamples];
+    const std::size_t n = decodeBlock(block, 0, points, WaveformWriter::kBlockSamples);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (points[i].timestampUs >= fromUs)
+            return blocks_[block].firstSample + i;
+    }
+    return blocks_[block].firstSample + n;
+}
@@ -0,0 +1,174 @@
+// vacuum_waveform_file.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "vacuum_acquisition.h"
+#include "vacuum_calibration.h"
+
+// 세션 파형 파일 (.vwf). append-only, 블록 단위 columnar 인코딩.
+//
+//   WaveformFileHeader
+//   [WaveformBlockHeader | ts column | raw column | meta column] ...   <- 블록이 찰 때마다 기록
+//   WaveformIndexEntry[blockCount]                                    <- close 시
+//   float lut[4][256]          (세션 시작 시점의 채널별 보정 테이블, index = channel)
+//   WaveformFileTrailer
+//
+// 컬럼 (블록 안에서 독립):
+//   ts   : 첫 샘플은 블록 헤더(firstTsUs), 이후 us 단위 delta-of-delta (zigzag varint)
+//   raw  : 이전 ADC byte 와의 차이 (zigzag varint, 첫 값은 0 기준)
+//   meta : (channel << 1 | ok) 의 run-length (varint 값, varint 길이) 쌍
+// 압력은 저장하지 않고 raw + lut 로 복원한다 (50 Hz 에서 샘플당 ~3 byte).
+//
+// trailer 가 없는 파일(프로세스 비정상 종료)은 블록 헤더를 순서대로 따라가며 읽는다.
+
+struct WaveformFileHeader {
+    char          magic[8];       // "VACWAV1\0"
+    std::uint32_t version;        // 1
+    std::uint32_t blockSamples;   // 블록당 최대 샘플 수
+    std::int64_t  startUs;        // 기록 시작 시각 (steady clock, us)
+    std::int64_t  wallClockMs;    // 파일 생성 시각 (unix ms)
+};
+static_assert(sizeof(WaveformFileHeader) == 32, "WaveformFileHeader is a file format");
+
+struct WaveformBlockHeader {
+    std::uint32_t magic;          // kBlockMagic
+    std::uint32_t count;
+    std::uint32_t tsBytes;
+    std::uint32_t rawBytes;
+    std::uint32_t metaBytes;
+    std::uint32_t reserved;
+    std::int64_t  firstTsUs;
+};
+static_assert(sizeof(WaveformBlockHeader) == 32, "WaveformBlockHeader is a file format");
+
+struct WaveformIndexEntry {
+    std::uint64_t offset;         // 블록 헤더 위치
+    std::int64_t  firstTsUs;
+    std::int64_t  lastTsUs;
+    std::uint32_t count;
+    std::uint32_t reserved;
+};
+static_assert(sizeof(WaveformIndexEntry) == 32, "WaveformIndexEntry is a file format");
+
+struct WaveformFileTrailer {
+    std::uint64_t indexOffset;
+    std::uint64_t totalSamples;
+    std::uint32_t blockCount;
+    std::uint32_t lutChannels;    // CalibrationSet::kChannels
+    char          magic[8];       // "VWFEND1\0"
+};
+static_assert(sizeof(WaveformFileTrailer) == 32, "WaveformFileTrailer is a file format");
+
+// 디코딩된 샘플
+struct WaveformPoint {
+    std::int64_t timestampUs;
+    float        pressure;
+    std::uint8_t raw;
+    std::uint8_t channel;
+    std::uint8_t ok;
+};
+
+// acquisition 스레드에서 append (메모리 인코딩만), 블록이 차면 바로 파일에 기록(fflush).
+// 비정상 종료 시에도 마지막으로 닫힌 블록까지는 디스크에 남는다.
+// begin/finish 는 다른 스레드에서 호출해도 된다.
+class WaveformWriter
+{
+public:
+    static constexpr std::uint32_t kBlockMagic   = 0x4B425756;   // "VWBK"
+    static constexpr std::uint32_t kBlockSamples = 512;
+
+    WaveformWriter() = default;
+    ~WaveformWriter();
+
+    WaveformWriter(const WaveformWriter&) = delete;
+    WaveformWriter& operator=(const WaveformWriter&) = delete;
+
+    // calibration 은 시작 시점 테이블을 복사 (nullptr = 기본 테이블)
+    bool begin(const std::string& path, const CalibrationSet* calibration, std::string* error = nullptr);
+    void append(const VacuumSample& s);
+    // 남은 블록 + index footer 기록 후 닫음. 기록한 샘플 수 (실패 시 -1)
+    std::int64_t finish();
+
+    bool active() const;
+
+private:
+    void sealBlock();
+    bool flush();
+
+    mutable std::mutex mutex_;
+    std::FILE*         file_ = nullptr;
+    std::string        path_;
+
+    float lut_[CalibrationSet::kChannels][CalibrationLut::kSize] = {};
+
+    // 현재 블록
+    std::vector<std::uint8_t> ts_, raw_, meta_;
+    std::uint32_t blockCount_  = 0;
+    std::int64_t  blockFirstUs_ = 0;
+    std::int64_t  prevUs_       = 0;
+    std::int64_t  prevDeltaUs_  = 0;
+    std::int64_t  lastUs_       = 0;
+    int           prevRaw_      = 0;
+    int           metaValue_    = -1;
+    std::uint32_t metaRun_      = 0;
+
+    std::vector<std::uint8_t>       pending_;   // 한 번의 fwrite 로 내보낼 바이트 (header / 블록 / footer)
+    std::uint64_t                   offset_ = 0;   // pending_ 시작 위치의 파일 offset
+    std::vector<WaveformIndexEntry> index_;
+    std::uint64_t                   total_ = 0;
+    bool                            ioError_ = false;
+};
+
+// 파일 전체를 mmap 하고 index 로 블록을 찾아 디코딩한다 (복사/파싱 단계 없음).
+class WaveformReader
+{
+public:
+    WaveformReader() = default;
+    ~WaveformReader();
+
+    WaveformReader(const WaveformReader&) = delete;
+    WaveformReader& operator=(const WaveformReader&) = delete;
+
+    bool open(const std::string& path, std::string* error = nullptr);
+    void close();
+
+    std::uint64_t sampleCount() const { return total_; }
+    std::size_t   blockCount() const { return blocks_.size(); }
+    std::int64_t  startUs() const { return header_ ? header_->startUs : 0; }
+    std::int64_t  wallClockMs() const { return header_ ? header_->wallClockMs : 0; }
+    bool          complete() const { return complete_; }   // trailer 까지 기록된 파일
+
+    // first 번째 샘플부터 최대 maxCount 개 디코딩. 디코딩한 개수 반환
+    std::size_t read(std::uint64_t first, WaveformPoint* out, std::size_t maxCount) const;
+
+    // timestampUs >= fromUs 인 첫 샘플 index (블록 시각으로 건너뛴 뒤 블록 하나만 디코딩)
+    std::uint64_t lowerBound(std::int64_t fromUs) const;
+
+private:
+    std::size_t decodeBlock(std::size_t block, std::uint32_t skip, WaveformPoint* out, std::size_t maxCount) const;
+
+    const std::uint8_t*       data_ = nullptr;
+    std::size_t               size_ = 0;
+    const WaveformFileHeader* header_ = nullptr;
+    const float*              lut_ = nullptr;   // [kChannels][256], 없으면 기본 테이블
+    bool                      complete_ = false;
+
+    struct Block {
+        const WaveformBlockHeader* header;
+        std::uint64_t              firstSample;
+        std::int64_t               firstTsUs;
+    };
+    std::vector<Block> blocks_;
+    std::uint64_t      total_ = 0;
+
+#if defined(_WIN32)
+    void* fileHandle_ = nullptr;
+    void* mapHandle_  = nullptr;
+#endif
+};
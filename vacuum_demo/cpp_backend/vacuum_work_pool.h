@@ -0,0 +1,116 @@
+// vacuum_work_pool.h
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// 오프라인 일괄 계산용 work-stealing parallelFor.
+// [0, n) 을 grain 크기 chunk 로 나눠 worker 별 deque 에 round-robin 으로 배분하고,
+// 각 worker 는 자기 deque 앞에서 꺼내다가 비면 다른 worker deque 뒤에서 훔친다.
+// trace 길이(= chunk 비용)가 제각각이어도 코어가 놀지 않는다.
+// chunk 당 lock 1 회라 grain 은 수 us 이상 걸리는 크기로 잡을 것.
+class WorkStealingPool
+{
+public:
+    // threads <= 0 : hardware_concurrency
+    explicit WorkStealingPool(int threads = 0)
+        : threads_(threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency()))
+    {
+    }
+
+    int threads() const { return threads_; }
+
+    // fn(begin, end, worker) 를 모든 chunk 에 대해 호출하고 끝날 때까지 대기.
+    // worker = 0 .. threads()-1 (worker 별 누적 버퍼 index 로 사용). 예외는 첫 번째 것을 다시 던진다
+    void parallelFor(std::size_t n, std::size_t grain,
+                     const std::function<void(std::size_t, std::size_t, int)>& fn) const
+    {
+        if (n == 0)
+            return;
+        if (grain == 0)
+            grain = 1;
+
+        const std::size_t chunks = (n + grain - 1) / grain;
+        const int workers = static_cast<int>(std::min<std::size_t>(static_cast<std::size_t>(threads_), chunks));
+        if (workers <= 1) {
+            fn(0, n, 0);
+            return;
+        }
+
+        std::vector<Queue> queues(static_cast<std::size_t>(workers));
+        for (std::size_t c = 0; c < chunks; ++c) {
+            const std::size_t begin = c * grain;
+            queues[c % queues.size()].items.emplace_back(begin, std::min(n, begin + grain));
+        }
+
+        std::exception_ptr firstError;
+        std::mutex errorMutex;
+        std::atomic<bool> failed{false};
+
+        auto work = [&](int self) {
+            std::pair<std::size_t, std::size_t> range;
+            while (!failed.load(std::memory_order_relaxed) && take(queues, self, range)) {
+                try {
+                    fn(range.first, range.second, self);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!firstError)
+                        firstError = std::current_exception();
+                    failed.store(true, std::memory_order_relaxed);
+                }
+            }
+        };
+
+        std::vector<std::thread> pool;
+        pool.reserve(static_cast<std::size_t>(workers - 1));
+        for (int w = 1; w < workers; ++w)
+            pool.emplace_back(work, w);
+        work(0);   // 호출 스레드도 worker 0 으로 참여
+        for (std::thread& t : pool)
+            t.join();
+
+        if (firstError)
+            std::rethrow_exception(firstError);
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::pair<std::size_t, std::size_t>> items;
+    };
+
+    // 자기 queue 앞 -> 다른 queue 뒤 (self 다음 worker 부터 순서대로)
+    static bool take(std::vector<Queue>& queues, int self, std::pair<std::size_t, std::size_t>& out)
+    {
+        {
+            Queue& own = queues[static_cast<std::size_t>(self)];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.items.empty()) {
+                out = own.items.front();
+                own.items.pop_front();
+                return true;
+            }
+        }
+        const std::size_t count = queues.size();
+        for (std::size_t i = 1; i < count; ++i) {
+            Queue& victim = queues[(static_cast<std::size_t>(self) + i) % count];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.items.empty()) {
+                out = victim.items.back();
+                victim.items.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    int threads_;
+};